@@ -52,9 +52,9 @@ template <typename T>
 std::enable_if_t<std::is_integral_v<T>, T> RandomRange(T start, T end)
 {
 	// Will be used to obtain a seed for the random number engine
-	static std::random_device rd;
-	// Standard mersenne_twister_engine seeded with rd()
-	static std::mt19937 gen(rd());
+	thread_local std::random_device rd;
+	// Standard mersenne_twister_engine seeded with rd(), one per thread as the matches of a server run in parallel
+	thread_local std::mt19937 gen(rd());
 	std::uniform_int_distribution<T> dis(start, end);
 	return dis(gen);
 }
@@ -63,9 +63,9 @@ template <typename T>
 std::enable_if_t<std::is_floating_point_v<T>, T> RandomRange(T start, T end)
 {
 	// Will be used to obtain a seed for the random number engine
-	static std::random_device rd;
-	// Standard mersenne_twister_engine seeded with rd()
-	static std::mt19937 gen(rd());
+	thread_local std::random_device rd;
+	// Standard mersenne_twister_engine seeded with rd(), one per thread as the matches of a server run in parallel
+	thread_local std::mt19937 gen(rd());
 	std::uniform_real_distribution<T> dis(start, end);
 	return dis(gen);
 }
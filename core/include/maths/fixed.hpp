@@ -0,0 +1,273 @@
+#pragma once
+
+#include <compare>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace core
+{
+namespace detail
+{
+/**
+ * \brief Integer type big enough to hold the product of two fixed point numbers.
+ */
+template <typename Storage>
+struct FixedWide;
+
+template <>
+struct FixedWide<std::int32_t>
+{
+	using Type = std::int64_t;
+	using UnsignedType = std::uint64_t;
+};
+
+#if defined(__SIZEOF_INT128__)
+template <>
+struct FixedWide<std::int64_t>
+{
+	__extension__ using Type = __int128;
+	__extension__ using UnsignedType = unsigned __int128;
+};
+#endif
+}
+
+/**
+ * \brief Signed fixed point number, with FractionBits bits after the point.
+ * All the operations are done on integers, so they give the same result on every platform and compiler.
+ * The products and quotients are rounded to the nearest value, and wrap around on overflow.
+ * \tparam Storage Signed integer holding the raw value.
+ * \tparam FractionBits Number of bits used by the fractional part.
+ */
+template <typename Storage, int FractionBits>
+class Fixed
+{
+public:
+	static_assert(std::is_signed_v<Storage>, "The storage of a fixed point number must be signed");
+	static_assert(FractionBits > 0 && FractionBits < static_cast<int>(sizeof(Storage)) * 8 - 1,
+		"The fractional part must leave room for the sign and the integer part");
+
+	using StorageType = Storage;
+	using WideType = typename detail::FixedWide<Storage>::Type;
+	using UnsignedWideType = typename detail::FixedWide<Storage>::UnsignedType;
+
+	static constexpr int FRACTION_BITS = FractionBits;
+	static constexpr Storage RAW_ONE = Storage{1} << FractionBits;
+
+	constexpr Fixed() = default;
+
+	// ReSharper disable once CppNonExplicitConvertingConstructor
+	constexpr Fixed(const int value)
+		: _raw(static_cast<Storage>(static_cast<std::make_unsigned_t<Storage>>(value) << FractionBits))
+	{
+	}
+
+	// ReSharper disable once CppNonExplicitConvertingConstructor
+	constexpr Fixed(const float value)
+		: _raw(FromFloatingPoint(static_cast<double>(value)))
+	{
+	}
+
+	// ReSharper disable once CppNonExplicitConvertingConstructor
+	constexpr Fixed(const double value)
+		: _raw(FromFloatingPoint(value))
+	{
+	}
+
+	static constexpr Fixed FromRaw(const Storage raw)
+	{
+		Fixed result;
+		result._raw = raw;
+		return result;
+	}
+
+	[[nodiscard]] constexpr Storage Raw() const { return _raw; }
+
+	explicit constexpr operator float() const { return static_cast<float>(ToDouble()); }
+	explicit constexpr operator double() const { return ToDouble(); }
+
+	/**
+	 * \brief Integer part, rounded towards minus infinity.
+	 */
+	explicit constexpr operator int() const { return static_cast<int>(_raw >> FractionBits); }
+
+	constexpr Fixed operator-() const { return FromRaw(Negate(_raw)); }
+
+	// The operators are friends so that an int or a float on either side is converted.
+	friend constexpr Fixed operator+(const Fixed a, const Fixed b) { return FromRaw(WrapAdd(a._raw, b._raw)); }
+	friend constexpr Fixed operator-(const Fixed a, const Fixed b) { return FromRaw(WrapAdd(a._raw, Negate(b._raw))); }
+
+	friend constexpr Fixed operator*(const Fixed a, const Fixed b)
+	{
+		constexpr auto half = static_cast<WideType>(1) << (FractionBits - 1);
+		const WideType product = static_cast<WideType>(a._raw) * static_cast<WideType>(b._raw);
+		return FromRaw(static_cast<Storage>((product + half) >> FractionBits));
+	}
+
+	/**
+	 * \brief Divides a by b, a division by zero saturates to the biggest number with the sign of a.
+	 */
+	friend constexpr Fixed operator/(const Fixed a, const Fixed b)
+	{
+		if (b._raw == 0)
+		{
+			return a._raw >= 0 ? Max() : Lowest();
+		}
+
+		const WideType numerator = static_cast<WideType>(a._raw) << FractionBits;
+		const WideType denominator = b._raw;
+		WideType quotient = numerator / denominator;
+		const WideType remainder = numerator % denominator;
+
+		// Rounds the truncated quotient to the nearest.
+		const WideType absRemainder = remainder < 0 ? -remainder : remainder;
+		const WideType absDenominator = denominator < 0 ? -denominator : denominator;
+		if (absRemainder * 2 >= absDenominator)
+		{
+			quotient += (numerator < 0) != (denominator < 0) ? -1 : 1;
+		}
+		return FromRaw(static_cast<Storage>(quotient));
+	}
+
+	constexpr Fixed& operator+=(const Fixed other) { return *this = *this + other; }
+	constexpr Fixed& operator-=(const Fixed other) { return *this = *this - other; }
+	constexpr Fixed& operator*=(const Fixed other) { return *this = *this * other; }
+	constexpr Fixed& operator/=(const Fixed other) { return *this = *this / other; }
+
+	friend constexpr auto operator<=>(const Fixed a, const Fixed b) { return a._raw <=> b._raw; }
+	friend constexpr bool operator==(const Fixed a, const Fixed b) { return a._raw == b._raw; }
+
+	static constexpr Fixed Max() { return FromRaw(std::numeric_limits<Storage>::max()); }
+	static constexpr Fixed Lowest() { return FromRaw(std::numeric_limits<Storage>::min()); }
+	static constexpr Fixed Epsilon() { return FromRaw(1); }
+
+private:
+	/**
+	 * \brief Converts a floating point number to the nearest fixed point one, saturating out of the range.
+	 */
+	static constexpr Storage FromFloatingPoint(const double value)
+	{
+		const double scaled = value * static_cast<double>(RAW_ONE);
+		// NaN fails both comparisons and becomes 0.
+		if (!(scaled < static_cast<double>(std::numeric_limits<Storage>::max())))
+		{
+			return scaled > 0.0 ? std::numeric_limits<Storage>::max() : 0;
+		}
+		if (!(scaled > static_cast<double>(std::numeric_limits<Storage>::min())))
+		{
+			return std::numeric_limits<Storage>::min();
+		}
+
+		return static_cast<Storage>(scaled >= 0.0 ? scaled + 0.5 : scaled - 0.5);
+	}
+
+	[[nodiscard]] constexpr double ToDouble() const
+	{
+		return static_cast<double>(_raw) / static_cast<double>(RAW_ONE);
+	}
+
+	static constexpr Storage WrapAdd(const Storage a, const Storage b)
+	{
+		using Unsigned = std::make_unsigned_t<Storage>;
+		return static_cast<Storage>(static_cast<Unsigned>(a) + static_cast<Unsigned>(b));
+	}
+
+	static constexpr Storage Negate(const Storage a)
+	{
+		using Unsigned = std::make_unsigned_t<Storage>;
+		return static_cast<Storage>(Unsigned{0} - static_cast<Unsigned>(a));
+	}
+
+	Storage _raw = 0;
+};
+
+template <typename Storage, int FractionBits>
+constexpr Fixed<Storage, FractionBits> Abs(const Fixed<Storage, FractionBits> value)
+{
+	return value < Fixed<Storage, FractionBits>{} ? -value : value;
+}
+
+/**
+ * \brief Square root rounded down, 0 for negative numbers.
+ */
+template <typename Storage, int FractionBits>
+constexpr Fixed<Storage, FractionBits> Sqrt(const Fixed<Storage, FractionBits> value)
+{
+	using FixedType = Fixed<Storage, FractionBits>;
+	using UnsignedWide = typename FixedType::UnsignedWideType;
+
+	if (value.Raw() <= 0)
+	{
+		return {};
+	}
+
+	// sqrt(raw / 2^F) * 2^F = sqrt(raw * 2^F), computed bit by bit on the wide integer.
+	UnsignedWide remainder = static_cast<UnsignedWide>(value.Raw()) << FractionBits;
+	UnsignedWide result = 0;
+	UnsignedWide bit = static_cast<UnsignedWide>(1) << (sizeof(UnsignedWide) * 8 - 2);
+	while (bit > remainder)
+	{
+		bit >>= 2;
+	}
+	while (bit != 0)
+	{
+		if (remainder >= result + bit)
+		{
+			remainder -= result + bit;
+			result = (result >> 1) + bit;
+		}
+		else
+		{
+			result >>= 1;
+		}
+		bit >>= 2;
+	}
+
+	return FixedType::FromRaw(static_cast<Storage>(result));
+}
+
+/**
+ * \brief Fixed point number with 16 bits on each side of the point, in [-32768, 32768[.
+ */
+using Fixed16 = Fixed<std::int32_t, 16>;
+
+#if defined(__SIZEOF_INT128__)
+/**
+ * \brief Fixed point number with 32 bits on each side of the point.
+ * Needs a compiler with 128 bits integers for the intermediate products.
+ */
+using Fixed32 = Fixed<std::int64_t, 32>;
+#endif
+
+template <typename T>
+struct IsFixed : std::false_type
+{
+};
+
+template <typename Storage, int FractionBits>
+struct IsFixed<Fixed<Storage, FractionBits>> : std::true_type
+{
+};
+
+template <typename T>
+inline constexpr bool IS_FIXED = IsFixed<T>::value;
+}
+
+template <typename Storage, int FractionBits>
+class std::numeric_limits<core::Fixed<Storage, FractionBits>>
+{
+	using FixedType = core::Fixed<Storage, FractionBits>;
+
+public:
+	static constexpr bool is_specialized = true;
+	static constexpr bool is_signed = true;
+	static constexpr bool is_integer = false;
+	static constexpr bool is_exact = true;
+	static constexpr bool has_infinity = false;
+	static constexpr bool has_quiet_NaN = false;
+
+	static constexpr FixedType min() noexcept { return FixedType::Epsilon(); }
+	static constexpr FixedType max() noexcept { return FixedType::Max(); }
+	static constexpr FixedType lowest() noexcept { return FixedType::Lowest(); }
+	static constexpr FixedType epsilon() noexcept { return FixedType::Epsilon(); }
+};
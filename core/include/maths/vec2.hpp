@@ -1,6 +1,10 @@
 #pragma once
 
+#include <cmath>
+#include <type_traits>
+
 #include <maths/angle.hpp>
+#include <maths/fixed.hpp>
 
 #include <SFML/System/Vector2.hpp>
 
@@ -8,106 +12,301 @@ namespace core
 {
 // ReSharper disable once CppInconsistentNaming
 /**
- * \brief Vec2f is a utility class that represents a mathematical 2d vector.
+ * \brief Vec2 is a utility class that represents a mathematical 2d vector.
+ * \tparam T Type of the components, a floating point or a fixed point number (see Fixed).
+ * The functions using angles are only available with floating point components.
  */
-struct Vec2f
+template <typename T>
+struct Vec2
 {
-	float x = 0.0f;
-	float y = 0.0f;
+	T x = T{0};
+	T y = T{0};
 
-	constexpr Vec2f() = default;
+	constexpr Vec2() = default;
 
-	constexpr Vec2f(const float newX, const float newY)
+	constexpr Vec2(const T newX, const T newY)
 		: x(newX), y(newY)
 	{
 	}
 
+	/**
+	 * \brief Converts a vector with other components, like from floating point to fixed point.
+	 */
+	template <typename U>
+		requires (!std::is_same_v<T, U>)
+	// ReSharper disable once CppNonExplicitConvertingConstructor
+	constexpr Vec2(const Vec2<U> v)
+		: x(static_cast<T>(v.x)), y(static_cast<T>(v.y))
+	{
+	}
+
 	// ReSharper disable once CppNonExplicitConvertingConstructor
-	Vec2f(sf::Vector2f v);
+	constexpr Vec2(const sf::Vector2f v)
+		: x(static_cast<T>(v.x)), y(static_cast<T>(v.y))
+	{
+	}
+
+	static Vec2 FromAngle(const Radian angle)
+	{
+		return {Sin(angle), Cos(angle)};
+	}
+
+	static constexpr T Dot(const Vec2 a, const Vec2 b)
+	{
+		return a.x * b.x + a.y * b.y;
+	}
+
+	static constexpr Vec2 Lerp(const Vec2 a, const Vec2 b, const T t)
+	{
+		return a + (b - a) * t;
+	}
+
+	static Vec2 Normalize(const Vec2 v)
+	{
+		return v.GetNormalized();
+	}
+
+	[[nodiscard]] T GetMagnitude() const
+	{
+		if constexpr (std::is_floating_point_v<T>)
+		{
+			return std::sqrt(GetSqrMagnitude());
+		}
+		else
+		{
+			// The squares of fixed point numbers vanish for small vectors and overflow for big ones,
+			// so the components are scaled by the biggest one first.
+			const T absX = x < T{0} ? -x : x;
+			const T absY = y < T{0} ? -y : y;
+			const T biggest = absX > absY ? absX : absY;
+			if (biggest == T{0})
+			{
+				return T{0};
+			}
+
+			const T scaledX = absX / biggest;
+			const T scaledY = absY / biggest;
+			return Sqrt(scaledX * scaledX + scaledY * scaledY) * biggest;
+		}
+	}
+
+	void Normalize()
+	{
+		const auto magnitude = GetMagnitude();
+		x /= magnitude;
+		y /= magnitude;
+	}
+
+	[[nodiscard]] Vec2 GetNormalized() const
+	{
+		const auto magnitude = GetMagnitude();
+		return (*this) / magnitude;
+	}
+
+	[[nodiscard]] constexpr T GetSqrMagnitude() const
+	{
+		return x * x + y * y;
+	}
 
-	static Vec2f FromAngle(Radian angle);
-	static float Dot(Vec2f a, Vec2f b);
-	static Vec2f Lerp(Vec2f a, Vec2f b, float t);
-	static Vec2f Normalize(Vec2f v);
+	[[nodiscard]] Vec2 Rotate(const Degree rotation) const
+	{
+		const auto cs = Cos(rotation);
+		const auto sn = Sin(rotation);
 
-	[[nodiscard]] float GetMagnitude() const;
-	void Normalize();
-	[[nodiscard]] Vec2f GetNormalized() const;
-	[[nodiscard]] float GetSqrMagnitude() const;
-	[[nodiscard]] Vec2f Rotate(Degree rotation) const;
+		Vec2 v;
+		v.x = x * cs - y * sn;
+		v.y = x * sn + y * cs;
+		return v;
+	}
 
 	/**
 	 * \brief Computes the distance between this and other.
 	 * \param other The other vector.
 	 * \return The distance between this and other.
 	 */
-	[[nodiscard]] float Distance(const Vec2f& other) const;
+	[[nodiscard]] T Distance(const Vec2& other) const
+	{
+		return (*this - other).GetMagnitude();
+	}
 
 	/**
 	 * \brief Computes the angle between this and other.
 	 * \param other The other vector.
 	 * \return The angle between this and other.
 	 */
-	[[nodiscard]] Radian Angle(const Vec2f& other) const;
+	[[nodiscard]] Radian Angle(const Vec2& other) const
+	{
+		return std::acos(this->Dot(other) / GetMagnitude() * other.GetMagnitude());
+	}
 
-	[[nodiscard]] Radian GetAngle() const;
+	[[nodiscard]] Radian GetAngle() const
+	{
+		const float angle = std::atan2(y, x);
+		return angle;
+	}
 
 	/**
 	 * \brief Gets the biggest component of this vector.
 	 * \return The biggest component of this vector.
 	 */
-	[[nodiscard]] float Major() const;
+	[[nodiscard]] constexpr T Major() const
+	{
+		if (x >= y)
+		{
+			return x;
+		}
+		return y;
+	}
 
 	/**
 	 * \brief Computes the perpendicular vector in +90 degrees.
 	 * \return The perpendicular vector in the positive direction.
 	 */
-	[[nodiscard]] Vec2f PositivePerpendicular() const;
+	[[nodiscard]] constexpr Vec2 PositivePerpendicular() const
+	{
+		return {-y, x};
+	}
 
 	/**
 	 * \brief Computes the perpendicular vector in -90 degrees.
 	 * \return The perpendicular vector in the negative direction.
 	 */
-	[[nodiscard]] Vec2f NegativePerpendicular() const;
+	[[nodiscard]] constexpr Vec2 NegativePerpendicular() const
+	{
+		return {y, -x};
+	}
 
-	[[nodiscard]] float Dot(Vec2f other) const;
+	[[nodiscard]] constexpr T Dot(const Vec2 other) const
+	{
+		return Dot(*this, other);
+	}
 
 	/**
 	 * \brief Sets the magnitude of this vector.
 	 * \param newMagnitude The new magnitude.
 	 */
-	[[nodiscard]] Vec2f NewMagnitude(float newMagnitude) const;
+	[[nodiscard]] Vec2 NewMagnitude(const T newMagnitude) const
+	{
+		if constexpr (std::is_floating_point_v<T>)
+		{
+			return (*this * newMagnitude) / GetMagnitude();
+		}
+		else
+		{
+			// Normalizing first keeps the precision of small fixed point vectors.
+			return GetNormalized() * newMagnitude;
+		}
+	}
 
 	/**
 	 * \brief Rotates this vector around the provided axis.
 	 * \param center The axis to rotate around.
 	 * \param angle The angle by which this vector should be rotated.
 	 */
-	void RotateAround(const Vec2f& center, float angle);
+	void RotateAround(const Vec2& center, const float angle)
+	{
+		const Vec2 relative = (*this) - center;
+		const float ca = std::cos(angle);
+		const float sa = std::sin(angle);
+		const auto rotated = Vec2(ca * relative.x - sa * relative.y, sa * relative.x + ca * relative.y);
+		(*this) = rotated + center;
+	}
 
-	[[nodiscard]] bool IsNaN() const;
+	[[nodiscard]] bool IsNaN() const
+	{
+		if constexpr (std::is_floating_point_v<T>)
+		{
+			return std::isnan(x) || std::isnan(y);
+		}
+		else
+		{
+			return false;
+		}
+	}
 
 	// ReSharper disable once CppNonExplicitConversionOperator
-	[[nodiscard]] operator sf::Vector2f() const { return {x, y}; }
-
-	Vec2f operator+(Vec2f v) const;
-	Vec2f operator-(Vec2f v) const;
-	Vec2f& operator+=(Vec2f v);
-	Vec2f& operator-=(Vec2f v);
-	Vec2f operator*(float f) const;
-	Vec2f operator/(float f) const;
-	Vec2f operator/=(float scalar);
-	Vec2f operator*=(float scalar);
-	Vec2f operator-() const;
-	bool operator==(Vec2f other) const;
-
-	static constexpr Vec2f Zero() { return {}; }
-	static constexpr Vec2f One() { return {1, 1}; }
-	static constexpr Vec2f Up() { return {0, 1}; }
-	static constexpr Vec2f Down() { return {0, -1}; }
-	static constexpr Vec2f Left() { return {-1, 0}; }
-	static constexpr Vec2f Right() { return {1, 0}; }
+	[[nodiscard]] operator sf::Vector2f() const { return {static_cast<float>(x), static_cast<float>(y)}; }
+
+	constexpr Vec2 operator+(const Vec2 v) const
+	{
+		return {x + v.x, y + v.y};
+	}
+
+	constexpr Vec2 operator-(const Vec2 v) const
+	{
+		return {x - v.x, y - v.y};
+	}
+
+	constexpr Vec2& operator+=(const Vec2 v)
+	{
+		x += v.x;
+		y += v.y;
+		return *this;
+	}
+
+	constexpr Vec2& operator-=(const Vec2 v)
+	{
+		x -= v.x;
+		y -= v.y;
+		return *this;
+	}
+
+	constexpr Vec2 operator*(const T f) const
+	{
+		return {x * f, y * f};
+	}
+
+	constexpr Vec2 operator/(const T f) const
+	{
+		return {x / f, y / f};
+	}
+
+	constexpr Vec2 operator/=(const T scalar)
+	{
+		this->x /= scalar;
+		this->y /= scalar;
+		return *this;
+	}
+
+	constexpr Vec2 operator*=(const T scalar)
+	{
+		this->x *= scalar;
+		this->y *= scalar;
+		return *this;
+	}
+
+	constexpr Vec2 operator-() const
+	{
+		return {-x, -y};
+	}
+
+	constexpr bool operator==(const Vec2 other) const
+	{
+		return x == other.x && y == other.y; // NOLINT(clang-diagnostic-float-equal)
+	}
+
+	static constexpr Vec2 Zero() { return {}; }
+	static constexpr Vec2 One() { return {T{1}, T{1}}; }
+	static constexpr Vec2 Up() { return {T{0}, T{1}}; }
+	static constexpr Vec2 Down() { return {T{0}, T{-1}}; }
+	static constexpr Vec2 Left() { return {T{-1}, T{0}}; }
+	static constexpr Vec2 Right() { return {T{1}, T{0}}; }
 };
 
-Vec2f operator*(float f, Vec2f v);
+// ReSharper disable once CppInconsistentNaming
+using Vec2f = Vec2<float>;
+
+template <typename T>
+constexpr Vec2<T> operator*(const T f, const Vec2<T> v)
+{
+	return v * f;
+}
+
+/**
+ * \brief Keeps the conversions of the left operand, like from an int, for the floating point vectors.
+ */
+constexpr Vec2f operator*(const float f, const Vec2f v)
+{
+	return v * f;
+}
 }
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+namespace core
+{
+/**
+ * \brief Maps signed numbers to unsigned ones so that the small negative numbers stay small: 0, -1, 1, -2...
+ */
+constexpr std::uint64_t ZigZagEncode(const std::int64_t value)
+{
+	return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+constexpr std::int64_t ZigZagDecode(const std::uint64_t value)
+{
+	return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+/**
+ * \brief Types that are serialized as a given number of bits: unsigned integers, booleans and enums.
+ */
+template <typename T>
+concept BitSerializable = std::is_unsigned_v<T> || std::is_enum_v<T>;
+
+template <BitSerializable T>
+constexpr std::uint64_t ToBits(const T value)
+{
+	if constexpr (std::is_enum_v<T>)
+	{
+		return static_cast<std::uint64_t>(static_cast<std::underlying_type_t<T>>(value));
+	}
+	else
+	{
+		return static_cast<std::uint64_t>(value);
+	}
+}
+
+template <BitSerializable T>
+constexpr T FromBits(const std::uint64_t bits)
+{
+	if constexpr (std::is_same_v<T, bool>)
+	{
+		return bits != 0;
+	}
+	else if constexpr (std::is_enum_v<T>)
+	{
+		return static_cast<T>(static_cast<std::underlying_type_t<T>>(bits));
+	}
+	else
+	{
+		return static_cast<T>(bits);
+	}
+}
+
+/**
+ * \brief Writes values of any number of bits in a buffer of bytes.
+ * The bits are written from the lowest bit of the first byte, so the values are stored in little endian
+ * and the result is the same on every platform.
+ */
+class BitWriter
+{
+public:
+	static constexpr bool IS_WRITING = true;
+
+	explicit BitWriter(std::span<std::uint8_t> buffer);
+
+	/**
+	 * \brief Writes the lowest bits of a value.
+	 * \param value The value to write, its bits over bitCount are ignored.
+	 * \param bitCount Number of bits to write, up to 64.
+	 */
+	void WriteBits(std::uint64_t value, int bitCount);
+
+	/**
+	 * \brief Writes a number in groups of bits, each one followed by a bit telling if another group follows.
+	 * Small numbers take less bits, like a varint with groups of any size.
+	 * \param value The number to write.
+	 * \param groupBits Number of bits of the number in every group.
+	 */
+	void WriteVarUint(std::uint64_t value, int groupBits);
+
+	/**
+	 * \brief The Serialize methods are shared with the BitReader, so one function template describes
+	 * the layout of a struct for both writing and reading it (see StreamData).
+	 */
+	template <BitSerializable T>
+	void SerializeBits(const T value, const int bitCount) { WriteBits(ToBits(value), bitCount); }
+
+	template <BitSerializable T>
+	void SerializeVarUint(const T value, const int groupBits) { WriteVarUint(ToBits(value), groupBits); }
+
+	void SerializeFloat(const float value) { WriteBits(std::bit_cast<std::uint32_t>(value), 32); }
+
+	[[nodiscard]] std::size_t BitCount() const { return _bitPosition; }
+
+	/**
+	 * \brief Number of bytes used by the bits that have been written.
+	 */
+	[[nodiscard]] std::size_t ByteCount() const { return (_bitPosition + 7) / 8; }
+
+	/**
+	 * \brief Tells if a write did not fit in the buffer, the bits that did not fit have been dropped.
+	 */
+	[[nodiscard]] bool HasOverflowed() const { return _hasOverflowed; }
+
+private:
+	std::span<std::uint8_t> _buffer;
+	std::size_t _bitPosition = 0;
+	bool _hasOverflowed = false;
+};
+
+/**
+ * \brief Reads the values written by a BitWriter.
+ * Reading past the end of the buffer gives zeros instead of failing, the caller checks HasOverflowed
+ * once all the values have been read.
+ */
+class BitReader
+{
+public:
+	static constexpr bool IS_WRITING = false;
+
+	explicit BitReader(std::span<const std::uint8_t> buffer);
+
+	/**
+	 * \brief Reads a value written with WriteBits.
+	 * \param bitCount Number of bits to read, up to 64.
+	 */
+	[[nodiscard]] std::uint64_t ReadBits(int bitCount);
+
+	/**
+	 * \brief Reads a number written with WriteVarUint, with the same size of groups.
+	 */
+	[[nodiscard]] std::uint64_t ReadVarUint(int groupBits);
+
+	template <BitSerializable T>
+	void SerializeBits(T& value, const int bitCount) { value = FromBits<T>(ReadBits(bitCount)); }
+
+	template <BitSerializable T>
+	void SerializeVarUint(T& value, const int groupBits) { value = FromBits<T>(ReadVarUint(groupBits)); }
+
+	void SerializeFloat(float& value) { value = std::bit_cast<float>(static_cast<std::uint32_t>(ReadBits(32))); }
+
+	[[nodiscard]] std::size_t BitCount() const { return _bitPosition; }
+	[[nodiscard]] bool HasOverflowed() const { return _hasOverflowed; }
+
+private:
+	std::span<const std::uint8_t> _buffer;
+	std::size_t _bitPosition = 0;
+	bool _hasOverflowed = false;
+};
+
+/**
+ * \brief The type of the data given to a Serialize function template: const when it is written, as it is only read from.
+ * \tparam Stream is a BitWriter or a BitReader.
+ */
+template <typename Stream, typename T>
+using StreamData = std::conditional_t<Stream::IS_WRITING, const T, T>;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace core
+{
+/**
+ * \brief Monotonic allocator for the temporaries of a frame, that are all released at once by Reset.
+ * The memory is kept between the frames, so once the arena has grown to what a frame needs,
+ * allocating from it never goes to the heap. It is a memory resource for the std::pmr containers.
+ */
+class FrameArena final : public std::pmr::memory_resource
+{
+public:
+	static constexpr std::size_t DEFAULT_CAPACITY = 64 * 1024;
+
+	/**
+	 * \brief Creates the arena with a first block.
+	 * \param capacity Size in bytes of the first block.
+	 */
+	explicit FrameArena(std::size_t capacity = DEFAULT_CAPACITY);
+
+	FrameArena(const FrameArena& other) = delete;
+	FrameArena(FrameArena&& other) = delete;
+	FrameArena& operator=(const FrameArena& other) = delete;
+	FrameArena& operator=(FrameArena&& other) = delete;
+	~FrameArena() override = default;
+
+	/**
+	 * \brief Releases everything that has been allocated since the last reset.
+	 * If the frame needed more than one block, they are replaced by a single one big enough for all of them.
+	 */
+	void Reset();
+
+	/**
+	 * \brief Number of bytes that can be allocated in a frame without going to the heap.
+	 */
+	[[nodiscard]] std::size_t Capacity() const;
+
+	/**
+	 * \brief Number of bytes allocated since the last reset, with the padding for the alignments.
+	 */
+	[[nodiscard]] std::size_t UsedSize() const { return _usedSize; }
+
+private:
+	struct Block
+	{
+		std::unique_ptr<std::byte[]> data;
+		std::size_t size = 0;
+	};
+
+	void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+	void do_deallocate(void* /*pointer*/, std::size_t /*bytes*/, std::size_t /*alignment*/) override {}
+	[[nodiscard]] bool do_is_equal(const memory_resource& other) const noexcept override { return this == &other; }
+
+	static Block AllocateBlock(std::size_t size);
+
+	Block _block;
+	std::size_t _offset = 0;
+
+	/**
+	 * \brief Blocks that have been filled during this frame, freed on the next reset.
+	 */
+	std::vector<Block> _fullBlocks;
+	std::size_t _usedSize = 0;
+};
+}
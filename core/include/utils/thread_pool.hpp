@@ -0,0 +1,110 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace core
+{
+/**
+ * \brief Pool of worker threads used to split a loop in chunks.
+ * The thread calling ParallelFor also works on the chunks, so a pool of one thread has no workers
+ * and runs everything on the caller.
+ */
+class ThreadPool
+{
+public:
+	/**
+	 * \brief Creates the pool and starts its workers.
+	 * \param threadCount Number of threads working on a loop, including the calling thread.
+	 */
+	explicit ThreadPool(std::size_t threadCount);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool& other) = delete;
+	ThreadPool(ThreadPool&& other) = delete;
+	ThreadPool& operator=(const ThreadPool& other) = delete;
+	ThreadPool& operator=(ThreadPool&& other) = delete;
+
+	[[nodiscard]] std::size_t ThreadCount() const { return _workers.size() + 1; }
+
+	/**
+	 * \brief Calls the function on every chunk of [0, size) and waits for all of them to be done.
+	 * The chunks only depend on the size and the grain size, not on the number of threads.
+	 * \param size Number of elements in the loop.
+	 * \param grainSize Number of elements in a chunk.
+	 * \param function Function called with the begin and end indices of a chunk.
+	 * It is only referenced during the call, so it is not copied and nothing is allocated.
+	 */
+	template <typename Function>
+	void ParallelFor(const std::size_t size, const std::size_t grainSize, Function&& function)
+	{
+		using FunctionType = std::remove_reference_t<Function>;
+		ChunkFunction chunkFunction;
+		chunkFunction.context = const_cast<void*>(static_cast<const void*>(std::addressof(function)));
+		chunkFunction.invoke = [](void* context, const std::size_t begin, const std::size_t end)
+		{
+			(*static_cast<FunctionType*>(context))(begin, end);
+		};
+		Run(size, grainSize, chunkFunction);
+	}
+
+private:
+	/**
+	 * \brief Non owning reference to the function of a loop.
+	 */
+	struct ChunkFunction
+	{
+		void* context = nullptr;
+		void (*invoke)(void* context, std::size_t begin, std::size_t end) = nullptr;
+
+		void operator()(const std::size_t begin, const std::size_t end) const { invoke(context, begin, end); }
+	};
+
+	/**
+	 * \brief State of a loop, the workers copy it under the lock when they join the loop.
+	 */
+	struct Loop
+	{
+		ChunkFunction function;
+		std::size_t size = 0;
+		std::size_t grainSize = 1;
+		std::size_t chunkCount = 0;
+		std::size_t generation = 0;
+	};
+
+	void Run(std::size_t size, std::size_t grainSize, ChunkFunction function);
+
+	void WorkerLoop();
+
+	/**
+	 * \brief Processes chunks of the loop until there is none left, or until the next loop is published.
+	 */
+	void RunChunks(const Loop& loop);
+
+	std::vector<std::thread> _workers;
+
+	std::mutex _mutex;
+	std::condition_variable _startCondition;
+	std::condition_variable _doneCondition;
+
+	Loop _loop;
+	std::atomic<std::size_t> _nextChunk = 0;
+	std::atomic<std::size_t> _doneChunks = 0;
+
+	/**
+	 * \brief Generation of the current loop, the workers read it without the lock to stop claiming chunks.
+	 */
+	std::atomic<std::size_t> _generation = 0;
+	/**
+	 * \brief Number of workers between the copy of a loop and the end of their RunChunks.
+	 */
+	std::size_t _activeWorkers = 0;
+	bool _isStopping = false;
+};
+}
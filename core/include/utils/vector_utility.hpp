@@ -0,0 +1,20 @@
+#pragma once
+
+#include <vector>
+
+namespace core
+{
+/**
+ * \brief Reserves four times the size of a vector that has less than twice its size in capacity.
+ * Meant for the vectors that are filled again at every frame: their size goes up and down around
+ * the same value, and keeping this margin avoids the allocation of each new maximum.
+ */
+template <class T, class Allocator>
+void KeepCapacityMargin(std::vector<T, Allocator>& vector)
+{
+	if (vector.capacity() < 2 * vector.size())
+	{
+		vector.reserve(4 * vector.size());
+	}
+}
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace core
+{
+/**
+ * \brief Runs independent tasks on one worker thread per core.
+ * Each worker has its own queue: it runs its newest task first, while the idle workers steal the oldest tasks
+ * of the others, so a busy worker does not keep its tasks waiting.
+ */
+class WorkStealingScheduler
+{
+public:
+	/**
+	 * \brief Creates the scheduler and starts its workers.
+	 * \param threadCount Number of worker threads, one per core when it is 0.
+	 */
+	explicit WorkStealingScheduler(std::size_t threadCount = 0);
+	~WorkStealingScheduler();
+
+	WorkStealingScheduler(const WorkStealingScheduler& other) = delete;
+	WorkStealingScheduler(WorkStealingScheduler&& other) = delete;
+	WorkStealingScheduler& operator=(const WorkStealingScheduler& other) = delete;
+	WorkStealingScheduler& operator=(WorkStealingScheduler&& other) = delete;
+
+	[[nodiscard]] std::size_t ThreadCount() const { return _workers.size(); }
+
+	/**
+	 * \brief Queues a task on a worker.
+	 * \param workerIndex Worker that runs the task unless another one steals it, it wraps around the number of workers.
+	 * Giving the same worker to the tasks that use the same data keeps the data in the cache of a core.
+	 * \param task Function to run, it must not throw.
+	 */
+	void Schedule(std::size_t workerIndex, std::function<void()> task);
+
+	/**
+	 * \brief Waits until all the queued tasks have been run.
+	 */
+	void WaitIdle();
+
+private:
+	struct Worker
+	{
+		std::mutex mutex;
+		std::deque<std::function<void()>> tasks;
+		std::thread thread;
+	};
+
+	void WorkerLoop(std::size_t workerIndex);
+
+	/**
+	 * \brief Takes the newest task of the worker, or the oldest task of another one.
+	 */
+	bool TryTakeTask(std::size_t workerIndex, std::function<void()>& task);
+
+	std::vector<std::unique_ptr<Worker>> _workers;
+
+	std::mutex _mutex;
+	std::condition_variable _wakeCondition;
+	std::condition_variable _idleCondition;
+
+	/**
+	 * \brief Number of tasks waiting in the queues, and number of tasks that have not finished yet.
+	 */
+	std::atomic<std::size_t> _queuedTaskCount = 0;
+	std::atomic<std::size_t> _pendingTaskCount = 0;
+	bool _isStopping = false;
+};
+}
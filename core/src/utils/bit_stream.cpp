@@ -0,0 +1,91 @@
+#include "utils/bit_stream.hpp"
+
+#include <algorithm>
+
+namespace core
+{
+BitWriter::BitWriter(const std::span<std::uint8_t> buffer)
+	: _buffer(buffer)
+{
+}
+
+void BitWriter::WriteBits(std::uint64_t value, int bitCount)
+{
+	if (_bitPosition + static_cast<std::size_t>(bitCount) > _buffer.size() * 8)
+	{
+		_hasOverflowed = true;
+		return;
+	}
+
+	while (bitCount > 0)
+	{
+		const std::size_t byteIndex = _bitPosition / 8;
+		const int bitOffset = static_cast<int>(_bitPosition % 8);
+		const int chunkBits = std::min(8 - bitOffset, bitCount);
+		const auto chunk = static_cast<std::uint8_t>((value & ((1u << chunkBits) - 1u)) << bitOffset);
+
+		// The first bits of a byte overwrite it, so the buffer does not need to be cleared
+		_buffer[byteIndex] = bitOffset == 0 ? chunk : static_cast<std::uint8_t>(_buffer[byteIndex] | chunk);
+
+		value >>= chunkBits;
+		bitCount -= chunkBits;
+		_bitPosition += static_cast<std::size_t>(chunkBits);
+	}
+}
+
+void BitWriter::WriteVarUint(std::uint64_t value, const int groupBits)
+{
+	const std::uint64_t groupMask = (std::uint64_t{1} << groupBits) - 1;
+	while (value > groupMask)
+	{
+		WriteBits((value & groupMask) | (std::uint64_t{1} << groupBits), groupBits + 1);
+		value >>= groupBits;
+	}
+	WriteBits(value, groupBits + 1);
+}
+
+BitReader::BitReader(const std::span<const std::uint8_t> buffer)
+	: _buffer(buffer)
+{
+}
+
+std::uint64_t BitReader::ReadBits(const int bitCount)
+{
+	if (_bitPosition + static_cast<std::size_t>(bitCount) > _buffer.size() * 8)
+	{
+		_hasOverflowed = true;
+		_bitPosition = _buffer.size() * 8;
+		return 0;
+	}
+
+	std::uint64_t value = 0;
+	int readBits = 0;
+	while (readBits < bitCount)
+	{
+		const std::size_t byteIndex = _bitPosition / 8;
+		const int bitOffset = static_cast<int>(_bitPosition % 8);
+		const int chunkBits = std::min(8 - bitOffset, bitCount - readBits);
+		const std::uint64_t chunk = (_buffer[byteIndex] >> bitOffset) & ((1u << chunkBits) - 1u);
+
+		value |= chunk << readBits;
+		readBits += chunkBits;
+		_bitPosition += static_cast<std::size_t>(chunkBits);
+	}
+	return value;
+}
+
+std::uint64_t BitReader::ReadVarUint(const int groupBits)
+{
+	const std::uint64_t groupMask = (std::uint64_t{1} << groupBits) - 1;
+	std::uint64_t value = 0;
+
+	// A corrupted number stops at 64 bits instead of reading the whole buffer
+	for (int shift = 0; shift < 64; shift += groupBits)
+	{
+		const std::uint64_t group = ReadBits(groupBits + 1);
+		value |= (group & groupMask) << shift;
+		if ((group >> groupBits) == 0) break;
+	}
+	return value;
+}
+}
@@ -0,0 +1,64 @@
+#include "utils/frame_arena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace core
+{
+FrameArena::FrameArena(const std::size_t capacity)
+	: _block(AllocateBlock(capacity))
+{
+}
+
+void FrameArena::Reset()
+{
+	if (!_fullBlocks.empty())
+	{
+		const std::size_t capacity = Capacity();
+		_fullBlocks.clear();
+		_block = {};
+		_block = AllocateBlock(capacity);
+	}
+
+	_offset = 0;
+	_usedSize = 0;
+}
+
+std::size_t FrameArena::Capacity() const
+{
+	std::size_t capacity = _block.size;
+	for (const Block& block : _fullBlocks)
+	{
+		capacity += block.size;
+	}
+	return capacity;
+}
+
+void* FrameArena::do_allocate(const std::size_t bytes, const std::size_t alignment)
+{
+	const auto alignedOffset = [alignment](const Block& block, const std::size_t offset)
+	{
+		const auto address = reinterpret_cast<std::uintptr_t>(block.data.get()) + offset;
+		return offset + (alignment - address % alignment) % alignment;
+	};
+
+	std::size_t offset = alignedOffset(_block, _offset);
+	if (offset + bytes > _block.size)
+	{
+		// The blocks grow geometrically, so a frame only needs a few of them before the next reset
+		_fullBlocks.push_back(std::move(_block));
+		_block = AllocateBlock(std::max(_fullBlocks.back().size * 2, bytes + alignment));
+		_offset = 0;
+		offset = alignedOffset(_block, _offset);
+	}
+
+	_usedSize += offset + bytes - _offset;
+	_offset = offset + bytes;
+	return _block.data.get() + offset;
+}
+
+FrameArena::Block FrameArena::AllocateBlock(const std::size_t size)
+{
+	return {std::make_unique_for_overwrite<std::byte[]>(size), size};
+}
+}
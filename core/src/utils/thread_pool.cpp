@@ -0,0 +1,112 @@
+#include "utils/thread_pool.hpp"
+
+#include <algorithm>
+
+namespace core
+{
+ThreadPool::ThreadPool(const std::size_t threadCount)
+{
+	const std::size_t workerCount = std::max<std::size_t>(threadCount, 1) - 1;
+	_workers.reserve(workerCount);
+	for (std::size_t i = 0; i < workerCount; i++)
+	{
+		_workers.emplace_back(&ThreadPool::WorkerLoop, this);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::scoped_lock lock(_mutex);
+		_isStopping = true;
+	}
+	_startCondition.notify_all();
+
+	for (std::thread& worker : _workers)
+	{
+		worker.join();
+	}
+}
+
+void ThreadPool::Run(const std::size_t size, const std::size_t grainSize, const ChunkFunction function)
+{
+	if (size == 0) return;
+
+	const std::size_t chunkGrain = std::max<std::size_t>(grainSize, 1);
+	const std::size_t chunkCount = (size + chunkGrain - 1) / chunkGrain;
+
+	// Not worth waking the workers for a single chunk
+	if (_workers.empty() || chunkCount == 1)
+	{
+		for (std::size_t begin = 0; begin < size; begin += chunkGrain)
+		{
+			function(begin, std::min(begin + chunkGrain, size));
+		}
+		return;
+	}
+
+	Loop loop;
+	{
+		std::unique_lock lock(_mutex);
+		// A worker that joined the previous loop after its last chunk may still be claiming chunks
+		_doneCondition.wait(lock, [this] { return _activeWorkers == 0; });
+
+		loop = {function, size, chunkGrain, chunkCount, _loop.generation + 1};
+		_loop = loop;
+		_nextChunk = 0;
+		_doneChunks = 0;
+		_generation = loop.generation;
+	}
+	_startCondition.notify_all();
+
+	RunChunks(loop);
+
+	// The function must stay alive until every worker that joined the loop left RunChunks
+	std::unique_lock lock(_mutex);
+	_doneCondition.wait(lock, [this, chunkCount] { return _doneChunks == chunkCount && _activeWorkers == 0; });
+}
+
+void ThreadPool::WorkerLoop()
+{
+	std::size_t lastGeneration = 0;
+
+	while (true)
+	{
+		Loop loop;
+		{
+			std::unique_lock lock(_mutex);
+			_startCondition.wait(lock, [this, lastGeneration]
+			{
+				return _isStopping || _loop.generation != lastGeneration;
+			});
+
+			if (_isStopping) return;
+
+			loop = _loop;
+			lastGeneration = loop.generation;
+			_activeWorkers++;
+		}
+
+		RunChunks(loop);
+
+		{
+			std::scoped_lock lock(_mutex);
+			_activeWorkers--;
+		}
+		_doneCondition.notify_one();
+	}
+}
+
+void ThreadPool::RunChunks(const Loop& loop)
+{
+	while (_generation == loop.generation)
+	{
+		const std::size_t chunk = _nextChunk.fetch_add(1);
+		if (chunk >= loop.chunkCount) return;
+
+		const std::size_t begin = chunk * loop.grainSize;
+		loop.function(begin, std::min(begin + loop.grainSize, loop.size));
+		_doneChunks.fetch_add(1);
+	}
+}
+}
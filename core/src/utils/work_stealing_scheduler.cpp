@@ -0,0 +1,116 @@
+#include "utils/work_stealing_scheduler.hpp"
+
+#include <algorithm>
+
+namespace core
+{
+WorkStealingScheduler::WorkStealingScheduler(const std::size_t threadCount)
+{
+	const std::size_t workerCount = threadCount != 0
+		                                ? threadCount
+		                                : std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+
+	// All the workers exist before any of them starts stealing
+	_workers.reserve(workerCount);
+	for (std::size_t i = 0; i < workerCount; i++)
+	{
+		_workers.push_back(std::make_unique<Worker>());
+	}
+	for (std::size_t i = 0; i < workerCount; i++)
+	{
+		_workers[i]->thread = std::thread(&WorkStealingScheduler::WorkerLoop, this, i);
+	}
+}
+
+WorkStealingScheduler::~WorkStealingScheduler()
+{
+	{
+		std::scoped_lock lock(_mutex);
+		_isStopping = true;
+	}
+	_wakeCondition.notify_all();
+
+	for (const auto& worker : _workers)
+	{
+		worker->thread.join();
+	}
+}
+
+void WorkStealingScheduler::Schedule(const std::size_t workerIndex, std::function<void()> task)
+{
+	_pendingTaskCount++;
+
+	Worker& worker = *_workers[workerIndex % _workers.size()];
+	{
+		std::scoped_lock lock(worker.mutex);
+		worker.tasks.push_back(std::move(task));
+	}
+
+	// The count is changed under the lock of the sleeping workers, so they can not miss the task
+	{
+		std::scoped_lock lock(_mutex);
+		_queuedTaskCount++;
+	}
+	_wakeCondition.notify_one();
+}
+
+void WorkStealingScheduler::WaitIdle()
+{
+	std::unique_lock lock(_mutex);
+	_idleCondition.wait(lock, [this] { return _pendingTaskCount == 0; });
+}
+
+void WorkStealingScheduler::WorkerLoop(const std::size_t workerIndex)
+{
+	std::function<void()> task;
+	while (true)
+	{
+		if (TryTakeTask(workerIndex, task))
+		{
+			task();
+			task = nullptr;
+
+			if (_pendingTaskCount.fetch_sub(1) == 1)
+			{
+				std::scoped_lock lock(_mutex);
+				_idleCondition.notify_all();
+			}
+			continue;
+		}
+
+		std::unique_lock lock(_mutex);
+		_wakeCondition.wait(lock, [this] { return _isStopping || _queuedTaskCount > 0; });
+		if (_isStopping) return;
+	}
+}
+
+bool WorkStealingScheduler::TryTakeTask(const std::size_t workerIndex, std::function<void()>& task)
+{
+	{
+		Worker& worker = *_workers[workerIndex];
+		std::scoped_lock lock(worker.mutex);
+		if (!worker.tasks.empty())
+		{
+			task = std::move(worker.tasks.back());
+			worker.tasks.pop_back();
+			_queuedTaskCount--;
+			return true;
+		}
+	}
+
+	// The victims are visited from the next worker, so the thieves do not all start with the same one
+	for (std::size_t offset = 1; offset < _workers.size(); offset++)
+	{
+		Worker& victim = *_workers[(workerIndex + offset) % _workers.size()];
+		std::scoped_lock lock(victim.mutex);
+		if (!victim.tasks.empty())
+		{
+			task = std::move(victim.tasks.front());
+			victim.tasks.pop_front();
+			_queuedTaskCount--;
+			return true;
+		}
+	}
+	return false;
+}
+}
@@ -0,0 +1,127 @@
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+
+#include <gtest/gtest.h>
+
+#include "utils/bit_stream.hpp"
+
+TEST(BitStream, BitsAreReadBack)
+{
+	std::array<std::uint8_t, 16> buffer{};
+	core::BitWriter writer(buffer);
+	writer.WriteBits(1, 1);
+	writer.WriteBits(0b10110, 5);
+	writer.WriteBits(0xABCDEF, 24);
+	writer.WriteBits(0x0123456789ABCDEF, 64);
+	EXPECT_EQ(writer.BitCount(), 94u);
+	EXPECT_EQ(writer.ByteCount(), 12u);
+	EXPECT_FALSE(writer.HasOverflowed());
+
+	core::BitReader reader(std::span(buffer.data(), writer.ByteCount()));
+	EXPECT_EQ(reader.ReadBits(1), 1u);
+	EXPECT_EQ(reader.ReadBits(5), 0b10110u);
+	EXPECT_EQ(reader.ReadBits(24), 0xABCDEFu);
+	EXPECT_EQ(reader.ReadBits(64), 0x0123456789ABCDEFu);
+	EXPECT_FALSE(reader.HasOverflowed());
+}
+
+TEST(BitStream, VarUintSizeDependsOnTheValue)
+{
+	std::array<std::uint8_t, 32> buffer{};
+	core::BitWriter writer(buffer);
+	writer.WriteVarUint(3, 4);
+	EXPECT_EQ(writer.BitCount(), 5u);
+	writer.WriteVarUint(300, 4);
+	EXPECT_EQ(writer.BitCount(), 5u + 15u);
+	writer.WriteVarUint(UINT64_MAX, 7);
+
+	core::BitReader reader(std::span(buffer.data(), writer.ByteCount()));
+	EXPECT_EQ(reader.ReadVarUint(4), 3u);
+	EXPECT_EQ(reader.ReadVarUint(4), 300u);
+	EXPECT_EQ(reader.ReadVarUint(7), UINT64_MAX);
+	EXPECT_FALSE(reader.HasOverflowed());
+}
+
+TEST(BitStream, ZigZag)
+{
+	for (const std::int64_t value : std::initializer_list<std::int64_t>{0, -1, 1, -2, 1000, INT64_MIN, INT64_MAX})
+	{
+		EXPECT_EQ(core::ZigZagDecode(core::ZigZagEncode(value)), value);
+	}
+	EXPECT_EQ(core::ZigZagEncode(-1), 1u);
+	EXPECT_EQ(core::ZigZagEncode(1), 2u);
+}
+
+TEST(BitStream, Overflow)
+{
+	std::array<std::uint8_t, 1> buffer{};
+	core::BitWriter writer(buffer);
+	writer.WriteBits(0b101, 3);
+	writer.WriteBits(0xFF, 8);
+	EXPECT_TRUE(writer.HasOverflowed());
+	EXPECT_EQ(writer.BitCount(), 3u);
+
+	core::BitReader reader(buffer);
+	EXPECT_EQ(reader.ReadBits(3), 0b101u);
+	EXPECT_EQ(reader.ReadBits(8), 0u);
+	EXPECT_TRUE(reader.HasOverflowed());
+}
+
+namespace
+{
+enum class Color : std::uint8_t
+{
+	Red,
+	Green,
+	Blue,
+};
+
+struct Sample
+{
+	Color color = Color::Red;
+	bool isVisible = false;
+	std::uint32_t frame = 0;
+	float position = 0.0f;
+};
+
+template <typename Stream>
+void Serialize(Stream& stream, core::StreamData<Stream, Sample>& sample)
+{
+	stream.SerializeBits(sample.color, 2);
+	stream.SerializeBits(sample.isVisible, 1);
+	stream.SerializeVarUint(sample.frame, 7);
+	stream.SerializeFloat(sample.position);
+}
+}
+
+TEST(BitStream, SerializeIsSymmetric)
+{
+	const Sample sample{Color::Blue, true, 100000, -1.5f};
+
+	std::array<std::uint8_t, 16> buffer{};
+	core::BitWriter writer(buffer);
+	Serialize(writer, sample);
+	EXPECT_EQ(writer.BitCount(), 2u + 1u + 24u + 32u);
+
+	Sample readSample{};
+	core::BitReader reader(std::span(buffer.data(), writer.ByteCount()));
+	Serialize(reader, readSample);
+	EXPECT_FALSE(reader.HasOverflowed());
+	EXPECT_EQ(readSample.color, sample.color);
+	EXPECT_EQ(readSample.isVisible, sample.isVisible);
+	EXPECT_EQ(readSample.frame, sample.frame);
+	EXPECT_EQ(readSample.position, sample.position);
+}
+
+TEST(BitStream, LittleEndian)
+{
+	std::array<std::uint8_t, 4> buffer{};
+	core::BitWriter writer(buffer);
+	writer.WriteBits(0x12345678, 32);
+
+	EXPECT_EQ(buffer[0], 0x78);
+	EXPECT_EQ(buffer[1], 0x56);
+	EXPECT_EQ(buffer[2], 0x34);
+	EXPECT_EQ(buffer[3], 0x12);
+}
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include "maths/fixed.hpp"
+#include "maths/vec2.hpp"
+
+TEST(Fixed, FromFloat)
+{
+	constexpr core::Fixed16 value{1.5f};
+	EXPECT_EQ(value.Raw(), 3 << 15);
+	EXPECT_FLOAT_EQ(static_cast<float>(value), 1.5f);
+
+	constexpr core::Fixed16 negative{-2};
+	EXPECT_EQ(negative.Raw(), -2 << 16);
+	EXPECT_EQ(static_cast<int>(negative), -2);
+}
+
+TEST(Fixed, Saturates)
+{
+	constexpr core::Fixed16 big{1.0e9f};
+	EXPECT_EQ(big, core::Fixed16::Max());
+
+	constexpr core::Fixed16 small{-1.0e9f};
+	EXPECT_EQ(small, core::Fixed16::Lowest());
+
+	EXPECT_EQ(core::Fixed16{1} / core::Fixed16{0}, core::Fixed16::Max());
+	EXPECT_EQ(core::Fixed16{-1} / core::Fixed16{0}, core::Fixed16::Lowest());
+}
+
+TEST(Fixed, Arithmetic)
+{
+	constexpr core::Fixed16 a{2.5f};
+	constexpr core::Fixed16 b{-0.75f};
+
+	EXPECT_FLOAT_EQ(static_cast<float>(a + b), 1.75f);
+	EXPECT_FLOAT_EQ(static_cast<float>(a - b), 3.25f);
+	EXPECT_FLOAT_EQ(static_cast<float>(a * b), -1.875f);
+	EXPECT_NEAR(static_cast<float>(a / b), -10.0f / 3.0f, 1.0e-4f);
+	EXPECT_FLOAT_EQ(static_cast<float>(-a), -2.5f);
+	EXPECT_FLOAT_EQ(static_cast<float>(2 * a), 5.0f);
+	EXPECT_FLOAT_EQ(static_cast<float>(a * 0.5f), 1.25f);
+
+	EXPECT_TRUE(b < a);
+	EXPECT_TRUE(0.0f < a);
+	EXPECT_TRUE(b < 0);
+}
+
+TEST(Fixed, Rounding)
+{
+	// 1/3 is rounded to the nearest, the product of the smallest numbers too
+	constexpr auto third = core::Fixed16{1} / core::Fixed16{3};
+	EXPECT_EQ(third.Raw(), 21845);
+	EXPECT_EQ((core::Fixed16{2} / core::Fixed16{3}).Raw(), 43691);
+	EXPECT_EQ((core::Fixed16{-2} / core::Fixed16{3}).Raw(), -43691);
+
+	const auto epsilon = core::Fixed16::Epsilon();
+	EXPECT_EQ((epsilon * core::Fixed16{0.5f}).Raw(), 1);
+	EXPECT_EQ((epsilon * core::Fixed16{0.25f}).Raw(), 0);
+}
+
+TEST(Fixed, Sqrt)
+{
+	EXPECT_EQ(core::Sqrt(core::Fixed16{4}), core::Fixed16{2});
+	EXPECT_EQ(core::Sqrt(core::Fixed16{0}), core::Fixed16{0});
+	EXPECT_EQ(core::Sqrt(core::Fixed16{-4}), core::Fixed16{0});
+	EXPECT_NEAR(static_cast<float>(core::Sqrt(core::Fixed16{2})), 1.41421356f, 1.0e-4f);
+	EXPECT_NEAR(static_cast<float>(core::Sqrt(core::Fixed16{10000})), 100.0f, 1.0e-4f);
+}
+
+#if defined(__SIZEOF_INT128__)
+TEST(Fixed, Fixed32)
+{
+	constexpr core::Fixed32 a{1000.25};
+	constexpr core::Fixed32 b{-0.125};
+
+	EXPECT_EQ(a * b, core::Fixed32{-125.03125});
+	EXPECT_EQ(a / b, core::Fixed32{-8002});
+	EXPECT_NEAR(static_cast<double>(core::Fixed32{1} / core::Fixed32{3}), 1.0 / 3.0, 1.0e-9);
+	EXPECT_NEAR(static_cast<double>(core::Sqrt(a * a)), 1000.25, 1.0e-9);
+	EXPECT_EQ(core::Fixed32{10000} * core::Fixed32{10000}, core::Fixed32{100000000});
+}
+#endif
+
+TEST(Fixed, Vec2)
+{
+	using Vec2x = core::Vec2<core::Fixed16>;
+
+	const Vec2x v{3, 4};
+	EXPECT_EQ(v.GetMagnitude(), core::Fixed16{5});
+	EXPECT_EQ(v.GetNormalized(), Vec2x(0.6f, 0.8f));
+	EXPECT_EQ(Vec2x::Dot(v, v.PositivePerpendicular()), core::Fixed16{0});
+	EXPECT_FALSE(v.IsNaN());
+
+	const core::Vec2f floatVector = v * 0.5f;
+	EXPECT_FLOAT_EQ(floatVector.x, 1.5f);
+	EXPECT_FLOAT_EQ(floatVector.y, 2.0f);
+
+	const Vec2x fixedVector = core::Vec2f(1.5f, -2.0f);
+	EXPECT_EQ(fixedVector, Vec2x(1.5f, -2));
+}
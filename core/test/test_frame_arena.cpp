@@ -0,0 +1,56 @@
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "utils/frame_arena.hpp"
+
+TEST(FrameArena, AllocationsAreAligned)
+{
+	core::FrameArena frameArena(256);
+
+	for (const std::size_t alignment : {1u, 2u, 4u, 8u, 16u, 64u})
+	{
+		void* pointer = frameArena.allocate(3, alignment);
+		EXPECT_EQ(reinterpret_cast<std::uintptr_t>(pointer) % alignment, 0u);
+	}
+}
+
+TEST(FrameArena, ResetKeepsTheMemoryOfTheFrame)
+{
+	core::FrameArena frameArena(64);
+
+	std::pmr::vector<int> numbers(&frameArena);
+	for (int i = 0; i < 1000; i++)
+	{
+		numbers.push_back(i);
+	}
+	EXPECT_EQ(numbers[999], 999);
+	EXPECT_GT(frameArena.Capacity(), 64u);
+
+	const std::size_t usedSize = frameArena.UsedSize();
+	numbers = std::pmr::vector<int>(&frameArena);
+	frameArena.Reset();
+	EXPECT_EQ(frameArena.UsedSize(), 0u);
+
+	// The next frame does the same allocations in the merged block, without growing
+	const std::size_t capacity = frameArena.Capacity();
+	EXPECT_GE(capacity, usedSize);
+
+	std::pmr::vector<int> otherNumbers(&frameArena);
+	for (int i = 0; i < 1000; i++)
+	{
+		otherNumbers.push_back(i);
+	}
+	EXPECT_EQ(frameArena.Capacity(), capacity);
+}
+
+TEST(FrameArena, BigAllocation)
+{
+	core::FrameArena frameArena(16);
+
+	auto* bytes = static_cast<std::byte*>(frameArena.allocate(1000, 8));
+	bytes[999] = std::byte{1};
+	EXPECT_GE(frameArena.UsedSize(), 1000u);
+}
@@ -0,0 +1,105 @@
+#include <atomic>
+#include <numeric>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "utils/thread_pool.hpp"
+
+TEST(ThreadPool, ParallelForVisitsEveryIndexOnce)
+{
+	for (const std::size_t threadCount : {1u, 2u, 4u})
+	{
+		core::ThreadPool threadPool(threadCount);
+		EXPECT_EQ(threadPool.ThreadCount(), threadCount);
+
+		std::vector<std::atomic<int>> visits(1000);
+		for (int loop = 0; loop < 10; loop++)
+		{
+			threadPool.ParallelFor(visits.size(), 7, [&visits](const std::size_t begin, const std::size_t end)
+			{
+				for (std::size_t i = begin; i < end; i++)
+				{
+					visits[i]++;
+				}
+			});
+		}
+
+		for (const auto& visit : visits)
+		{
+			EXPECT_EQ(visit, 10);
+		}
+	}
+}
+
+TEST(ThreadPool, ParallelForChunksDoNotDependOnThreadCount)
+{
+	std::vector<std::size_t> firstChunkSums;
+	for (const std::size_t threadCount : {1u, 3u})
+	{
+		core::ThreadPool threadPool(threadCount);
+
+		std::vector<std::size_t> chunkSums(10);
+		threadPool.ParallelFor(95, 10, [&chunkSums](const std::size_t begin, const std::size_t end)
+		{
+			std::vector<std::size_t> indices(end - begin);
+			std::iota(indices.begin(), indices.end(), begin);
+			chunkSums[begin / 10] = std::accumulate(indices.begin(), indices.end(), std::size_t{0});
+		});
+
+		if (firstChunkSums.empty())
+		{
+			firstChunkSums = chunkSums;
+		}
+		else
+		{
+			EXPECT_EQ(firstChunkSums, chunkSums);
+		}
+	}
+}
+
+TEST(ThreadPool, EmptyLoop)
+{
+	core::ThreadPool threadPool(2);
+	bool isCalled = false;
+	threadPool.ParallelFor(0, 4, [&isCalled](std::size_t, std::size_t) { isCalled = true; });
+	EXPECT_FALSE(isCalled);
+}
+
+TEST(ThreadPool, ParallelForUsesTheFunctionInPlace)
+{
+	// The function is not copied, so the chunks update the object given by the caller
+	struct ChunkCounter
+	{
+		std::atomic<std::size_t> chunkCount = 0;
+
+		void operator()(std::size_t, std::size_t) { chunkCount.fetch_add(1); }
+	};
+
+	core::ThreadPool threadPool(3);
+	ChunkCounter chunkCounter;
+	threadPool.ParallelFor(100, 10, chunkCounter);
+	EXPECT_EQ(chunkCounter.chunkCount, 10u);
+}
+
+TEST(ThreadPool, ConsecutiveLoopsDoNotOverlap)
+{
+	// Each loop has its own function and counters, a worker late from a loop must not run a chunk of the next one
+	core::ThreadPool threadPool(4);
+	for (std::size_t loop = 0; loop < 2000; loop++)
+	{
+		std::vector<int> visits(2 + loop % 31);
+		threadPool.ParallelFor(visits.size(), 1, [&visits](const std::size_t begin, const std::size_t end)
+		{
+			for (std::size_t i = begin; i < end; i++)
+			{
+				visits[i]++;
+			}
+		});
+
+		for (const int visit : visits)
+		{
+			ASSERT_EQ(visit, 1);
+		}
+	}
+}
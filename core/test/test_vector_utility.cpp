@@ -0,0 +1,34 @@
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "utils/vector_utility.hpp"
+
+TEST(VectorUtility, MarginIsReservedWhenTheVectorGrows)
+{
+	std::vector<int> vector(10);
+	vector.shrink_to_fit();
+
+	core::KeepCapacityMargin(vector);
+
+	EXPECT_EQ(vector.size(), 10u);
+	EXPECT_GE(vector.capacity(), 40u);
+}
+
+TEST(VectorUtility, VariationsUnderTheMarginKeepTheMemory)
+{
+	std::vector<int> vector(10);
+	core::KeepCapacityMargin(vector);
+	const int* data = vector.data();
+	const std::size_t capacity = vector.capacity();
+
+	for (const std::size_t size : {5u, 20u, 12u, 15u})
+	{
+		vector.clear();
+		vector.resize(size);
+		core::KeepCapacityMargin(vector);
+
+		EXPECT_EQ(vector.data(), data);
+		EXPECT_EQ(vector.capacity(), capacity);
+	}
+}
@@ -0,0 +1,67 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "utils/work_stealing_scheduler.hpp"
+
+TEST(WorkStealingScheduler, RunsEveryTask)
+{
+	for (const std::size_t threadCount : {1u, 2u, 4u})
+	{
+		core::WorkStealingScheduler scheduler(threadCount);
+		EXPECT_EQ(scheduler.ThreadCount(), threadCount);
+
+		std::atomic<int> runCount = 0;
+		for (int loop = 0; loop < 10; loop++)
+		{
+			for (std::size_t i = 0; i < 100; i++)
+			{
+				scheduler.Schedule(i, [&runCount] { runCount++; });
+			}
+			scheduler.WaitIdle();
+			EXPECT_EQ(runCount, (loop + 1) * 100);
+		}
+	}
+}
+
+TEST(WorkStealingScheduler, IdleWorkersStealTasks)
+{
+	core::WorkStealingScheduler scheduler(4);
+
+	// The first worker is kept busy until the tasks queued behind it have been run by the others
+	std::atomic<bool> isBusy = false;
+	std::atomic<int> stolenCount = 0;
+	bool areTasksStolen = false;
+	scheduler.Schedule(0, [&isBusy, &stolenCount, &areTasksStolen]
+	{
+		isBusy = true;
+		const auto start = std::chrono::steady_clock::now();
+		while (stolenCount < 20 && std::chrono::steady_clock::now() - start < std::chrono::seconds(5))
+		{
+			std::this_thread::yield();
+		}
+		areTasksStolen = stolenCount == 20;
+	});
+
+	while (!isBusy)
+	{
+		std::this_thread::yield();
+	}
+	for (int i = 0; i < 20; i++)
+	{
+		scheduler.Schedule(0, [&stolenCount] { stolenCount++; });
+	}
+	scheduler.WaitIdle();
+
+	EXPECT_TRUE(areTasksStolen);
+	EXPECT_EQ(stolenCount, 20);
+}
+
+TEST(WorkStealingScheduler, WaitIdleWithoutTasks)
+{
+	core::WorkStealingScheduler scheduler(2);
+	scheduler.WaitIdle();
+	EXPECT_GE(scheduler.ThreadCount(), 1u);
+}
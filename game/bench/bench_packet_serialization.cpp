@@ -0,0 +1,173 @@
+#include <array>
+#include <cstdint>
+
+#include <benchmark/benchmark.h>
+
+#include <SFML/Network/Packet.hpp>
+
+#include "network/packet_type.hpp"
+
+#include "utils/conversion.hpp"
+
+namespace
+{
+/**
+ * \brief The input packets as they were sent before the bit stream: every field is an array of bytes
+ * streamed one byte at a time in a sf::Packet, with all the inputs of the window.
+ */
+struct LegacyPlayerInputPacket
+{
+	game::PlayerNumber playerNumber = game::INVALID_PLAYER;
+	std::array<std::uint8_t, sizeof(game::Frame)> currentFrame{};
+	std::array<game::PlayerInput, game::MAX_INPUT_NMB> inputs{};
+};
+
+struct LegacyServerInputsPacket
+{
+	std::array<std::uint8_t, sizeof(game::Frame)> validateFrame{};
+	std::array<std::uint8_t, sizeof(game::PhysicsState) * game::MAX_PLAYER_NMB> physicsState{};
+	std::array<std::array<std::uint8_t, sizeof(game::Frame)>, game::MAX_PLAYER_NMB> lastReceivedFrames{};
+	std::array<std::array<game::PlayerInput, game::MAX_INPUT_NMB>, game::MAX_PLAYER_NMB> inputs{};
+};
+
+template <typename T, std::size_t N>
+sf::Packet& operator<<(sf::Packet& packet, const std::array<T, N>& array)
+{
+	for (const auto& value : array)
+	{
+		packet << value;
+	}
+	return packet;
+}
+
+template <typename T, std::size_t N>
+sf::Packet& operator>>(sf::Packet& packet, std::array<T, N>& array)
+{
+	for (auto& value : array)
+	{
+		packet >> value;
+	}
+	return packet;
+}
+
+sf::Packet& operator<<(sf::Packet& packet, const LegacyPlayerInputPacket& inputPacket)
+{
+	return packet << inputPacket.playerNumber << inputPacket.currentFrame << inputPacket.inputs;
+}
+
+sf::Packet& operator>>(sf::Packet& packet, LegacyPlayerInputPacket& inputPacket)
+{
+	return packet >> inputPacket.playerNumber >> inputPacket.currentFrame >> inputPacket.inputs;
+}
+
+sf::Packet& operator<<(sf::Packet& packet, const LegacyServerInputsPacket& serverPacket)
+{
+	return packet << serverPacket.validateFrame << serverPacket.physicsState << serverPacket.lastReceivedFrames <<
+		serverPacket.inputs;
+}
+
+sf::Packet& operator>>(sf::Packet& packet, LegacyServerInputsPacket& serverPacket)
+{
+	return packet >> serverPacket.validateFrame >> serverPacket.physicsState >> serverPacket.lastReceivedFrames >>
+		serverPacket.inputs;
+}
+
+/**
+ * \brief Inputs of a player holding a direction and shooting from time to time, like during a game.
+ */
+std::array<game::PlayerInput, game::MAX_INPUT_NMB> GenerateInputs()
+{
+	std::array<game::PlayerInput, game::MAX_INPUT_NMB> inputs{};
+	for (std::size_t i = 0; i < inputs.size(); i++)
+	{
+		inputs[i] = i % 20 < 3
+			            ? game::player_input_enum::Right | game::player_input_enum::Shoot
+			            : game::player_input_enum::Right;
+	}
+	return inputs;
+}
+
+constexpr game::Frame CURRENT_FRAME = 3000;
+constexpr std::uint8_t TICK_INPUT_COUNT = 3;
+
+template <typename T>
+void BenchLegacyPacket(benchmark::State& state, const T& sentPacket, const std::uint8_t packetType)
+{
+	sf::Packet packet;
+	for (auto _ : state)
+	{
+		packet.clear();
+		packet << packetType << sentPacket;
+
+		std::uint8_t receivedType = 0;
+		T receivedPacket{};
+		packet >> receivedType >> receivedPacket;
+		benchmark::DoNotOptimize(receivedPacket);
+	}
+	state.counters["bytes"] = static_cast<double>(packet.getDataSize());
+}
+
+void BenchBitStreamPacket(benchmark::State& state, const game::Packet& sentPacket)
+{
+	std::array<std::uint8_t, game::MAX_PACKET_SIZE> buffer{};
+	std::size_t size = 0;
+	for (auto _ : state)
+	{
+		size = game::WritePacket(buffer, sentPacket);
+		auto receivedPacket = game::ReadPacket(std::span(buffer.data(), size));
+		benchmark::DoNotOptimize(receivedPacket);
+	}
+	state.counters["bytes"] = static_cast<double>(size);
+}
+
+void BM_PlayerInputPacketLegacy(benchmark::State& state)
+{
+	LegacyPlayerInputPacket inputPacket{};
+	inputPacket.playerNumber = 1;
+	inputPacket.currentFrame = core::ConvertToBinary(CURRENT_FRAME);
+	inputPacket.inputs = GenerateInputs();
+	BenchLegacyPacket(state, inputPacket, static_cast<std::uint8_t>(game::PacketType::Input));
+}
+
+void BM_PlayerInputPacketBitStream(benchmark::State& state)
+{
+	game::PlayerInputPacket inputPacket{};
+	inputPacket.playerNumber = 1;
+	inputPacket.currentFrame = CURRENT_FRAME;
+	inputPacket.ackFrame = CURRENT_FRAME - TICK_INPUT_COUNT + 1;
+	inputPacket.inputCount = static_cast<std::uint8_t>(state.range(0));
+	inputPacket.inputs = GenerateInputs();
+	BenchBitStreamPacket(state, inputPacket);
+}
+
+void BM_ServerInputsPacketLegacy(benchmark::State& state)
+{
+	LegacyServerInputsPacket serverPacket{};
+	serverPacket.validateFrame = core::ConvertToBinary(CURRENT_FRAME - 5);
+	for (std::size_t playerNumber = 0; playerNumber < game::MAX_PLAYER_NMB; playerNumber++)
+	{
+		serverPacket.lastReceivedFrames[playerNumber] = core::ConvertToBinary(CURRENT_FRAME);
+		serverPacket.inputs[playerNumber] = GenerateInputs();
+	}
+	BenchLegacyPacket(state, serverPacket, static_cast<std::uint8_t>(game::PacketType::ServerInputs));
+}
+
+void BM_ServerInputsPacketBitStream(benchmark::State& state)
+{
+	game::ServerInputsPacket serverPacket{};
+	serverPacket.validateFrame = CURRENT_FRAME - 5;
+	serverPacket.physicsStates = {0x1234, 0xABCD};
+	for (std::size_t playerNumber = 0; playerNumber < game::MAX_PLAYER_NMB; playerNumber++)
+	{
+		serverPacket.lastReceivedFrames[playerNumber] = CURRENT_FRAME;
+		serverPacket.inputCounts[playerNumber] = static_cast<std::uint8_t>(state.range(0));
+		serverPacket.inputs[playerNumber] = GenerateInputs();
+	}
+	BenchBitStreamPacket(state, serverPacket);
+}
+}
+
+BENCHMARK(BM_PlayerInputPacketLegacy);
+BENCHMARK(BM_PlayerInputPacketBitStream)->ArgName("inputs")->Arg(TICK_INPUT_COUNT)->Arg(game::MAX_INPUT_NMB);
+BENCHMARK(BM_ServerInputsPacketLegacy);
+BENCHMARK(BM_ServerInputsPacketBitStream)->ArgName("inputs")->Arg(TICK_INPUT_COUNT)->Arg(game::MAX_INPUT_NMB);
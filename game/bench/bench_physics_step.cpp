@@ -0,0 +1,430 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include <random>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+#include <benchmark/benchmark.h>
+
+#include "game/game_globals.hpp"
+
+#include "physics/physics_manager.hpp"
+
+namespace
+{
+/**
+ * \brief Number of calls to the global operator new, used to count the allocations of a physics step.
+ */
+std::atomic<std::uint64_t> allocationCount{0};
+
+void* CountedAllocate(const std::size_t size)
+{
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+	if (void* pointer = std::malloc(size == 0 ? 1 : size)) return pointer;
+	throw std::bad_alloc();
+}
+
+void* CountedAllocate(const std::size_t size, const std::align_val_t alignment)
+{
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+	// aligned_alloc needs a size that is a multiple of the alignment
+	const auto alignmentValue = static_cast<std::size_t>(alignment);
+	const std::size_t alignedSize = (std::max<std::size_t>(size, 1) + alignmentValue - 1) / alignmentValue *
+		alignmentValue;
+#ifdef _MSC_VER
+	void* pointer = _aligned_malloc(alignedSize, alignmentValue);
+#else
+	void* pointer = std::aligned_alloc(alignmentValue, alignedSize);
+#endif
+	if (pointer != nullptr) return pointer;
+	throw std::bad_alloc();
+}
+
+void FreeAligned(void* pointer)
+{
+#ifdef _MSC_VER
+	_aligned_free(pointer);
+#else
+	std::free(pointer);
+#endif
+}
+}
+
+// Every form of new and delete is replaced, so that the allocations of the step are all counted
+// and each pointer is freed by the function matching the one that allocated it
+void* operator new(const std::size_t size)
+{
+	return CountedAllocate(size);
+}
+
+void* operator new[](const std::size_t size)
+{
+	return CountedAllocate(size);
+}
+
+void* operator new(const std::size_t size, const std::align_val_t alignment)
+{
+	return CountedAllocate(size, alignment);
+}
+
+void* operator new[](const std::size_t size, const std::align_val_t alignment)
+{
+	return CountedAllocate(size, alignment);
+}
+
+void operator delete(void* pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept
+{
+	FreeAligned(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t) noexcept
+{
+	FreeAligned(pointer);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept
+{
+	FreeAligned(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept
+{
+	FreeAligned(pointer);
+}
+
+namespace
+{
+enum class SceneType
+{
+	/**
+	 * \brief The walls of the level with the balls spread in it.
+	 */
+	Arena,
+
+	/**
+	 * \brief The balls packed together in the middle of the level, moving towards its center.
+	 */
+	DenseCluster,
+
+	/**
+	 * \brief The arena with walls and doors falling through it, like during a game.
+	 */
+	FallingWalls,
+};
+
+/**
+ * \brief A level built like RollbackManager does it, without the game and the network.
+ * The level is scaled up with the number of balls, so that the arena is never denser than 1000 balls in
+ * the level of the game.
+ */
+class PhysicsScene
+{
+public:
+	static constexpr std::size_t FALLING_WALL_NMB = 4;
+	static constexpr float FALLING_SPEED = 1.0f;
+	static constexpr float BALL_RADIUS = 0.25f;
+
+	PhysicsScene(const SceneType sceneType, const std::size_t ballCount)
+		: _scale(std::max(1.0f, std::sqrt(static_cast<float>(ballCount) / 1000.0f)))
+	{
+		CreateWall(game::WALL_LEFT_POS * _scale, game::VERTICAL_WALLS_SIZE);
+		CreateWall(game::WALL_RIGHT_POS * _scale, game::VERTICAL_WALLS_SIZE);
+		CreateWall(game::WALL_MIDDLE_POS * _scale, game::MIDDLE_WALL_SIZE, game::Layer::MiddleWall);
+		CreateWall(game::WALL_BOTTOM_POS * _scale, game::HORIZONTAL_WALLS_SIZE);
+		CreateWall(game::WALL_TOP_POS * _scale, game::HORIZONTAL_WALLS_SIZE);
+
+		_levelMin = {
+			(game::WALL_LEFT_POS.x + game::VERTICAL_WALLS_SIZE.x) * _scale,
+			(game::WALL_BOTTOM_POS.y + game::HORIZONTAL_WALLS_SIZE.y) * _scale
+		};
+		_levelMax = {
+			(game::WALL_RIGHT_POS.x - game::VERTICAL_WALLS_SIZE.x) * _scale,
+			(game::WALL_TOP_POS.y - game::HORIZONTAL_WALLS_SIZE.y) * _scale
+		};
+		physicsManager.SetWorldBounds(
+			{game::WALL_LEFT_POS.x * _scale - game::VERTICAL_WALLS_SIZE.x,
+			 game::WALL_BOTTOM_POS.y * _scale - game::HORIZONTAL_WALLS_SIZE.y},
+			{game::WALL_RIGHT_POS.x * _scale + game::VERTICAL_WALLS_SIZE.x,
+			 game::WALL_TOP_POS.y * _scale + game::HORIZONTAL_WALLS_SIZE.y});
+
+		std::mt19937 generator(42);
+		if (sceneType == SceneType::DenseCluster)
+		{
+			CreateCluster(ballCount);
+		}
+		else
+		{
+			std::uniform_real_distribution xDistribution(_levelMin.x, _levelMax.x);
+			std::uniform_real_distribution yDistribution(_levelMin.y, _levelMax.y);
+			std::uniform_real_distribution velocityDistribution(-game::BALL_SPEED, game::BALL_SPEED);
+			for (std::size_t i = 0; i < ballCount; i++)
+			{
+				CreateBall({xDistribution(generator), yDistribution(generator)},
+				           {velocityDistribution(generator), velocityDistribution(generator)});
+			}
+		}
+
+		if (sceneType == SceneType::FallingWalls)
+		{
+			std::uniform_real_distribution doorDistribution(_levelMin.x, _levelMax.x);
+			const float spacing = (_levelMax.y - _levelMin.y) / static_cast<float>(FALLING_WALL_NMB);
+			for (std::size_t i = 0; i < FALLING_WALL_NMB; i++)
+			{
+				const float height = _levelMax.y - spacing * static_cast<float>(i);
+				CreateFallingWall(height, doorDistribution(generator));
+			}
+		}
+	}
+
+	/**
+	 * \brief Moves the falling walls like the FallingObjectManager, and steps the physics.
+	 */
+	void FixedUpdate()
+	{
+		const sf::Time deltaTime = sf::seconds(game::FIXED_PERIOD);
+		for (const core::Entity entity : _fallingEntities)
+		{
+			game::Transform& transform = physicsManager.GetRigidbody(entity).Trans();
+			const float deltaFall = FALLING_SPEED * deltaTime.asSeconds();
+			transform.position = {transform.position.x, transform.position.y - deltaFall};
+
+			// Walls that went through the floor start again from the top
+			if (transform.position.y < _levelMin.y)
+			{
+				transform.position = {transform.position.x, _levelMax.y};
+			}
+		}
+
+		physicsManager.FixedUpdate(deltaTime);
+	}
+
+	[[nodiscard]] std::size_t BodyCount() const { return _bodyCount; }
+
+	core::EntityManager entityManager;
+	game::PhysicsManager physicsManager{entityManager};
+
+private:
+	void CreateWall(const core::Vec2f position, const core::Vec2f size, const game::Layer layer = game::Layer::Wall)
+	{
+		const core::Entity entity = entityManager.CreateEntity();
+
+		game::Rigidbody wallBody;
+		wallBody.SetPosition(position);
+		wallBody.SetTakesGravity(false);
+		wallBody.SetBodyType(game::BodyType::Static);
+		wallBody.SetMass(std::numeric_limits<float>::max());
+		wallBody.SetRestitution(1.0f);
+		wallBody.SetLayer(layer);
+
+		game::AabbCollider wallCollider;
+		wallCollider.halfHeight = size.y;
+		wallCollider.halfWidth = size.x;
+
+		_bodyCount++;
+		physicsManager.AddRigidbody(entity);
+		physicsManager.SetRigidbody(entity, wallBody);
+		physicsManager.AddAabbCollider(entity);
+		physicsManager.SetAabbCollider(entity, wallCollider);
+	}
+
+	void CreateBall(const core::Vec2f position, const core::Vec2f velocity)
+	{
+		const core::Entity entity = entityManager.CreateEntity();
+
+		game::Rigidbody ballBody;
+		ballBody.SetPosition(position);
+		ballBody.SetVelocity(velocity);
+		ballBody.Trans().scale = core::Vec2f::One() * game::BALL_SCALE;
+		ballBody.SetTakesGravity(false);
+		ballBody.SetBodyType(game::BodyType::Dynamic);
+		ballBody.SetLayer(game::Layer::Ball);
+
+		game::CircleCollider ballCircle;
+		ballCircle.radius = BALL_RADIUS;
+
+		_bodyCount++;
+		physicsManager.AddRigidbody(entity);
+		physicsManager.SetRigidbody(entity, ballBody);
+		physicsManager.AddCircleCollider(entity);
+		physicsManager.SetCircleCollider(entity, ballCircle);
+	}
+
+	/**
+	 * \brief Places the balls on a square lattice, each ball overlapping its neighbours.
+	 */
+	void CreateCluster(const std::size_t ballCount)
+	{
+		const auto side = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<float>(ballCount))));
+		const float spacing = 1.8f * BALL_RADIUS * game::BALL_SCALE;
+		const float offset = -spacing * static_cast<float>(side - 1) / 2.0f;
+
+		for (std::size_t i = 0; i < ballCount; i++)
+		{
+			const core::Vec2f position{
+				offset + spacing * static_cast<float>(i % side),
+				offset + spacing * static_cast<float>(i / side)
+			};
+			CreateBall(position, position * -0.5f);
+		}
+	}
+
+	void CreateFallingWall(const float height, const float doorPosition)
+	{
+		const core::Entity wall = entityManager.CreateEntity();
+
+		game::Rigidbody wallBody;
+		wallBody.SetPosition({0, height});
+		wallBody.SetBodyType(game::BodyType::Static);
+		wallBody.SetRestitution(0.0f);
+		wallBody.SetMass(100);
+		wallBody.SetLayer(game::Layer::Wall);
+
+		game::AabbCollider wallCollider;
+		wallCollider.halfWidth = game::FALLING_WALL_SIZE.x / 2.0f;
+		wallCollider.halfHeight = game::FALLING_WALL_SIZE.y / 2.0f;
+
+		_bodyCount++;
+		physicsManager.AddRigidbody(wall);
+		physicsManager.SetRigidbody(wall, wallBody);
+		physicsManager.AddAabbCollider(wall);
+		physicsManager.SetAabbCollider(wall, wallCollider);
+		_fallingEntities.push_back(wall);
+
+		const core::Entity door = entityManager.CreateEntity();
+
+		game::Rigidbody doorBody;
+		doorBody.SetPosition({doorPosition, height});
+		doorBody.SetBodyType(game::BodyType::Static);
+		doorBody.SetRestitution(0.0f);
+		doorBody.SetMass(10);
+		doorBody.SetLayer(game::Layer::Door);
+
+		game::AabbCollider doorCollider;
+		doorCollider.halfWidth = game::FALLING_WALL_DOOR_SIZE.x / 2.0f;
+		doorCollider.halfHeight = game::FALLING_WALL_DOOR_SIZE.y / 2.0f;
+
+		_bodyCount++;
+		physicsManager.AddRigidbody(door);
+		physicsManager.SetRigidbody(door, doorBody);
+		physicsManager.AddAabbCollider(door);
+		physicsManager.SetAabbCollider(door, doorCollider);
+		_fallingEntities.push_back(door);
+	}
+
+	float _scale;
+	core::Vec2f _levelMin;
+	core::Vec2f _levelMax;
+	std::vector<core::Entity> _fallingEntities;
+	std::size_t _bodyCount = 0;
+};
+
+/**
+ * \brief Steps run before the measure, 20 seconds of game.
+ * The falling walls need a few falls to pack the balls as tightly as they ever get, the capacities of the step
+ * have then reached the most contacts of the scene and a step must not allocate anymore.
+ */
+constexpr std::size_t WARM_UP_STEP_NMB = 1000;
+
+/**
+ * \brief Runs one physics step per iteration, and reports the time of every stage and the allocations per step.
+ * The counters are averaged over the iterations, the PhysicsBenchJson target writes them to a json file
+ * to follow them from a commit to the next.
+ */
+void BM_PhysicsStep(benchmark::State& state, const SceneType sceneType)
+{
+	PhysicsScene scene(sceneType, static_cast<std::size_t>(state.range(0)));
+
+	// The first steps fit the broad phase to the bodies, fill the contact cache and grow the capacities
+	for (std::size_t i = 0; i < WARM_UP_STEP_NMB; i++)
+	{
+		scene.FixedUpdate();
+	}
+
+	std::chrono::nanoseconds broadPhase{};
+	std::chrono::nanoseconds narrowPhase{};
+	std::chrono::nanoseconds solve{};
+	std::chrono::nanoseconds sleep{};
+	std::chrono::nanoseconds dispatchEvents{};
+	std::chrono::nanoseconds integrate{};
+	std::size_t pairCount = 0;
+	std::size_t contactCount = 0;
+	std::uint64_t allocations = 0;
+
+	for (auto _ : state)
+	{
+		const std::uint64_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+		scene.FixedUpdate();
+		allocations += allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+
+		const game::PhysicsStepStats& stats = scene.physicsManager.GetLastStepStats();
+		broadPhase += stats.broadPhase;
+		narrowPhase += stats.narrowPhase;
+		solve += stats.solve;
+		sleep += stats.sleep;
+		dispatchEvents += stats.dispatchEvents;
+		integrate += stats.integrate;
+		pairCount += stats.pairCount;
+		contactCount += stats.contactCount;
+	}
+
+	const auto averageMicroseconds = [](const std::chrono::nanoseconds total)
+	{
+		return benchmark::Counter(static_cast<double>(total.count()) / 1000.0, benchmark::Counter::kAvgIterations);
+	};
+
+	state.counters["bodies"] = static_cast<double>(scene.BodyCount());
+	state.counters["broad_phase_us"] = averageMicroseconds(broadPhase);
+	state.counters["narrow_phase_us"] = averageMicroseconds(narrowPhase);
+	state.counters["solve_us"] = averageMicroseconds(solve);
+	state.counters["sleep_us"] = averageMicroseconds(sleep);
+	state.counters["events_us"] = averageMicroseconds(dispatchEvents);
+	state.counters["integrate_us"] = averageMicroseconds(integrate);
+	state.counters["pairs"] = benchmark::Counter(static_cast<double>(pairCount), benchmark::Counter::kAvgIterations);
+	state.counters["contacts"] = benchmark::Counter(static_cast<double>(contactCount),
+	                                                benchmark::Counter::kAvgIterations);
+	state.counters["allocs_per_step"] = benchmark::Counter(static_cast<double>(allocations),
+	                                                       benchmark::Counter::kAvgIterations);
+
+	if (allocations > 0)
+	{
+		state.SkipWithError("The physics step allocated after the warm up");
+	}
+}
+}
+
+BENCHMARK_CAPTURE(BM_PhysicsStep, arena, SceneType::Arena)
+	->RangeMultiplier(10)->Range(10, 10000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_PhysicsStep, dense_cluster, SceneType::DenseCluster)
+	->RangeMultiplier(10)->Range(10, 10000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_PhysicsStep, falling_walls, SceneType::FallingWalls)
+	->RangeMultiplier(10)->Range(10, 10000)->Unit(benchmark::kMicrosecond);
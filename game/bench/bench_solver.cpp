@@ -0,0 +1,113 @@
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "physics/contact_cache.hpp"
+#include "physics/solver.hpp"
+
+#include "utils/thread_pool.hpp"
+
+namespace
+{
+/**
+ * \brief Bodies placed on a lattice, every body touching its right and top neighbours.
+ * A lattice of 50 by 51 bodies gives 4999 contacts.
+ */
+struct SolverScene
+{
+	static constexpr std::size_t WIDTH = 50;
+	static constexpr std::size_t HEIGHT = 51;
+
+	SolverScene()
+	{
+		std::mt19937 generator(42);
+		std::uniform_real_distribution velocityDistribution(-2.0f, 2.0f);
+
+		for (std::size_t y = 0; y < HEIGHT; y++)
+		{
+			for (std::size_t x = 0; x < WIDTH; x++)
+			{
+				const core::Entity entity = entityManager.CreateEntity();
+				entityManager.AddComponent(entity, static_cast<core::EntityMask>(core::ComponentType::Rigidbody));
+				rigidbodyManager.AddComponent(entity);
+
+				game::Rigidbody body;
+				body.SetBodyType(game::BodyType::Dynamic);
+				body.SetPosition({static_cast<float>(x), static_cast<float>(y)});
+				body.SetRestitution(0.5f);
+				body.SetStaticFriction(0.3f);
+				body.SetDynamicFriction(0.2f);
+				rigidbodyManager.SetComponent(entity, body);
+
+				startVelocities.emplace_back(velocityDistribution(generator), velocityDistribution(generator));
+			}
+		}
+
+		for (std::size_t y = 0; y < HEIGHT; y++)
+		{
+			for (std::size_t x = 0; x < WIDTH; x++)
+			{
+				const auto entity = static_cast<core::Entity>(y * WIDTH + x);
+				if (x + 1 < WIDTH)
+				{
+					collisions.emplace_back(entity, entity + 1, game::Manifold({1.0f, 0.0f}, 0.01f));
+				}
+				if (y + 1 < HEIGHT)
+				{
+					collisions.emplace_back(entity, static_cast<core::Entity>(entity + WIDTH),
+					                        game::Manifold({0.0f, 1.0f}, 0.01f));
+				}
+			}
+		}
+	}
+
+	void ResetVelocities()
+	{
+		for (core::Entity entity = 0; entity < startVelocities.size(); entity++)
+		{
+			rigidbodyManager.GetComponent(entity).SetVelocity(startVelocities[entity]);
+		}
+	}
+
+	core::EntityManager entityManager;
+	game::RigidbodyManager rigidbodyManager{entityManager};
+	game::ContactCache contactCache;
+	std::vector<core::Vec2f> startVelocities;
+	std::vector<game::Collision> collisions;
+};
+
+void BM_ImpulseSolver(benchmark::State& state)
+{
+	SolverScene scene;
+	core::ThreadPool threadPool(static_cast<std::size_t>(state.range(0)));
+
+	game::ImpulseSolver solver(scene.entityManager, scene.rigidbodyManager, scene.contactCache);
+	solver.SetThreadPool(&threadPool);
+
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		scene.ResetVelocities();
+		scene.contactCache.Clear();
+		state.ResumeTiming();
+
+		solver.Solve(scene.collisions, 1.0f / 50.0f);
+		benchmark::ClobberMemory();
+	}
+
+	// Must be the same for every number of threads
+	float checksum = 0.0f;
+	for (core::Entity entity = 0; entity < scene.startVelocities.size(); entity++)
+	{
+		const core::Vec2f velocity = scene.rigidbodyManager.GetComponent(entity).Velocity();
+		checksum += velocity.x * 1.3f + velocity.y * 0.7f;
+	}
+
+	state.counters["contacts"] = static_cast<double>(scene.collisions.size());
+	state.counters["checksum"] = checksum;
+	state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(scene.collisions.size()));
+}
+}
+
+BENCHMARK(BM_ImpulseSolver)->ArgName("threads")->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
@@ -22,7 +22,7 @@ public:
 		: ComponentManager(entityManager), _playerCharacterManager(playerCharacterManager)
 	{}
 
-	void OnCollision(core::Entity entity1, core::Entity entity2) override;
+	void OnCollision(std::span<const Collision> collisions) override;
 
 private:
 	void HandleCollision(core::Entity playerEntity) const;
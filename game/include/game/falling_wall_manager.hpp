@@ -62,7 +62,7 @@ public:
 	FallingDoorManager(core::EntityManager& entityManager, PlayerCharacterManager& playerCharacterManager,
 	                   GameManager& gameManager, ScoreManager& scoreManager);
 	void SetFallingDoor(core::Entity entity, FallingDoor fallingDoor);
-	void OnCollision(core::Entity entity1, core::Entity entity2) override;
+	void OnCollision(std::span<const Collision> collisions) override;
 
 private:
 	void HandleCollision(core::Entity doorEntity, core::Entity playerEntity);
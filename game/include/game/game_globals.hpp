@@ -61,6 +61,11 @@ constexpr std::size_t MAX_INPUT_NMB = 50;
  */
 constexpr float FIXED_PERIOD = 1.0f / 50.0f; //50fps
 
+/**
+ * \brief SERVER_TICK_PERIOD is the period used in seconds by the server to send the inputs of all the players to the clients
+ */
+constexpr float SERVER_TICK_PERIOD = FIXED_PERIOD;
+
 
 constexpr std::array PLAYER_COLORS
 {
@@ -161,4 +166,10 @@ enum PlayerInput : std::uint8_t
 	Shoot = 1u << 4u,
 };
 }
+
+/**
+ * \brief Number of bits used by a PlayerInput in the input packets.
+ */
+constexpr int PLAYER_INPUT_BITS = 5;
+static_assert(player_input_enum::Shoot < 1u << PLAYER_INPUT_BITS, "Every input flag must fit in PLAYER_INPUT_BITS");
 }
@@ -57,6 +57,7 @@ public:
 	void Validate(Frame newValidateFrame);
 	[[nodiscard]] bool CheckIfLost() const;
 	virtual void LoseGame();
+	[[nodiscard]] bool HasLost() const { return _hasLost; }
 
 protected:
 	core::EntityManager _entityManager;
@@ -83,6 +84,18 @@ public:
 
 	explicit ClientGameManager(PacketSenderInterface& packetSenderInterface);
 	void StartGame(unsigned long long int startingTime);
+
+	/**
+	 * \brief SetStartingTime moves the start of the game when the clock of the client has been synchronized more precisely.
+	 * \param startingTime is the time of the client when the first frame starts, in milliseconds since the epoch.
+	 */
+	void SetStartingTime(const unsigned long long startingTime) { _startingTime = startingTime; }
+
+	/**
+	 * \brief GetFrameAdvantage gives the number of frames the client is ahead of the frames expected since the starting time.
+	 * It is negative when the client is late.
+	 */
+	[[nodiscard]] long long GetFrameAdvantage() const;
 	void Begin() override;
 	void Update(sf::Time dt) override;
 	void End() override;
@@ -105,6 +118,17 @@ public:
 	std::pair<core::Entity, core::Entity> SpawnFallingWall(float doorPosition, bool requiresBall) override;
 	void FixedUpdate();
 	void SetPlayerInput(PlayerNumber playerNumber, PlayerInput playerInput, std::uint32_t inputFrame) override;
+
+	/**
+	 * \brief AcknowledgeInputs is called when the server echoes back the inputs of the client, they are not sent again.
+	 * \param ackFrame is the last frame of the inputs received by the server.
+	 */
+	void AcknowledgeInputs(Frame ackFrame);
+
+	/**
+	 * \brief GetInputAckFrame gives the last frame for which the client has received the inputs of all the other players.
+	 */
+	[[nodiscard]] Frame GetInputAckFrame() const;
 	void DrawImGui() override;
 	void ConfirmValidateFrame(Frame newValidateFrame, const std::array<PhysicsState, MAX_PLAYER_NMB>& physicsStates);
 	[[nodiscard]] PlayerNumber GetPlayerNumber() const { return _clientPlayer; }
@@ -118,8 +142,14 @@ protected:
 	core::SpriteManager _spriteManager;
 	core::RectangleShapeManager _rectangleShapeManager;
 	float _fixedTimer = 0.0f;
+
+	/**
+	 * \brief Number of frames the client can be ahead or late before its fixed timer is corrected.
+	 */
+	static constexpr long long MAX_FRAME_ADVANTAGE = 2;
 	unsigned long long _startingTime = 0;
 	std::uint32_t _state = 0;
+	Frame _sentInputAckFrame = 0;
 
 	sf::Texture _playerNoBallTexture;
 	sf::Texture _playerBallTexture;
@@ -95,8 +95,8 @@ public:
 	 */
 	void DestroyEntity(core::Entity entity);
 
-	void OnTrigger(core::Entity entity1, core::Entity entity2) override;
-	void OnCollision(core::Entity entity1, core::Entity entity2) override;
+	void OnTrigger(std::span<const Collision> triggers) override;
+	void OnCollision(std::span<const Collision> collisions) override;
 
 	[[nodiscard]] const std::array<PlayerInput, WINDOW_BUFFER_SIZE>& GetInputs(const PlayerNumber playerNumber) const
 	{
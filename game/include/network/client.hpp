@@ -1,5 +1,9 @@
 #pragma once
+#include <span>
+
+#include "clock_offset_estimator.hpp"
 #include "packet_type.hpp"
+#include "rtt_estimator.hpp"
 
 #include "game/game_manager.hpp"
 
@@ -27,24 +31,43 @@ public:
 	/**
 	 * \brief ReceiveNetPacket is a method called by an app owning a client when receiving a packet.
 	 * It is the same one for simulated and network client
-	 * \param packet A non-owning pointer to a packet (you don't need to care about deleting it
+	 * \param packet The received packet, it is only valid during the call
 	 */
-	virtual void ReceivePacket(const Packet* packet);
+	virtual void ReceivePacket(const Packet& packet);
 
 	void Update(sf::Time dt) override;
 protected:
+	/**
+	 * \brief ReceivePlayerInputs applies the inputs of a player sent by the server, or checks them if they are the inputs of this client.
+	 * \param playerNumber is the player of the inputs.
+	 * \param inputFrame is the last frame received by the server from the player.
+	 * \param inputs are the inputs of the player, inputs[i] being the input of the frame inputFrame - i.
+	 */
+	void ReceivePlayerInputs(PlayerNumber playerNumber, Frame inputFrame, std::span<const PlayerInput> inputs);
+
+	/**
+	 * \brief UpdateStartingTime converts the start time of the server to the clock of the client with the last clock offset.
+	 * It is called again for each ping, so the game follows the drift of the clocks.
+	 */
+	void UpdateStartingTime();
+
 	ClientGameManager _gameManager;
 	ClientId _clientId = INVALID_CLIENT_ID;
 	float _pingTimer = -1.0f;
 	float _currentPing = 0.0f;
 	static constexpr float PING_PERIOD_ = 0.3f;
 
-	float _srtt = -1.0f;
-	float _rttvar = 0.0f;
-	float _rto = 1.0f;
-	static constexpr float K = 4.0f;
-	static constexpr float G = 100.0f;
-	static constexpr float ALPHA = 1.0f / 8.0f;
-	static constexpr float BETA = 1.0f / 4.0f;
+	/**
+	 * \brief Period of the pings until the clocks are synchronized, the samples are then taken quickly after the join.
+	 */
+	static constexpr float SYNCHRONIZATION_PING_PERIOD_ = 0.05f;
+
+	RttEstimator _rttEstimator;
+	ClockOffsetEstimator _clockOffsetEstimator;
+
+	/**
+	 * \brief Time of the server when the game starts, 0 until the StartGamePacket is received.
+	 */
+	std::uint64_t _serverStartingTime = 0;
 };
 }
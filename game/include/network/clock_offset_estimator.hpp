@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace game
+{
+/**
+ * \brief Time of the system clock in milliseconds since the epoch, the one used by the clients and the server to start a game.
+ */
+[[nodiscard]] std::uint64_t GetSystemTime();
+
+/**
+ * \brief ClockOffsetEstimator gives the offset between the clock of the server and the one of the client, as NTP does.
+ * Each ping gives a sample, the server time is assumed to be read halfway through the round trip,
+ * so a sample is only as precise as its round trip is short.
+ * Only the samples close to the shortest round trip of the window are used to give the offset.
+ * The best sample of each window is kept longer, a line fitted through them gives how fast the offset drifts.
+ * The times are in milliseconds since the epoch.
+ */
+class ClockOffsetEstimator
+{
+public:
+	/**
+	 * \brief Number of the last samples that are kept.
+	 */
+	static constexpr std::size_t SAMPLE_COUNT = 32;
+
+	/**
+	 * \brief Number of samples needed before the offset is precise enough to start a game.
+	 */
+	static constexpr std::size_t MIN_SAMPLE_COUNT = 8;
+
+	/**
+	 * \brief A sample is used if its round trip is at most this much longer than the shortest one, in milliseconds.
+	 */
+	static constexpr double RTT_TOLERANCE = 2.0;
+
+	/**
+	 * \brief Number of the last windows whose best sample is kept to measure the drift.
+	 */
+	static constexpr std::size_t DRIFT_POINT_COUNT = 8;
+
+	/**
+	 * \brief Time between the first and the last points needed to measure the drift, in milliseconds.
+	 * The drift of a clock is too small to be told from the noise of the samples over a few seconds.
+	 */
+	static constexpr double MIN_DRIFT_SPAN = 20000.0;
+
+	/**
+	 * \brief The clocks of computers drift by less than this, a steeper line comes from the noise of the samples.
+	 */
+	static constexpr double MAX_DRIFT = 0.0005;
+
+	/**
+	 * \brief Adds the sample of a ping.
+	 * \param clientSendTime Time of the client when it sent the ping.
+	 * \param serverTime Time of the server when it sent the ping back.
+	 * \param clientReceiveTime Time of the client when it received the ping back.
+	 */
+	void AddSample(std::uint64_t clientSendTime, std::uint64_t serverTime, std::uint64_t clientReceiveTime);
+
+	[[nodiscard]] bool HasSample() const { return _sampleCount > 0; }
+	[[nodiscard]] bool IsSynchronized() const { return _sampleCount >= MIN_SAMPLE_COUNT; }
+	[[nodiscard]] std::size_t GetSampleCount() const { return _sampleCount; }
+
+	/**
+	 * \brief Gives the time to add to a time of the client to get the time of the server at the same moment.
+	 */
+	[[nodiscard]] double GetOffset(std::uint64_t clientTime) const;
+
+	/**
+	 * \brief Gives the milliseconds gained by the clock of the server for each millisecond of the client.
+	 */
+	[[nodiscard]] double GetDrift() const { return _drift; }
+
+	[[nodiscard]] double GetMinRtt() const { return _minRtt; }
+
+	/**
+	 * \brief Converts a time of the server to the time of the client at the same moment.
+	 */
+	[[nodiscard]] std::uint64_t ToClientTime(std::uint64_t serverTime) const;
+
+private:
+	struct Sample
+	{
+		double clientTime = 0.0;
+		double offset = 0.0;
+		double rtt = 0.0;
+	};
+
+	void FitSamples();
+	void FitDrift();
+
+	std::array<Sample, SAMPLE_COUNT> _samples{};
+	std::size_t _sampleCount = 0;
+
+	std::array<Sample, DRIFT_POINT_COUNT> _driftPoints{};
+	std::size_t _driftPointCount = 0;
+
+	double _referenceTime = 0.0;
+	double _offset = 0.0;
+	double _drift = 0.0;
+	double _minRtt = 0.0;
+};
+}
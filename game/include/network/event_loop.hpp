@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include <SFML/Network/Socket.hpp>
+#include <SFML/Network/SocketSelector.hpp>
+#include <SFML/System/Clock.hpp>
+#include <SFML/System/Time.hpp>
+
+namespace game
+{
+/**
+ * \brief EventLoop waits until one of its sockets can be read or its tick timer expires, so a server sleeps while it has nothing to do.
+ * On Linux it is an epoll instance with a timerfd for the ticks,
+ * on the other platforms it is a sf::SocketSelector waiting until the next tick.
+ */
+class EventLoop
+{
+public:
+	EventLoop();
+	~EventLoop();
+
+	EventLoop(const EventLoop& other) = delete;
+	EventLoop(EventLoop&& other) = delete;
+	EventLoop& operator=(const EventLoop& other) = delete;
+	EventLoop& operator=(EventLoop&& other) = delete;
+
+	/**
+	 * \brief Wakes the loop when the socket has data to read, or a connection to accept for a listener.
+	 * The socket must stay alive until it is removed or the loop is destroyed.
+	 */
+	void AddSocket(sf::Socket& socket);
+	void RemoveSocket(sf::Socket& socket);
+
+	/**
+	 * \brief Also wakes the loop when the socket can be written, while bytes wait to be sent on it.
+	 * The other platforms do not wait for it, the bytes are sent at the next tick.
+	 */
+	void SetWriteInterest(sf::Socket& socket, bool isInterested);
+
+	/**
+	 * \brief Starts the tick timer, that wakes the loop at a fixed period.
+	 * A zero period stops it, the loop then only wakes for the sockets.
+	 */
+	void SetTickPeriod(sf::Time period);
+
+	/**
+	 * \brief Blocks until a socket can be read or the tick timer expires.
+	 * \return the number of ticks that have expired since the previous call, more than one if the caller is late.
+	 */
+	std::uint64_t Wait();
+
+	/**
+	 * \brief Tells if the socket had data to read when the last Wait returned.
+	 * A server with many sockets only reads the ones that are ready.
+	 */
+	[[nodiscard]] bool IsReady(sf::Socket& socket) const;
+
+private:
+	#ifdef __linux__
+	static constexpr std::size_t MAX_EVENT_COUNT = 64;
+
+	int _epollFd = -1;
+	int _timerFd = -1;
+
+	/**
+	 * \brief Handles of the sockets that were ready, the others are given by the next Wait.
+	 */
+	std::array<int, MAX_EVENT_COUNT> _readyHandles{};
+	std::size_t _readyCount = 0;
+	#else
+	sf::SocketSelector _selector;
+	sf::Clock _clock;
+	std::int64_t _tickPeriodMicroseconds = 0;
+	std::int64_t _tickElapsedMicroseconds = 0;
+	#endif
+};
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "server.hpp"
+
+namespace game
+{
+/**
+ * \brief Match is one game hosted by a MatchServer, with its own game state.
+ * It does not own any socket: the MatchServer gives it the packets of its clients and sends the packets it produces,
+ * so the matches of a server can run in parallel.
+ */
+class Match final : public Server
+{
+public:
+	/**
+	 * \brief OutgoingPacket is a packet sent by the match to all its clients.
+	 */
+	struct OutgoingPacket
+	{
+		Packet packet;
+		bool isReliable = false;
+	};
+
+	void SendReliablePacket(const Packet& packet) override;
+	void SendUnreliablePacket(const Packet& packet) override;
+
+	void Begin() override;
+
+	/**
+	 * \brief Processes the received packets and sends a ServerInputsPacket if a server tick has expired.
+	 * It only uses the state of the match and is called on any worker thread.
+	 */
+	void Update(sf::Time dt) override;
+
+	void End() override;
+
+	/**
+	 * \brief Queues a packet received from one of the clients, it is processed by the next Update.
+	 */
+	void PushReceivedPacket(const Packet& packet);
+
+	void AddPendingTicks(std::uint64_t tickCount) { _pendingTickCount += tickCount; }
+
+	[[nodiscard]] std::span<const OutgoingPacket> GetOutgoingPackets() const { return _outgoingPackets; }
+	void ClearOutgoingPackets() { _outgoingPackets.clear(); }
+
+	/**
+	 * \brief Number of clients that have joined the match, they are its player numbers.
+	 */
+	[[nodiscard]] PlayerNumber GetPlayerCount() const { return _lastPlayerNumber; }
+	[[nodiscard]] bool IsFull() const { return _lastPlayerNumber == MAX_PLAYER_NMB; }
+	[[nodiscard]] bool HasEnded() const { return _gameManager.HasLost(); }
+
+protected:
+	void SpawnNewPlayer(ClientId clientId, PlayerNumber newPlayerNumber) override;
+
+private:
+	std::vector<Packet> _receivedPackets;
+	std::vector<OutgoingPacket> _outgoingPackets;
+	std::uint64_t _pendingTickCount = 0;
+};
+}
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include <SFML/Network/IpAddress.hpp>
+#include <SFML/Network/TcpListener.hpp>
+#include <SFML/Network/TcpSocket.hpp>
+
+#include "event_loop.hpp"
+#include "match.hpp"
+#include "reliable_channel.hpp"
+#include "rtt_estimator.hpp"
+#include "tcp_stream.hpp"
+#include "udp_batch_socket.hpp"
+
+#include "engine/system.hpp"
+
+#include "utils/work_stealing_scheduler.hpp"
+
+namespace game
+{
+/**
+ * \brief MatchServer hosts many matches on one TCP and UDP port pair.
+ * The clients are put in the open match when they join, a new match is opened once it is full.
+ * A client joins with TCP or with its first UDP join, the reliable packets are then sent on a ReliableChannel over UDP.
+ * The network is handled by the thread calling Update, the matches are updated in parallel on a WorkStealingScheduler.
+ */
+class MatchServer final : public core::SystemInterface
+{
+public:
+	/**
+	 * \param threadCount Number of threads updating the matches, one per core when it is 0.
+	 */
+	explicit MatchServer(std::size_t threadCount = 0);
+
+	void Begin() override;
+
+	/**
+	 * \brief Blocks until a socket has data to read or the next server tick, it is called before each Update.
+	 */
+	void WaitForEvents();
+
+	void Update(sf::Time dt) override;
+
+	void End() override;
+
+	void SetTcpPort(unsigned short port);
+
+	[[nodiscard]] bool IsOpen() const { return _isOpen; }
+
+	[[nodiscard]] std::size_t GetMatchCount() const { return _matches.size(); }
+
+private:
+	static constexpr std::size_t NO_MATCH = static_cast<std::size_t>(-1);
+
+	/**
+	 * \brief Time without any datagram after which a client that has joined on UDP is disconnected, in milliseconds.
+	 * The clients that do not use TCP can only be seen leaving this way.
+	 */
+	static constexpr std::uint64_t CLIENT_TIMEOUT = 5000;
+
+	/**
+	 * \brief Number of retransmission timeouts during which the connections of a closed match are kept,
+	 * for their last reliable messages to be acknowledged. The timeout doubles with each retransmission,
+	 * the messages are then sent up to four times.
+	 */
+	static constexpr float CLOSING_TIMEOUT_RTO_COUNT = 7.0f;
+
+	/**
+	 * \brief Connection is a client, with its TCP socket if it joined with TCP, and its UDP address once it has joined on it.
+	 * The reliable packets are sent on its reliable channel once its UDP address is known.
+	 * When its match is closed, it is kept while the last reliable messages wait for their acknowledgement.
+	 */
+	struct Connection
+	{
+		sf::TcpSocket socket;
+		TcpPacketReceiver receiver;
+		TcpPacketSender sender;
+		ReliableChannel reliableChannel;
+		RttEstimator rttEstimator;
+		ClientId clientId = INVALID_CLIENT_ID;
+		std::size_t matchId = NO_MATCH;
+		PlayerNumber playerNumber = INVALID_PLAYER;
+		sf::IpAddress udpAddress;
+		unsigned short udpPort = 0;
+		std::uint64_t lastReceiveTime = 0;
+		std::uint64_t closeTime = 0;
+		bool isUsingTcp = true;
+		bool isDisconnected = false;
+		bool isClosing = false;
+	};
+
+	struct MatchSlot
+	{
+		std::unique_ptr<Match> match;
+		std::array<Connection*, MAX_PLAYER_NMB> connections{};
+		bool hasWork = false;
+		bool isAbandoned = false;
+	};
+
+	void AcceptConnections();
+	void ReceiveTcpPackets();
+	void ReceiveUdpPackets();
+
+	void ReceiveTcpPacket(Connection& connection, const Packet& packet);
+	void ReceiveUdpPacket(const Datagram& datagram, const Packet& packet);
+
+	/**
+	 * \brief Puts a client in the open match, a new one is opened if there is none.
+	 */
+	void JoinMatch(Connection& connection, const JoinPacket& joinPacket);
+
+	void UpdateMatches();
+	void SendMatchPackets(MatchSlot& matchSlot);
+
+	/**
+	 * \brief Closes the matches that have ended or lost a player.
+	 * Their connections are removed once their reliable messages are acknowledged, or after CLOSING_TIMEOUT_RTO_COUNT
+	 * retransmission timeouts.
+	 */
+	void RemoveEndedMatches();
+
+	/**
+	 * \brief The other players of the match lose, as when the single match server loses a player.
+	 */
+	void DisconnectClient(Connection& connection);
+
+	void SendTcpPacket(Connection& connection, const Packet& packet);
+
+	/**
+	 * \brief Queues a packet on the reliable channel of a client, which is disconnected if it acknowledges too few of them.
+	 */
+	void SendReliablePacket(Connection& connection, const Packet& packet);
+
+	/**
+	 * \brief Sends the new reliable packets and the ones that have not been acknowledged in time.
+	 */
+	void FlushReliableChannels();
+
+	void DisconnectSilentClients();
+
+	/**
+	 * \brief Runs the tick timer only while a match is open or closing, an idle server then sleeps until a client joins.
+	 */
+	void UpdateTickTimer();
+
+	/**
+	 * \brief Sends a frame without waiting for the client, which is disconnected if its queue is full.
+	 */
+	void QueueTcpFrame(Connection& connection, std::span<const std::uint8_t> frame);
+
+	/**
+	 * \brief Sends the bytes that wait in the TCP queues, and waits for the sockets that are still full.
+	 */
+	void FlushTcpSends();
+
+	[[nodiscard]] static std::uint64_t GetEndpointKey(const sf::IpAddress& address, unsigned short port);
+
+	core::WorkStealingScheduler _scheduler;
+	EventLoop _eventLoop;
+
+	sf::TcpListener _tcpListener;
+	UdpBatchSocket _udpSocket;
+	unsigned short _tcpPort = 12345;
+	unsigned short _udpPort = 12345;
+
+	std::vector<std::unique_ptr<Connection>> _connections;
+
+	/**
+	 * \brief Connection given to the next accept, it is kept when there is nothing to accept.
+	 */
+	std::unique_ptr<Connection> _nextConnection;
+	std::unordered_map<std::size_t, MatchSlot> _matches;
+	std::vector<std::size_t> _updatedMatchIds;
+
+	/**
+	 * \brief Connections of the clients that have joined on UDP, by address and port.
+	 */
+	std::unordered_map<std::uint64_t, Connection*> _udpConnections;
+
+	std::size_t _nextMatchId = 0;
+	std::size_t _openMatchId = NO_MATCH;
+	std::uint64_t _pendingTickCount = 0;
+	bool _isTicking = false;
+	bool _isOpen = false;
+
+	std::array<std::uint8_t, MAX_TCP_FRAME_SIZE> _sendingBuffer{};
+};
+}
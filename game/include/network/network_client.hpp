@@ -4,6 +4,8 @@
 #include <SFML/Network/UdpSocket.hpp>
 
 #include "client.hpp"
+#include "reliable_channel.hpp"
+#include "tcp_stream.hpp"
 
 #ifdef ENABLE_SQLITE
 #include "network/debug_db.hpp"
@@ -42,21 +44,40 @@ public:
 
 	void Draw(sf::RenderTarget& renderTarget) override;
 
-	void SendReliablePacket(std::unique_ptr<Packet> packet) override;
+	void SendReliablePacket(const Packet& packet) override;
 
-	void SendUnreliablePacket(std::unique_ptr<Packet> packet) override;
+	void SendUnreliablePacket(const Packet& packet) override;
 	void SetPlayerInput(PlayerInput playerInput);
 
-	void ReceivePacket(const Packet* packet) override;
+	void ReceivePacket(const Packet& packet) override;
 private:
-	void ReceiveNetPacket(sf::Packet& packet, PacketSource source);
+	void ReceiveNetPacket(const Packet& packet, PacketSource source);
 	sf::UdpSocket _udpSocket;
 	sf::TcpSocket _tcpSocket;
+	TcpPacketReceiver _tcpReceiver;
+
+	/**
+	 * \brief Channel of the reliable packets of the server, they do not wait behind a lost TCP segment.
+	 */
+	ReliableChannel _reliableChannel;
+
+	/**
+	 * \brief Joins with a TCP connection, otherwise the join is sent on UDP to the port of the server until it is acknowledged.
+	 */
+	bool _isUsingTcp = false;
 
 	std::string _serverAddress = "localhost";
 	unsigned short _serverTcpPort = 12345;
 	unsigned short _serverUdpPort = 0;
 
+	/**
+	 * \brief Address of the server resolved when connecting, so the UDP sends do not resolve _serverAddress each time.
+	 */
+	sf::IpAddress _serverIpAddress;
+
+	std::array<std::uint8_t, MAX_TCP_FRAME_SIZE> _sendingBuffer{};
+	std::array<std::uint8_t, MAX_PACKET_SIZE> _receivedBuffer{};
+
 
 	State _currentState = State::None;
 
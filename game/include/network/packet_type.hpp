@@ -1,13 +1,17 @@
-// ReSharper disable CppClangTidyCppcoreguidelinesProTypeStaticCastDowncast
 #pragma once
 
-#include <chrono>
-#include <memory>
-
-#include <SFML/Network/Packet.hpp>
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <variant>
 
 #include "game/game_globals.hpp"
 
+#include "utils/bit_stream.hpp"
+
 namespace game
 {
 enum class PacketType : std::uint8_t
@@ -16,12 +20,13 @@ enum class PacketType : std::uint8_t
 	SpawnPlayer,
 	Input,
 	SpawnBall,
-	ValidateState,
+	ServerInputs,
 	StartGame,
 	JoinAck,
 	LoseGame,
 	Ping,
 	SpawnFallingWall,
+	Reliable,
 	None,
 };
 
@@ -31,186 +36,320 @@ enum class PacketType : std::uint8_t
 using PhysicsState = std::uint16_t;
 
 /**
- * \brief Packet is a interface that defines what a packet with a PacketType.
+ * \brief TypedPacket is a template base class that gives the PacketType of a packet struct at compile time.
+ * \tparam Type is the PacketType of the packet
  */
-struct Packet
+template <PacketType Type>
+struct TypedPacket
 {
-	virtual ~Packet() = default;
-	PacketType packetType = PacketType::None;
+	static constexpr PacketType PACKET_TYPE = Type;
 };
 
-inline sf::Packet& operator<<(sf::Packet& packetReceived, Packet& packet)
+/**
+ * \brief Sizes of the fields of the packets on the network.
+ * The frames grow with the game and are sent as variable size numbers, the other numbers are small most of the time.
+ */
+constexpr int PACKET_TYPE_BITS = static_cast<int>(std::bit_width(static_cast<unsigned>(PacketType::None)));
+constexpr int PLAYER_NUMBER_BITS = static_cast<int>(std::bit_width(MAX_PLAYER_NMB - 1));
+constexpr int CLIENT_ID_BITS = std::numeric_limits<std::underlying_type_t<ClientId>>::digits;
+constexpr int PHYSICS_STATE_BITS = std::numeric_limits<PhysicsState>::digits;
+constexpr int FRAME_GROUP_BITS = 7;
+constexpr int SMALL_GROUP_BITS = 4;
+
+/**
+ * \brief Serializes a frame relative to a frame that is close to it, most of the time in less than a byte.
+ */
+template <typename Stream>
+void SerializeFrameDelta(Stream& stream, core::StreamData<Stream, Frame>& frame, const Frame baseFrame)
 {
-	const auto packetType = static_cast<std::uint8_t>(packet.packetType);
-	packetReceived << packetType;
-	return packetReceived;
+	if constexpr (Stream::IS_WRITING)
+	{
+		stream.WriteVarUint(core::ZigZagEncode(static_cast<std::int64_t>(frame) - baseFrame), SMALL_GROUP_BITS);
+	}
+	else
+	{
+		frame = static_cast<Frame>(baseFrame + core::ZigZagDecode(stream.ReadVarUint(SMALL_GROUP_BITS)));
+	}
 }
 
-inline sf::Packet& operator>>(sf::Packet& packetReceived, Packet& packet)
+template <typename Stream>
+void SerializeVec2f(Stream& stream, core::StreamData<Stream, core::Vec2f>& vec)
 {
-	std::uint8_t packetType;
-	packetReceived >> packetType;
-	packet.packetType = static_cast<PacketType>(packetType);
-	return packetReceived;
+	stream.SerializeFloat(vec.x);
+	stream.SerializeFloat(vec.y);
+}
+
+template <typename Stream>
+void SerializeDegree(Stream& stream, core::StreamData<Stream, core::Degree>& angle)
+{
+	if constexpr (Stream::IS_WRITING)
+	{
+		stream.SerializeFloat(angle.Value());
+	}
+	else
+	{
+		float value = 0.0f;
+		stream.SerializeFloat(value);
+		angle = value;
+	}
 }
 
 /**
- * \brief TypedPacket is a template class that sets the packetType of Packet automatically at construction with the given type.
- * \tparam Type is the PacketType of the packet
+ * \brief Writes the inputs of a player as runs of the same input, each one being the input followed by its length.
  */
-template <PacketType Type>
-struct TypedPacket : Packet
+inline void WriteInputRuns(core::BitWriter& writer, const std::span<const PlayerInput> inputs)
 {
-	TypedPacket() { packetType = Type; }
-};
+	std::size_t runCount = 0;
+	for (std::size_t i = 0; i < inputs.size(); i++)
+	{
+		if (i == 0 || inputs[i] != inputs[i - 1]) runCount++;
+	}
+	writer.WriteVarUint(runCount, SMALL_GROUP_BITS);
 
-template <typename T, size_t N>
-sf::Packet& operator<<(sf::Packet& packet, const std::array<T, N>& t)
+	std::size_t runStart = 0;
+	for (std::size_t i = 1; i <= inputs.size(); i++)
+	{
+		if (i < inputs.size() && inputs[i] == inputs[runStart]) continue;
+
+		writer.WriteBits(inputs[runStart], PLAYER_INPUT_BITS);
+		writer.WriteVarUint(i - runStart - 1, SMALL_GROUP_BITS);
+		runStart = i;
+	}
+}
+
+/**
+ * \brief Reads the inputs written by WriteInputRuns.
+ * \return the number of inputs read, the runs that do not fit in inputs are cut.
+ */
+inline std::uint8_t ReadInputRuns(core::BitReader& reader, std::array<PlayerInput, MAX_INPUT_NMB>& inputs)
 {
-	for (auto& tmp : t)
+	const auto runCount = reader.ReadVarUint(SMALL_GROUP_BITS);
+
+	std::size_t inputCount = 0;
+	for (std::uint64_t run = 0; run < runCount && inputCount < MAX_INPUT_NMB; run++)
 	{
-		packet << tmp;
+		const auto input = static_cast<PlayerInput>(reader.ReadBits(PLAYER_INPUT_BITS));
+		const auto runLength = reader.ReadVarUint(SMALL_GROUP_BITS) + 1;
+		for (std::uint64_t i = 0; i < runLength && inputCount < MAX_INPUT_NMB; i++)
+		{
+			inputs[inputCount] = input;
+			inputCount++;
+		}
 	}
-	return packet;
+	return static_cast<std::uint8_t>(inputCount);
 }
 
-template <typename T, size_t N>
-sf::Packet& operator>>(sf::Packet& packet, std::array<T, N>& t)
+template <typename Stream>
+void SerializeInputRuns(Stream& stream, core::StreamData<Stream, std::uint8_t>& inputCount,
+                        core::StreamData<Stream, std::array<PlayerInput, MAX_INPUT_NMB>>& inputs)
 {
-	for (auto& tmp : t)
+	if constexpr (Stream::IS_WRITING)
 	{
-		packet >> tmp;
+		WriteInputRuns(stream, std::span(inputs.data(), std::min<std::size_t>(inputCount, MAX_INPUT_NMB)));
+	}
+	else
+	{
+		inputCount = ReadInputRuns(stream, inputs);
 	}
-	return packet;
 }
 
 /**
- * \brief JoinPacket is a TCP Packet that is sent by a client to the server to join a game.
+ * \brief ReliableAck acknowledges the reliable messages received from a peer.
+ * The sequence is the newest one received, bit i of bits tells if the sequence - 1 - i has been received.
  */
-struct JoinPacket final : TypedPacket<PacketType::Join>
+struct ReliableAck
 {
-	std::array<std::uint8_t, sizeof(ClientId)> clientId{};
-	std::array<std::uint8_t, sizeof(unsigned long)> startTime{};
+	std::uint16_t sequence = 0;
+	std::uint32_t bits = 0;
 };
 
-inline sf::Packet& operator<<(sf::Packet& packet, const JoinPacket& joinPacket)
+template <typename Stream>
+void Serialize(Stream& stream, core::StreamData<Stream, ReliableAck>& ack)
 {
-	return packet << joinPacket.clientId << joinPacket.startTime;
+	stream.SerializeBits(ack.sequence, 16);
+	stream.SerializeBits(ack.bits, 32);
 }
 
-inline sf::Packet& operator>>(sf::Packet& packet, JoinPacket& joinPacket)
+/**
+ * \brief Serializes an acknowledgement that is only sent for a few packets after a reliable message is received.
+ */
+template <typename Stream>
+void SerializeOptionalAck(Stream& stream, core::StreamData<Stream, bool>& hasAck,
+                          core::StreamData<Stream, ReliableAck>& ack)
 {
-	return packet >> joinPacket.clientId >> joinPacket.startTime;
+	stream.SerializeBits(hasAck, 1);
+	if (hasAck)
+	{
+		Serialize(stream, ack);
+	}
 }
 
 /**
- * \brief JoinAckPacket is a TCP Packet that is sent by the server to the client to answer a join packet
+ * \brief JoinPacket is a Packet that is sent by a client to the server to join a game, on TCP or on UDP until it is acknowledged.
  */
-struct JoinAckPacket final : TypedPacket<PacketType::JoinAck>
+struct JoinPacket final : TypedPacket<PacketType::Join>
 {
-	std::array<std::uint8_t, sizeof(ClientId)> clientId{};
-	std::array<std::uint8_t, sizeof(unsigned short)> udpPort{};
+	ClientId clientId = INVALID_CLIENT_ID;
 };
 
-
-inline sf::Packet& operator<<(sf::Packet& packet, const JoinAckPacket& spawnPlayerPacket)
+template <typename Stream>
+void Serialize(Stream& stream, core::StreamData<Stream, JoinPacket>& packet)
 {
-	return packet << spawnPlayerPacket.clientId << spawnPlayerPacket.udpPort;
+	stream.SerializeBits(packet.clientId, CLIENT_ID_BITS);
 }
 
-inline sf::Packet& operator>>(sf::Packet& packet, JoinAckPacket& joinPacket)
+/**
+ * \brief JoinAckPacket is a Packet that is sent by the server to the client to answer a join packet, on the socket of the join
+ */
+struct JoinAckPacket final : TypedPacket<PacketType::JoinAck>
 {
-	return packet >> joinPacket.clientId >> joinPacket.udpPort;
+	ClientId clientId = INVALID_CLIENT_ID;
+	std::uint16_t udpPort = 0;
+};
+
+template <typename Stream>
+void Serialize(Stream& stream, core::StreamData<Stream, JoinAckPacket>& packet)
+{
+	stream.SerializeBits(packet.clientId, CLIENT_ID_BITS);
+	stream.SerializeBits(packet.udpPort, 16);
 }
 
 /**
- * \brief SpawnPlayerPacket is a TCP Packet sent by the server to all clients to notify of the spawn of a new player
+ * \brief SpawnPlayerPacket is a reliable Packet sent by the server to all clients to notify of the spawn of a new player
  */
 struct SpawnPlayerPacket final : TypedPacket<PacketType::SpawnPlayer>
 {
-	std::array<std::uint8_t, sizeof(ClientId)> clientId{};
+	ClientId clientId = INVALID_CLIENT_ID;
 	PlayerNumber playerNumber = INVALID_PLAYER;
-	std::array<std::uint8_t, sizeof(core::Vec2f)> pos{};
-	std::array<std::uint8_t, sizeof(core::Degree)> angle{};
+	core::Vec2f pos{};
+	core::Degree angle{};
 };
 
-inline sf::Packet& operator<<(sf::Packet& packet, const SpawnPlayerPacket& spawnPlayerPacket)
-{
-	return packet << spawnPlayerPacket.clientId << spawnPlayerPacket.playerNumber <<
-		spawnPlayerPacket.pos << spawnPlayerPacket.angle;
-}
-
-inline sf::Packet& operator>>(sf::Packet& packet, SpawnPlayerPacket& spawnPlayerPacket)
+template <typename Stream>
+void Serialize(Stream& stream, core::StreamData<Stream, SpawnPlayerPacket>& packet)
 {
-	return packet >> spawnPlayerPacket.clientId >> spawnPlayerPacket.playerNumber >>
-		spawnPlayerPacket.pos >> spawnPlayerPacket.angle;
+	stream.SerializeBits(packet.clientId, CLIENT_ID_BITS);
+	stream.SerializeBits(packet.playerNumber, PLAYER_NUMBER_BITS);
+	SerializeVec2f(stream, packet.pos);
+	SerializeDegree(stream, packet.angle);
 }
 
 /**
- * \brief PlayerInputPacket is a UDP Packet sent by the player client and then replicated by the server to all clients to share the currentFrame
- * and all the previous ones player inputs.
+ * \brief PlayerInputPacket is a UDP Packet sent by the player client to the server to share the currentFrame
+ * and the previous player inputs that the server has not acknowledged yet.
+ *
+ * The client sends its inputs since the last frame that the server acknowledged in a ServerInputsPacket, and the server replicates
+ * them since the oldest ackFrame of the other clients. The number of inputs repeated in each packet follows the measured loss:
+ * it grows while the packets or their acknowledgements are lost and goes back to the round trip once they get through.
+ * On the network the inputs are run-length encoded and bit-packed, a few bytes are enough for a tick.
  */
 struct PlayerInputPacket final : TypedPacket<PacketType::Input>
 {
 	PlayerNumber playerNumber = INVALID_PLAYER;
-	std::array<std::uint8_t, sizeof(Frame)> currentFrame{};
-	std::array<std::uint8_t, MAX_INPUT_NMB> inputs{};
+	Frame currentFrame = 0;
+
+	/**
+	 * \brief Last frame for which the client has received the inputs of all the other players. Only filled by the clients.
+	 */
+	Frame ackFrame = 0;
+
+	/**
+	 * \brief Number of inputs in the packet, inputs[i] being the input of the frame currentFrame - i.
+	 */
+	std::uint8_t inputCount = 0;
+	std::array<PlayerInput, MAX_INPUT_NMB> inputs{};
+
+	/**
+	 * \brief Acknowledgement of the reliable messages of the server, carried by the inputs that are sent every frame.
+	 */
+	bool hasReliableAck = false;
+	ReliableAck reliableAck{};
 };
 
-inline sf::Packet& operator<<(sf::Packet& packet, const PlayerInputPacket& playerInputPacket)
-{
-	return packet << playerInputPacket.playerNumber <<
-		playerInputPacket.currentFrame << playerInputPacket.inputs;
-}
+static_assert(MAX_INPUT_NMB <= std::numeric_limits<decltype(PlayerInputPacket::inputCount)>::max());
 
-inline sf::Packet& operator>>(sf::Packet& packet, PlayerInputPacket& playerInputPacket)
+template <typename Stream>
+void Serialize(Stream& stream, core::StreamData<Stream, PlayerInputPacket>& packet)
 {
-	return packet >> playerInputPacket.playerNumber >>
-		playerInputPacket.currentFrame >> playerInputPacket.inputs;
+	stream.SerializeBits(packet.playerNumber, PLAYER_NUMBER_BITS);
+	stream.SerializeVarUint(packet.currentFrame, FRAME_GROUP_BITS);
+	SerializeFrameDelta(stream, packet.ackFrame, packet.currentFrame);
+	SerializeInputRuns(stream, packet.inputCount, packet.inputs);
+	SerializeOptionalAck(stream, packet.hasReliableAck, packet.reliableAck);
 }
 
 /**
- * \brief StartGamePacket is a TCP Packet send by the server to start a game at a given time.
+ * \brief Size of the biggest encoded PlayerInputPacket, when none of its inputs are the same as the next one.
+ */
+constexpr std::size_t MAX_INPUT_PACKET_SIZE = 32 + MAX_INPUT_NMB * 2;
+
+/**
+ * \brief StartGamePacket is a reliable Packet send by the server to start a game at a given time.
  */
 struct StartGamePacket final : TypedPacket<PacketType::StartGame>
 {
+	/**
+	 * \brief Time of the server when the game starts, in milliseconds since the epoch.
+	 */
+	std::uint64_t startTime = 0;
 };
 
+template <typename Stream>
+void Serialize(Stream& stream, core::StreamData<Stream, StartGamePacket>& packet)
+{
+	stream.SerializeBits(packet.startTime, 64);
+}
+
 /**
- * \brief ValidateFramePacket is an UDP packet that is sent by the server to validate the last physics state of the world.
+ * \brief ServerInputsPacket is an UDP Packet sent by the server to all clients at a fixed cadence.
+ * It carries the new inputs of all the players, the last validated frame and its physics state in one datagram per client,
+ * instead of replicating every PlayerInputPacket to every client.
+ * The last received frame of a player is also the acknowledgement of its inputs for its client.
  */
-struct ValidateFramePacket final : TypedPacket<PacketType::ValidateState>
+struct ServerInputsPacket final : TypedPacket<PacketType::ServerInputs>
 {
-	std::array<std::uint8_t, sizeof(Frame)> newValidateFrame{};
-	std::array<std::uint8_t, sizeof(PhysicsState) * MAX_PLAYER_NMB> physicsState{};
+	Frame validateFrame = 0;
+	std::array<PhysicsState, MAX_PLAYER_NMB> physicsStates{};
+
+	/**
+	 * \brief Last frame received from each player, inputs[p][i] being the input of player p at the frame lastReceivedFrames[p] - i.
+	 */
+	std::array<Frame, MAX_PLAYER_NMB> lastReceivedFrames{};
+	std::array<std::uint8_t, MAX_PLAYER_NMB> inputCounts{};
+	std::array<std::array<PlayerInput, MAX_INPUT_NMB>, MAX_PLAYER_NMB> inputs{};
 };
 
-inline sf::Packet& operator<<(sf::Packet& packet, const ValidateFramePacket& validateFramePacket)
+template <typename Stream>
+void Serialize(Stream& stream, core::StreamData<Stream, ServerInputsPacket>& packet)
 {
-	return packet << validateFramePacket.newValidateFrame << validateFramePacket.physicsState;
-}
+	stream.SerializeVarUint(packet.validateFrame, FRAME_GROUP_BITS);
+	for (auto& physicsState : packet.physicsStates)
+	{
+		stream.SerializeBits(physicsState, PHYSICS_STATE_BITS);
+	}
 
-inline sf::Packet& operator>>(sf::Packet& packet, ValidateFramePacket& validateFramePacket)
-{
-	return packet >> validateFramePacket.newValidateFrame >> validateFramePacket.physicsState;
+	// The players are never far from the validated frame, so their frames are sent relative to it
+	for (PlayerNumber playerNumber = 0; playerNumber < MAX_PLAYER_NMB; playerNumber++)
+	{
+		SerializeFrameDelta(stream, packet.lastReceivedFrames[playerNumber], packet.validateFrame);
+		SerializeInputRuns(stream, packet.inputCounts[playerNumber], packet.inputs[playerNumber]);
+	}
 }
 
+constexpr std::size_t MAX_SERVER_INPUTS_PACKET_SIZE = 16 + MAX_PLAYER_NMB * MAX_INPUT_PACKET_SIZE;
+
 /**
- * \brief WinGamePacket is a TCP Packet sent by the server to notify the clients that a certain player has won.
+ * \brief WinGamePacket is a reliable Packet sent by the server to notify the clients that a certain player has won.
  */
 struct LoseGamePacket final : TypedPacket<PacketType::LoseGame>
 {
 	bool hasLost = true;
 };
 
-inline sf::Packet& operator<<(sf::Packet& packet, const LoseGamePacket& winGamePacket)
+template <typename Stream>
+void Serialize(Stream& stream, core::StreamData<Stream, LoseGamePacket>& packet)
 {
-	return packet << winGamePacket.hasLost;
-}
-
-inline sf::Packet& operator>>(sf::Packet& packet, LoseGamePacket& winGamePacket)
-{
-	return packet >> winGamePacket.hasLost;
+	stream.SerializeBits(packet.hasLost, 1);
 }
 
 /**
@@ -218,171 +357,151 @@ inline sf::Packet& operator>>(sf::Packet& packet, LoseGamePacket& winGamePacket)
  */
 struct PingPacket final : TypedPacket<PacketType::Ping>
 {
-	std::array<std::uint8_t, sizeof(unsigned long long)> time{};
-	std::array<std::uint8_t, sizeof(ClientId)> clientId{};
+	/**
+	 * \brief Time of the client when it sent the ping, in milliseconds since the epoch.
+	 */
+	std::uint64_t time = 0;
+
+	/**
+	 * \brief Time of the server when it sent the ping back, in milliseconds since the epoch.
+	 */
+	std::uint64_t serverTime = 0;
+	ClientId clientId = INVALID_CLIENT_ID;
 };
 
-inline sf::Packet& operator<<(sf::Packet& packet, const PingPacket& pingPacket)
+template <typename Stream>
+void Serialize(Stream& stream, core::StreamData<Stream, PingPacket>& packet)
 {
-	return packet << pingPacket.time << pingPacket.clientId;
+	stream.SerializeBits(packet.time, 64);
+	stream.SerializeBits(packet.serverTime, 64);
+	stream.SerializeBits(packet.clientId, CLIENT_ID_BITS);
 }
 
-inline sf::Packet& operator>>(sf::Packet& packet, PingPacket& pingPacket)
+struct SpawnFallingWallPacket final : TypedPacket<PacketType::SpawnFallingWall>
+{
+	Frame spawnFrame = 0;
+	float doorPosition = 0.0f;
+	bool requiresBall = false;
+};
+
+template <typename Stream>
+void Serialize(Stream& stream, core::StreamData<Stream, SpawnFallingWallPacket>& packet)
 {
-	return packet >> pingPacket.time >> pingPacket.clientId;
+	stream.SerializeVarUint(packet.spawnFrame, FRAME_GROUP_BITS);
+	stream.SerializeFloat(packet.doorPosition);
+	stream.SerializeBits(packet.requiresBall, 1);
 }
 
-struct SpawnFallingWallPacket final : TypedPacket<PacketType::SpawnFallingWall>
+/**
+ * \brief Size of the biggest packet sent as a reliable message, a SpawnPlayerPacket and its type.
+ */
+constexpr std::size_t MAX_RELIABLE_MESSAGE_SIZE = 32;
+
+/**
+ * \brief ReliablePacket is an UDP Packet that carries a packet of the reliable ordered channel, and the acknowledgement of the other side.
+ * It replaces the TCP connection, so a lost message only delays the messages sent after it, not the inputs.
+ * A packet without a message only carries the acknowledgement.
+ */
+struct ReliablePacket final : TypedPacket<PacketType::Reliable>
 {
-	std::array<std::uint8_t, sizeof(Frame)> spawnFrame{};
-	std::array<std::uint8_t, sizeof(float)> doorPosition{};
-	bool requiresBall{};
+	std::uint16_t sequence = 0;
+	bool hasReliableAck = false;
+	ReliableAck reliableAck{};
+
+	/**
+	 * \brief The message is a packet written by WritePacket, it is read when it is delivered.
+	 */
+	std::uint8_t messageSize = 0;
+	std::array<std::uint8_t, MAX_RELIABLE_MESSAGE_SIZE> message{};
 };
 
-inline sf::Packet& operator<<(sf::Packet& packet, const SpawnFallingWallPacket& pingPacket)
+template <typename Stream>
+void Serialize(Stream& stream, core::StreamData<Stream, ReliablePacket>& packet)
 {
-	return packet << pingPacket.spawnFrame << pingPacket.doorPosition << pingPacket.requiresBall;
+	stream.SerializeBits(packet.sequence, 16);
+	SerializeOptionalAck(stream, packet.hasReliableAck, packet.reliableAck);
+	stream.SerializeVarUint(packet.messageSize, SMALL_GROUP_BITS);
+	if constexpr (!Stream::IS_WRITING)
+	{
+		packet.messageSize = std::min<std::uint8_t>(packet.messageSize, MAX_RELIABLE_MESSAGE_SIZE);
+	}
+	for (std::uint8_t i = 0; i < packet.messageSize; i++)
+	{
+		stream.SerializeBits(packet.message[i], 8);
+	}
 }
 
-inline sf::Packet& operator>>(sf::Packet& packet, SpawnFallingWallPacket& pingPacket)
+/**
+ * \brief Packet is any of the packets. They are stored by value, so sending or receiving one does not allocate.
+ */
+using Packet = std::variant<JoinPacket, SpawnPlayerPacket, PlayerInputPacket, ServerInputsPacket, StartGamePacket,
+                            JoinAckPacket, LoseGamePacket, PingPacket, SpawnFallingWallPacket, ReliablePacket>;
+
+/**
+ * \brief Size of the biggest encoded packet, a ServerInputsPacket and its type. It fits in a datagram that is never fragmented.
+ */
+constexpr std::size_t MAX_PACKET_SIZE = 1 + MAX_SERVER_INPUTS_PACKET_SIZE;
+
+static_assert(MAX_PACKET_SIZE <= 508);
+
+inline PacketType GetPacketType(const Packet& packet)
 {
-	return packet >> pingPacket.spawnFrame >> pingPacket.doorPosition >> pingPacket.requiresBall;
+	return std::visit([]<typename T>(const T&) { return T::PACKET_TYPE; }, packet);
 }
 
-inline void GeneratePacket(sf::Packet& packet, Packet& sendingPacket)
+/**
+ * \brief WritePacket writes the type of a packet followed by its content, in the layout given by its Serialize function.
+ * \param buffer The memory where the packet is written, MAX_PACKET_SIZE bytes are always enough.
+ * \return the number of bytes written, or 0 if the packet does not fit in the buffer.
+ */
+inline std::size_t WritePacket(const std::span<std::uint8_t> buffer, const Packet& packet)
 {
-	packet << sendingPacket;
-	switch (sendingPacket.packetType)
+	core::BitWriter writer(buffer);
+	std::visit([&writer]<typename T>(const T& typedPacket)
 	{
-	case PacketType::Join:
-		{
-			const auto& packetTmp = static_cast<JoinPacket&>(sendingPacket);
-			packet << packetTmp;
-			break;
-		}
-	case PacketType::SpawnPlayer:
-		{
-			const auto& packetTmp = static_cast<SpawnPlayerPacket&>(sendingPacket);
-			packet << packetTmp;
-			break;
-		}
-	case PacketType::Input:
-		{
-			const auto& packetTmp = static_cast<PlayerInputPacket&>(sendingPacket);
-			packet << packetTmp;
-			break;
-		}
-	case PacketType::ValidateState:
-		{
-			const auto& packetTmp = static_cast<ValidateFramePacket&>(sendingPacket);
-			packet << packetTmp;
-			break;
-		}
-	case PacketType::StartGame:
-		{
-			break;
-		}
-	case PacketType::JoinAck:
-		{
-			const auto& packetTmp = static_cast<JoinAckPacket&>(sendingPacket);
-			packet << packetTmp;
-			break;
-		}
-	case PacketType::LoseGame:
-		{
-			const auto& packetTmp = static_cast<LoseGamePacket&>(sendingPacket);
-			packet << packetTmp;
-			break;
-		}
-	case PacketType::Ping:
-		{
-			const auto& packetTmp = static_cast<PingPacket&>(sendingPacket);
-			packet << packetTmp;
-			break;
-		}
-	case PacketType::SpawnFallingWall:
-		{
-			const auto& packetTmp = static_cast<SpawnFallingWallPacket&>(sendingPacket);
-			packet << packetTmp;
-			break;
-		}
-	default:
-		break;
-	}
+		writer.SerializeBits(T::PACKET_TYPE, PACKET_TYPE_BITS);
+		Serialize(writer, typedPacket);
+	}, packet);
+	return writer.HasOverflowed() ? 0 : writer.ByteCount();
 }
 
-inline std::unique_ptr<Packet> GenerateReceivedPacket(sf::Packet& packet)
+/**
+ * \brief ReadPacketContent reads the content of the packet alternative that has the given type.
+ * The alternatives are tested at compile time, the compiler turns it into a switch.
+ */
+template <std::size_t Index = 0>
+std::optional<Packet> ReadPacketContent(core::BitReader& reader, const PacketType packetType)
 {
-	Packet packetTmp;
-	packet >> packetTmp;
-	switch (packetTmp.packetType)
+	if constexpr (Index < std::variant_size_v<Packet>)
 	{
-	case PacketType::Join:
+		if (packetType != std::variant_alternative_t<Index, Packet>::PACKET_TYPE)
 		{
-			auto joinPacket = std::make_unique<JoinPacket>();
-			joinPacket->packetType = packetTmp.packetType;
-			packet >> *joinPacket;
-			return joinPacket;
+			return ReadPacketContent<Index + 1>(reader, packetType);
 		}
-	case PacketType::SpawnPlayer:
-		{
-			auto spawnPlayerPacket = std::make_unique<SpawnPlayerPacket>();
-			spawnPlayerPacket->packetType = packetTmp.packetType;
-			packet >> *spawnPlayerPacket;
-			return spawnPlayerPacket;
-		}
-	case PacketType::Input:
-		{
-			auto playerInputPacket = std::make_unique<PlayerInputPacket>();
-			playerInputPacket->packetType = packetTmp.packetType;
-			packet >> *playerInputPacket;
-			return playerInputPacket;
-		}
-	case PacketType::ValidateState:
-		{
-			auto validateFramePacket = std::make_unique<ValidateFramePacket>();
-			validateFramePacket->packetType = packetTmp.packetType;
-			packet >> *validateFramePacket;
-			return validateFramePacket;
-		}
-	case PacketType::StartGame:
-		{
-			auto startGamePacket = std::make_unique<StartGamePacket>();
-			startGamePacket->packetType = packetTmp.packetType;
-			return startGamePacket;
-		}
-	case PacketType::JoinAck:
-		{
-			auto joinAckPacket = std::make_unique<JoinAckPacket>();
-			joinAckPacket->packetType = packetTmp.packetType;
-			packet >> *joinAckPacket;
-			return joinAckPacket;
-		}
-	case PacketType::LoseGame:
-		{
-			auto winGamePacket = std::make_unique<LoseGamePacket>();
-			winGamePacket->packetType = packetTmp.packetType;
-			packet >> *winGamePacket;
-			return winGamePacket;
-		}
-	case PacketType::Ping:
-		{
-			auto pingPacket = std::make_unique<PingPacket>();
-			pingPacket->packetType = packetTmp.packetType;
-			packet >> *pingPacket;
-			return pingPacket;
-		}
-	case PacketType::SpawnFallingWall:
-		{
-			auto spawnFallingWallPacket = std::make_unique<SpawnFallingWallPacket>();
-			spawnFallingWallPacket->packetType = packetTmp.packetType;
-			packet >> *spawnFallingWallPacket;
-			return spawnFallingWallPacket;
-		}
-	default:
-		break;
+
+		std::optional<Packet> packet{std::in_place, std::in_place_index<Index>};
+		Serialize(reader, std::get<Index>(*packet));
+		return packet;
+	}
+	else
+	{
+		return std::nullopt;
 	}
-	return nullptr;
+}
+
+/**
+ * \brief ReadPacket reads a packet written by WritePacket.
+ * \return the packet, or nothing if its type is unknown or if it is truncated.
+ */
+inline std::optional<Packet> ReadPacket(const std::span<const std::uint8_t> data)
+{
+	core::BitReader reader(data);
+	PacketType packetType = PacketType::None;
+	reader.SerializeBits(packetType, PACKET_TYPE_BITS);
+
+	auto packet = ReadPacketContent(reader, packetType);
+	if (reader.HasOverflowed()) return std::nullopt;
+	return packet;
 }
 
 /**
@@ -398,7 +517,7 @@ public:
 	PacketSenderInterface& operator=(const PacketSenderInterface& other) = default;
 	PacketSenderInterface& operator=(PacketSenderInterface&& other) = default;
 
-	virtual void SendReliablePacket(std::unique_ptr<Packet> packet) = 0;
-	virtual void SendUnreliablePacket(std::unique_ptr<Packet> packet) = 0;
+	virtual void SendReliablePacket(const Packet& packet) = 0;
+	virtual void SendUnreliablePacket(const Packet& packet) = 0;
 };
 }
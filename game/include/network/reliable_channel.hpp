@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+#include "network/packet_type.hpp"
+#include "network/rtt_estimator.hpp"
+
+namespace game
+{
+/**
+ * \brief Time given to the ReliableChannel, in milliseconds of a monotonic clock.
+ */
+[[nodiscard]] std::uint64_t GetChannelTime();
+
+/**
+ * \brief ReliableChannel sends packets on UDP that are all delivered, in the order they were sent.
+ * Each message has a sequence number, the peer acknowledges the sequences it has received with a bit field.
+ * A message that is not acknowledged after the retransmission timeout is sent again, with a longer timeout each time.
+ * The messages that arrive before a missing one wait for it in a window, they are not sent again.
+ * The channel does not own a socket, its owner sends the ReliablePackets it gives and gives it the ones it receives.
+ */
+class ReliableChannel
+{
+public:
+	/**
+	 * \brief Number of messages that can wait for their acknowledgement, it is also the window of the receiver.
+	 */
+	static constexpr std::uint16_t WINDOW_SIZE = 32;
+
+	/**
+	 * \brief Number of packets that carry the acknowledgement after a message is received.
+	 */
+	static constexpr int ACK_REPEAT_COUNT = 4;
+
+	/**
+	 * \brief Queues a message, it is sent by the next GetPacketsToSend.
+	 * \return false if WINDOW_SIZE messages are waiting for their acknowledgement, the peer is then too late to be kept.
+	 */
+	[[nodiscard]] bool Send(const Packet& packet);
+
+	/**
+	 * \brief Gives the packets to send now: the new messages, the ones whose timeout has expired,
+	 * and an acknowledgement alone if it has not been carried by another packet.
+	 * \param retransmissionTimeout Time after which a message is sent again, in milliseconds.
+	 * \return the packets, valid until the next call.
+	 */
+	std::span<const ReliablePacket> GetPacketsToSend(std::uint64_t time, float retransmissionTimeout);
+
+	/**
+	 * \brief Reads a ReliablePacket sent by the peer, its message can then be given by PopMessage.
+	 */
+	void Receive(const ReliablePacket& packet, std::uint64_t time, RttEstimator& rttEstimator);
+
+	/**
+	 * \brief Removes the messages acknowledged by the peer.
+	 * The round trip time of the messages sent only once is given to the estimator.
+	 */
+	void ReceiveAck(const ReliableAck& ack, std::uint64_t time, RttEstimator& rttEstimator);
+
+	/**
+	 * \brief Gives the next message in the order they were sent, once all the messages before it have been received.
+	 */
+	std::optional<Packet> PopMessage();
+
+	/**
+	 * \brief Gives the acknowledgement to put in a packet sent to the peer, if a message has been received recently.
+	 */
+	std::optional<ReliableAck> TakeAck();
+
+	[[nodiscard]] std::size_t GetWaitingMessageCount() const;
+
+	/**
+	 * \brief Number of messages that had to be sent again since the channel was created.
+	 */
+	[[nodiscard]] std::uint64_t GetRetransmissionCount() const { return _retransmissionCount; }
+
+private:
+	struct SentMessage
+	{
+		std::array<std::uint8_t, MAX_RELIABLE_MESSAGE_SIZE> data{};
+		std::uint8_t size = 0;
+		std::uint16_t sequence = 0;
+		std::uint64_t lastSendTime = 0;
+		std::uint32_t sendCount = 0;
+		bool isWaitingAck = false;
+	};
+
+	/**
+	 * \brief The sequences wrap around, a sequence is newer than another one if it is less than half of the range after it.
+	 */
+	[[nodiscard]] static bool IsNewer(std::uint16_t sequence, std::uint16_t other);
+
+	void AcknowledgeMessage(std::uint16_t sequence, std::uint64_t time, RttEstimator& rttEstimator);
+
+	std::array<SentMessage, WINDOW_SIZE> _sentMessages{};
+	std::uint16_t _oldestSentSequence = 0;
+	std::uint16_t _nextSentSequence = 0;
+
+	std::array<std::optional<Packet>, WINDOW_SIZE> _receivedMessages{};
+	std::uint16_t _nextReceivedSequence = 0;
+
+	ReliableAck _ack{};
+	bool _hasReceivedMessage = false;
+	int _ackRepeatCount = 0;
+
+	std::array<ReliablePacket, WINDOW_SIZE + 1> _packetsToSend{};
+	std::uint64_t _retransmissionCount = 0;
+};
+}
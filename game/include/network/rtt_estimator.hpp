@@ -0,0 +1,32 @@
+#pragma once
+
+namespace game
+{
+/**
+ * \brief RttEstimator smooths the measured round trip times and gives the retransmission timeout, as TCP does (RFC 6298).
+ * The times are in milliseconds.
+ */
+class RttEstimator
+{
+public:
+	void AddSample(float rtt);
+
+	[[nodiscard]] bool HasSample() const { return _srtt >= 0.0f; }
+	[[nodiscard]] float GetSmoothedRtt() const { return _srtt; }
+	[[nodiscard]] float GetRttVariation() const { return _rttvar; }
+
+	/**
+	 * \brief Time after which a packet that has not been acknowledged is considered lost.
+	 */
+	[[nodiscard]] float GetRetransmissionTimeout() const { return _rto; }
+
+private:
+	float _srtt = -1.0f;
+	float _rttvar = 0.0f;
+	float _rto = 1000.0f;
+	static constexpr float K = 4.0f;
+	static constexpr float G = 100.0f;
+	static constexpr float ALPHA = 1.0f / 8.0f;
+	static constexpr float BETA = 1.0f / 4.0f;
+};
+}
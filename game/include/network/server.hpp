@@ -1,6 +1,4 @@
 #pragma once
-#include <memory>
-
 #include "packet_type.hpp"
 
 #include "engine/system.hpp"
@@ -21,6 +19,18 @@ protected:
 	virtual void SendStartGamePacket();
 	virtual void SendSpawnFallingWallPacket(Frame spawnTimeOffset = 0u);
 
+	/**
+	 * \brief UpdateTick sends a ServerInputsPacket to the clients at the fixed cadence of SERVER_TICK_PERIOD once the game has started.
+	 * It is called by the Update of the SimulationServer, the MatchServer counts the ticks with its EventLoop and gives them to its matches.
+	 */
+	void UpdateTick(sf::Time dt);
+
+	/**
+	 * \brief SendServerInputsPacket sends to all clients the last validated frame and the inputs of the players
+	 * that have not been acknowledged by all of them.
+	 */
+	void SendServerInputsPacket();
+
 	[[nodiscard]] Frame GetNextRandomFallingWallSpawnFrame() const;
 	[[nodiscard]] float GetNextRandomDoorPosition() const;
 
@@ -28,11 +38,17 @@ protected:
 	 * \brief ReceiveNetPacket is a method that is called when the Server receives a Packet from a Client.
 	 * \param packet is the received Packet.
 	 */
-	virtual void ReceivePacket(std::unique_ptr<Packet> packet);
+	virtual void ReceivePacket(const Packet& packet);
 
 	//Server game manager
 	GameManager _gameManager;
 	PlayerNumber _lastPlayerNumber = 0;
 	std::array<ClientId, MAX_PLAYER_NMB> _clientMap{};
+
+	/**
+	 * \brief Last frame for which each client has received the inputs of all the other players.
+	 */
+	std::array<Frame, MAX_PLAYER_NMB> _inputAckFrames{};
+	float _tickTimer = 0.0f;
 };
 }
@@ -26,10 +26,10 @@ public:
 	void Draw(sf::RenderTarget& renderTarget) override;
 
 
-	void SendUnreliablePacket(std::unique_ptr<Packet> packet) override;
-	void SendReliablePacket(std::unique_ptr<Packet> packet) override;
+	void SendUnreliablePacket(const Packet& packet) override;
+	void SendReliablePacket(const Packet& packet) override;
 
-	void ReceivePacket(const Packet* packet) override;
+	void ReceivePacket(const Packet& packet) override;
 
 	void DrawImGui() override;
 	void SetPlayerInput(PlayerInput playerInput);
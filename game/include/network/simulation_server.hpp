@@ -16,7 +16,7 @@ namespace game
 struct DelayPacket
 {
 	float currentTime = 0.0f;
-	std::unique_ptr<Packet> packet = nullptr;
+	Packet packet;
 };
 
 class SimulationClient;
@@ -32,12 +32,12 @@ public:
 	void Update(sf::Time dt) override;
 	void End() override;
 	void DrawImGui() override;
-	void PutPacketInReceiveQueue(std::unique_ptr<Packet> packet, bool unreliable);
-	void SendReliablePacket(std::unique_ptr<Packet> packet) override;
-	void SendUnreliablePacket(std::unique_ptr<Packet> packet) override;
+	void PutPacketInReceiveQueue(const Packet& packet, bool unreliable);
+	void SendReliablePacket(const Packet& packet) override;
+	void SendUnreliablePacket(const Packet& packet) override;
 private:
-	void PutPacketInSendingQueue(std::unique_ptr<Packet> packet);
-	void ProcessReceivePacket(std::unique_ptr<Packet> packet);
+	void PutPacketInSendingQueue(const Packet& packet);
+	void ProcessReceivePacket(const Packet& packet);
 
 	void SpawnNewPlayer(ClientId clientId, PlayerNumber playerNumber) override;
 
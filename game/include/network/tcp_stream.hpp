@@ -0,0 +1,129 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+#include <SFML/Network/TcpSocket.hpp>
+
+#include "network/packet_type.hpp"
+
+namespace game
+{
+class EventLoop;
+
+/**
+ * \brief Size of the header of the packets sent on TCP: the size of the packet on 2 bytes, in little endian.
+ */
+constexpr std::size_t TCP_FRAME_HEADER_SIZE = 2;
+constexpr std::size_t MAX_TCP_FRAME_SIZE = TCP_FRAME_HEADER_SIZE + MAX_PACKET_SIZE;
+
+/**
+ * \brief Number of bytes that can wait to be sent to a client on TCP.
+ * A client that lets more bytes wait does not read its socket and is disconnected.
+ */
+constexpr std::size_t MAX_TCP_SEND_QUEUE_SIZE = 32 * MAX_TCP_FRAME_SIZE;
+
+static_assert(MAX_PACKET_SIZE <= 0xFFFF);
+
+/**
+ * \brief Writes a packet preceded by its size, so that the receiver can find it in the stream of bytes.
+ * \param buffer The memory where the frame is written, MAX_TCP_FRAME_SIZE bytes are always enough.
+ * \return the number of bytes of the frame, or 0 if it does not fit in the buffer.
+ */
+std::size_t WriteTcpFrame(std::span<std::uint8_t> buffer, const Packet& packet);
+
+/**
+ * \brief Sends a whole frame written by WriteTcpFrame, sending the rest again while the socket only takes a part of it.
+ */
+sf::Socket::Status SendTcpFrame(sf::TcpSocket& socket, std::span<const std::uint8_t> frame);
+
+/**
+ * \brief TcpSendMetrics tells how much a client is late at reading what is sent to it.
+ */
+struct TcpSendMetrics
+{
+	std::uint64_t sentByteCount = 0;
+	/**
+	 * \brief Number of frames that the socket could not take entirely when they were sent.
+	 */
+	std::uint64_t delayedFrameCount = 0;
+	std::size_t queuedByteCount = 0;
+	std::size_t maxQueuedByteCount = 0;
+};
+
+/**
+ * \brief TcpPacketSender sends the frames on a non blocking TCP socket without waiting for it.
+ * What the socket does not take is queued and sent by the next Flush, in the same order.
+ * Its queue is fixed, sending does not allocate.
+ */
+class TcpPacketSender
+{
+public:
+	/**
+	 * \brief Sends the queued bytes and then the frame, the part that the socket does not take is queued.
+	 * \return false if the frame does not fit in the queue, the client is then too slow to be kept.
+	 */
+	[[nodiscard]] bool Send(sf::TcpSocket& socket, std::span<const std::uint8_t> frame);
+
+	/**
+	 * \brief Sends as many queued bytes as the socket takes, it is called when the socket can be written again.
+	 * \return the status of the last send, Done when the queue is empty.
+	 */
+	sf::Socket::Status Flush(sf::TcpSocket& socket);
+
+	/**
+	 * \brief Flushes the queue, the event loop then only waits for the socket to be writable while bytes are queued.
+	 */
+	void Flush(sf::TcpSocket& socket, EventLoop& eventLoop);
+
+	[[nodiscard]] bool HasQueuedBytes() const { return _sendPosition < _size; }
+	[[nodiscard]] const TcpSendMetrics& GetMetrics() const { return _metrics; }
+
+	void Clear();
+
+private:
+	/**
+	 * \brief Moves the bytes that have not been sent to the beginning of the buffer.
+	 */
+	void Compact();
+
+	std::array<std::uint8_t, MAX_TCP_SEND_QUEUE_SIZE> _buffer{};
+	std::size_t _sendPosition = 0;
+	std::size_t _size = 0;
+	TcpSendMetrics _metrics{};
+	bool _isWaitingWritable = false;
+};
+
+/**
+ * \brief TcpPacketReceiver keeps the bytes received on a TCP socket until they make whole packets.
+ * Its buffer is fixed, receiving does not allocate.
+ */
+class TcpPacketReceiver
+{
+public:
+	/**
+	 * \brief Receives the bytes that are available on the socket, without blocking when the socket is non blocking.
+	 * \return the status of the last receive, Disconnected when the peer has closed the connection.
+	 */
+	sf::Socket::Status Receive(sf::TcpSocket& socket);
+
+	/**
+	 * \brief Gives the next packet that has been received entirely. The packets that can not be read are skipped.
+	 */
+	std::optional<Packet> PopPacket();
+
+	void Clear();
+
+private:
+	/**
+	 * \brief Moves the bytes that have not been read to the beginning of the buffer.
+	 */
+	void Compact();
+
+	std::array<std::uint8_t, 4 * MAX_TCP_FRAME_SIZE> _buffer{};
+	std::size_t _readPosition = 0;
+	std::size_t _size = 0;
+};
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+#include <SFML/Network/UdpSocket.hpp>
+
+#include "network/packet_type.hpp"
+
+namespace game
+{
+/**
+ * \brief Datagram is a UDP datagram received or waiting to be sent, with the address of its peer.
+ */
+struct Datagram
+{
+	std::array<std::uint8_t, MAX_PACKET_SIZE> data{};
+	std::size_t size = 0;
+	sf::IpAddress address;
+	unsigned short port = 0;
+};
+
+/**
+ * \brief UdpBatchSocket is a non blocking UDP socket that receives and sends the datagrams in batches.
+ * On Linux a batch is one recvmmsg or sendmmsg call on the handle of the socket,
+ * on the other platforms it is one SFML call per datagram.
+ */
+class UdpBatchSocket final : public sf::UdpSocket
+{
+public:
+	/**
+	 * \brief Maximum number of datagrams of a batch, the buffers of the datagrams are allocated with the socket.
+	 */
+	static constexpr std::size_t BATCH_SIZE = 64;
+
+	/**
+	 * \brief Receives the datagrams waiting on the socket, up to BATCH_SIZE.
+	 * \return the received datagrams, empty when there are none. They are valid until the next call.
+	 */
+	std::span<const Datagram> ReceiveBatch();
+
+	/**
+	 * \brief Receives batches until the socket is drained, so the datagrams do not wait in the kernel buffer.
+	 */
+	template<typename Callback>
+	void ReceiveAll(Callback&& callback)
+	{
+		for (auto datagrams = ReceiveBatch(); !datagrams.empty(); datagrams = ReceiveBatch())
+		{
+			for (const Datagram& datagram : datagrams)
+			{
+				callback(datagram);
+			}
+		}
+	}
+
+	/**
+	 * \brief Queues a datagram, it is sent by the next FlushSends or when the queue is full.
+	 * The datagram is dropped if the queue is still full after flushing it.
+	 */
+	void QueueSend(std::span<const std::uint8_t> data, const sf::IpAddress& address, unsigned short port);
+
+	/**
+	 * \brief Sends the queued datagrams.
+	 * When the send buffer of the socket is full, the datagrams that are left stay queued for the next flush.
+	 * A datagram that fails for any other reason is dropped, like any lost datagram.
+	 */
+	void FlushSends();
+
+private:
+	std::array<Datagram, BATCH_SIZE> _receivedDatagrams{};
+	std::array<Datagram, BATCH_SIZE> _sendingDatagrams{};
+	std::size_t _sendingCount = 0;
+};
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+#include "rigidbody.hpp"
+
+#include "engine/entity.hpp"
+
+#include "maths/vec2.hpp"
+
+namespace game
+{
+/**
+ * \brief The algorithms that can be used by the PhysicsManager for the broad phase.
+ */
+enum class BroadPhaseType : std::uint8_t
+{
+	Grid,
+	SweepAndPrune,
+	AabbTree,
+};
+
+/**
+ * \brief Tells if a body has to look for the bodies it overlaps.
+ * Awake dynamic and kinematic bodies are active, as well as static bodies that have been moved
+ * (to wake the sleeping bodies they run into). Pairs of inactive bodies are never returned.
+ * \param body The body to check.
+ * \return True if the body is active in the broad phase.
+ */
+inline bool IsActiveInBroadPhase(const Rigidbody& body)
+{
+	return body.IsStatic() ? body.HasMoved() : body.IsAwake();
+}
+
+/**
+ * \brief Interface of the broad phase, that finds the pairs of bodies that may collide.
+ * Implementations must only depend on the components of the world to produce their pairs,
+ * so that two peers (or a world after a rollback) always get the same pairs in the same order.
+ */
+class BroadPhase
+{
+public:
+	BroadPhase() = default;
+	virtual ~BroadPhase() = default;
+	BroadPhase(const BroadPhase& other) = default;
+	BroadPhase(BroadPhase&& other) = default;
+	BroadPhase& operator=(const BroadPhase& other) = default;
+	BroadPhase& operator=(BroadPhase&& other) = default;
+
+	/**
+	 * \brief Updates the internal structure from the current state of the bodies.
+	 */
+	virtual void Update() = 0;
+
+	/**
+	 * \brief Sets the area in which most of the bodies are, usually the extents of the level.
+	 * It is only a hint for the broad phases that partition the space, bodies can still be outside of it.
+	 * \param min Bottom left point of the area.
+	 * \param max Top right point of the area.
+	 */
+	virtual void SetWorldBounds(core::Vec2f /*min*/, core::Vec2f /*max*/) {}
+
+	/**
+	 * \brief Find all the pair of objects that may collide.
+	 * Only pairs with at least one active body (see IsActiveInBroadPhase) and that are not both static
+	 * are returned, and the pairs whose layers do not collide are rejected.
+	 * Does not contain any duplicates.
+	 * \param memoryResource Resource from which the pairs are allocated, the frame arena of the physics.
+	 * \return The pair of objects that may collide, the first entity always being the smallest.
+	 */
+	[[nodiscard]] virtual std::pmr::vector<std::pair<core::Entity, core::Entity>> GetCollisionPairs(
+		std::pmr::memory_resource* memoryResource) const = 0;
+};
+}
@@ -1,8 +1,11 @@
 #pragma once
 
-#include <unordered_map>
+#include <compare>
+#include <utility>
 #include <vector>
 
+#include "broad_phase.hpp"
+#include "layers.hpp"
 #include "rigidbody.hpp"
 
 #include "engine/entity.hpp"
@@ -17,8 +20,18 @@ namespace game
 * that are in the same cell.
 *
 * A collider that spans on multiple cells will have a pointer on every cell.
+*
+* Static and sleeping bodies are kept in a separate persistent list. They are only re-inserted when
+* they are added, removed or when the cells they cover change, the changes being merged once per update.
+* Active bodies (see IsActiveInBroadPhase) are re-binned every update.
+* Both lists are flat and sorted by cell, and keep their memory, so that a step does not allocate
+* once they have grown to the number of bodies.
+*
+* Bodies that go beyond the extents of the grid are also put in an overflow bucket, in which they are
+* tested against each other. The cell size follows the average size of the non static bodies.
+* The pairs are sorted, so the extents and the cell size never change the result, only the performance.
 */
-class BroadPhaseGrid
+class BroadPhaseGrid final : public BroadPhase
 {
 public:
 	/**
@@ -32,26 +45,169 @@ public:
 	 * \param rigidbodyManager Manager of the Rigidbodies.
 	 * \param aabbManager Manager for Aabb colliders.
 	 * \param circleManager Manager for circle colliders.
+	 * \param layerCollisionMatrix Matrix used to reject the pairs of layers that do not collide.
 	 */
 	BroadPhaseGrid(float minX, float maxX, float minY, float maxY, float cellSize,
 	               core::EntityManager& entityManager, RigidbodyManager& rigidbodyManager,
-	               AabbColliderManager& aabbManager, CircleColliderManager& circleManager
+	               AabbColliderManager& aabbManager, CircleColliderManager& circleManager,
+	               const LayerCollisionMatrix& layerCollisionMatrix
 	);
 
+	/**
+	 * \brief Minimum ratio between the cell size and the average size of the non static bodies.
+	 * The size of a body is the full size of its bounding box, a body then covers one or two cells on each axis.
+	 */
+	static constexpr float MIN_CELL_SIZE_RATIO = 1.0f;
+
+	/**
+	 * \brief Maximum ratio between the cell size and the average size of the non static bodies.
+	 * The cell size is changed to the average of the two ratios when it goes out of them.
+	 */
+	static constexpr float MAX_CELL_SIZE_RATIO = 2.0f;
+
+	/**
+	 * \brief Maximum number of cells on each axis, the cells get bigger instead, even when the bodies are smaller.
+	 */
+	static constexpr std::size_t MAX_CELL_NMB_PER_AXIS = 256;
+
 	/**
 	 * \brief Updates the layout of the grid.
 	 */
-	void Update();
+	void Update() override;
+
+	/**
+	 * \brief Moves the extents of the grid, which is then filled again on the next update.
+	 */
+	void SetWorldBounds(core::Vec2f min, core::Vec2f max) override;
 
 	/**
-	 * \brief Find all the pair of objects that are in the same cell.
+	 * \brief Changes the extents and the cell size of the grid, which is then filled again on the next update.
+	 */
+	void Resize(core::Vec2f min, core::Vec2f max, float cellSize);
+
+	[[nodiscard]] float GetCellSize() const { return _cellSize; }
+
+	/**
+	 * \brief Find all the pair of objects that are in the same cell, or both in the overflow bucket.
+	 * Only pairs with at least one active body that are not both static are returned.
 	 * Does not contain any duplicates.
-	 * \return The pair of objects that will collide.
+	 * \param memoryResource Resource from which the pairs are allocated.
+	 * \return The pair of objects that will collide, sorted.
 	 */
-	[[nodiscard]] std::vector<std::pair<core::Entity, core::Entity>> GetCollisionPairs() const;
+	[[nodiscard]] std::pmr::vector<std::pair<core::Entity, core::Entity>> GetCollisionPairs(
+		std::pmr::memory_resource* memoryResource) const override;
 
 private:
-	std::vector<std::vector<std::vector<core::Entity>>> _grid;
+	/**
+	 * \brief Range of cells (inclusive) covered by a body.
+	 * The range is empty when the body is entirely outside of the grid.
+	 */
+	struct CellRange
+	{
+		int xMin = 0;
+		int yMin = 0;
+		int xMax = -1;
+		int yMax = -1;
+
+		/**
+		 * \brief True if the body goes beyond the extents of the grid.
+		 */
+		bool isOverflow = false;
+
+		bool operator==(const CellRange& other) const = default;
+	};
+
+	/**
+	 * \brief A body in a cell, with the data needed to filter pairs without looking up the components.
+	 */
+	struct CellEntry
+	{
+		core::Entity entity = core::INVALID_ENTITY;
+		Layer layer = Layer::None;
+		bool isStatic = false;
+
+		auto operator<=>(const CellEntry& other) const = default;
+	};
+
+	/**
+	 * \brief A body in one of the cells it covers, the cell being x * gridHeight + y.
+	 * Ordered by cell and then by entity.
+	 */
+	struct GridEntry
+	{
+		std::size_t cellIndex = 0;
+		CellEntry cellEntry{};
+
+		auto operator<=>(const GridEntry& other) const = default;
+	};
+
+	/**
+	 * \brief State of a body in the persistent list.
+	 */
+	struct PersistentEntry
+	{
+		bool isInserted = false;
+		bool wasSeen = false;
+
+		/**
+		 * \brief True if the entries of the body must leave the persistent list at the end of the update.
+		 */
+		bool isRemoved = false;
+		CellRange range{};
+		CellEntry cellEntry{};
+	};
+
+	using Cell = std::vector<CellEntry>;
+
+	/**
+	 * \brief Size of the cells when the grid has MAX_CELL_NMB_PER_AXIS cells on its longest axis.
+	 */
+	[[nodiscard]] float GetMinCellSize() const;
+
+	/**
+	 * \brief Computes the range of cells covered by the bounds of a collider, clamped to the grid.
+	 */
+	[[nodiscard]] CellRange ComputeCellRange(const ColliderBounds& bounds) const;
+
+	void InsertPersistent(const CellEntry& cellEntry, const CellRange& range);
+	void RemovePersistent(core::Entity entity, const CellRange& range);
+
+	/**
+	 * \brief Applies the removals and insertions of the update to the persistent list.
+	 */
+	void MergePersistentChanges();
+
+	/**
+	 * \brief Active bodies in each cell they cover, sorted.
+	 */
+	std::vector<GridEntry> _dynamicCells;
+
+	/**
+	 * \brief Persistent bodies in each cell they cover, sorted.
+	 */
+	std::vector<GridEntry> _persistentCells;
+
+	/**
+	 * \brief Persistent entries inserted during the update, merged in the persistent list at its end.
+	 */
+	std::vector<GridEntry> _addedPersistentCells;
+
+	bool _hasRemovedPersistent = false;
+
+	std::vector<PersistentEntry> _persistentEntries;
+
+	Cell _dynamicOverflow;
+
+	/**
+	 * \brief Overflow bucket of the persistent bodies, sorted like the persistent cells.
+	 */
+	Cell _persistentOverflow;
+
+	/**
+	 * \brief Average size of the non static bodies during the last update, 0 if there were none.
+	 */
+	float _averageBodySize = 0.0f;
+
 	core::Vec2f _min;
 	core::Vec2f _max;
 	float _cellSize;
@@ -62,9 +218,6 @@ private:
 	RigidbodyManager& _rigidbodyManager;
 	AabbColliderManager& _aabbManager;
 	CircleColliderManager& _circleManager;
-
-	static bool HasBeenChecked(
-		const std::unordered_multimap<core::Entity, core::Entity>& checkedCollisions,
-		const std::pair<core::Entity, core::Entity>& bodyPair);
+	const LayerCollisionMatrix& _layerCollisionMatrix;
 };
 }
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <vector>
+
+#include "broad_phase.hpp"
+#include "layers.hpp"
+#include "rigidbody.hpp"
+
+#include "engine/entity.hpp"
+
+namespace game
+{
+/**
+ * \brief Sort and sweep broad phase on the x axis.
+ *
+ * The bodies are kept in a list sorted on the minimum x of their bounding box.
+ * Since bodies barely move from one frame to the other, the list is almost sorted at
+ * each update and is re-sorted with an insertion sort.
+ *
+ * The list is sorted on (min x, entity) which is a total order, so the sorted list only depends
+ * on the bodies and not on the previous order. This means it does not need to be part of
+ * the rollback state.
+ */
+class BroadPhaseSweepAndPrune final : public BroadPhase
+{
+public:
+	/**
+	 * \brief Constructs a new sweep and prune broad phase.
+	 * \param entityManager Manager of the Entities.
+	 * \param rigidbodyManager Manager of the Rigidbodies.
+	 * \param aabbManager Manager for Aabb colliders.
+	 * \param circleManager Manager for circle colliders.
+	 * \param layerCollisionMatrix Matrix used to reject the pairs of layers that do not collide.
+	 */
+	BroadPhaseSweepAndPrune(core::EntityManager& entityManager, RigidbodyManager& rigidbodyManager,
+	                        AabbColliderManager& aabbManager, CircleColliderManager& circleManager,
+	                        const LayerCollisionMatrix& layerCollisionMatrix);
+
+	/**
+	 * \brief Updates the bounds of the bodies and sorts them on the x axis.
+	 */
+	void Update() override;
+
+	/**
+	 * \brief Find all the pair of objects whose bounding boxes overlap.
+	 * Only dynamic-dynamic and dynamic-static pairs are returned.
+	 * Does not contain any duplicates.
+	 * \param memoryResource Resource from which the pairs are allocated.
+	 * \return The pair of objects that will collide.
+	 */
+	[[nodiscard]] std::pmr::vector<std::pair<core::Entity, core::Entity>> GetCollisionPairs(
+		std::pmr::memory_resource* memoryResource) const override;
+
+private:
+	/**
+	 * \brief A body in the sorted list.
+	 */
+	struct Entry
+	{
+		core::Entity entity = core::INVALID_ENTITY;
+		core::Vec2f min{};
+		core::Vec2f max{};
+		bool isStatic = false;
+		bool isActive = false;
+		Layer layer = Layer::None;
+
+		[[nodiscard]] bool IsBefore(const Entry& other) const;
+	};
+
+	/**
+	 * \brief Computes the bounds of a body.
+	 * \return False if the entity no longer has a rigidbody or a collider.
+	 */
+	bool ComputeEntry(core::Entity entity, Entry& entry) const;
+
+	std::vector<Entry> _entries;
+	std::vector<bool> _isInserted;
+
+	core::EntityManager& _entityManager;
+	RigidbodyManager& _rigidbodyManager;
+	AabbColliderManager& _aabbManager;
+	CircleColliderManager& _circleManager;
+	const LayerCollisionMatrix& _layerCollisionMatrix;
+};
+}
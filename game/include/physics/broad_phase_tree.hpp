@@ -0,0 +1,132 @@
+#pragma once
+
+#include <vector>
+
+#include "broad_phase.hpp"
+#include "layers.hpp"
+#include "rigidbody.hpp"
+
+#include "engine/entity.hpp"
+
+namespace game
+{
+/**
+ * \brief Broad phase using a dynamic bounding volume hierarchy.
+ *
+ * Each body is a leaf of a binary tree whose nodes contain the bounds of their children.
+ * Leaves store a "fat" bounding box, enlarged by a margin, so that a body that only moves
+ * a little does not need to be moved in the tree.
+ * Contrary to the grid, there are no world extents and big colliders are stored only once.
+ *
+ * The shape of the tree depends on the order of the insertions, so the pairs are filtered on
+ * the tight bounding boxes and sorted before being returned.
+ * The tree does thus not need to be part of the rollback state.
+ */
+class BroadPhaseAabbTree final : public BroadPhase
+{
+public:
+	/**
+	 * \brief Constructs a new bounding volume hierarchy broad phase.
+	 * \param entityManager Manager of the Entities.
+	 * \param rigidbodyManager Manager of the Rigidbodies.
+	 * \param aabbManager Manager for Aabb colliders.
+	 * \param circleManager Manager for circle colliders.
+	 * \param layerCollisionMatrix Matrix used to reject the pairs of layers that do not collide.
+	 */
+	BroadPhaseAabbTree(core::EntityManager& entityManager, RigidbodyManager& rigidbodyManager,
+	                   AabbColliderManager& aabbManager, CircleColliderManager& circleManager,
+	                   const LayerCollisionMatrix& layerCollisionMatrix);
+
+	/**
+	 * \brief Inserts, removes and moves the bodies in the tree.
+	 */
+	void Update() override;
+
+	/**
+	 * \brief Find all the pair of objects whose bounding boxes overlap.
+	 * Only dynamic-dynamic and dynamic-static pairs are returned.
+	 * Does not contain any duplicates.
+	 * \param memoryResource Resource from which the pairs are allocated.
+	 * \return The pair of objects that will collide, sorted.
+	 */
+	[[nodiscard]] std::pmr::vector<std::pair<core::Entity, core::Entity>> GetCollisionPairs(
+		std::pmr::memory_resource* memoryResource) const override;
+
+private:
+	static constexpr int NULL_NODE = -1;
+
+	/**
+	 * \brief Margin (in meter) added around the bounds of the bodies stored in the tree.
+	 */
+	static constexpr float FAT_MARGIN = 0.2f;
+
+	struct Bounds
+	{
+		core::Vec2f min{};
+		core::Vec2f max{};
+
+		[[nodiscard]] bool Overlaps(const Bounds& other) const;
+		[[nodiscard]] bool Contains(const Bounds& other) const;
+		[[nodiscard]] float Perimeter() const;
+		[[nodiscard]] static Bounds Union(const Bounds& a, const Bounds& b);
+	};
+
+	struct Node
+	{
+		Bounds bounds{};
+		int parent = NULL_NODE;
+		int child1 = NULL_NODE;
+		int child2 = NULL_NODE;
+
+		/**
+		 * \brief Height of the node in the tree, 0 for a leaf and -1 for a free node.
+		 */
+		int height = -1;
+		core::Entity entity = core::INVALID_ENTITY;
+
+		[[nodiscard]] bool IsLeaf() const { return child1 == NULL_NODE; }
+	};
+
+	/**
+	 * \brief State of a body in the broad phase.
+	 */
+	struct Proxy
+	{
+		int node = NULL_NODE;
+		Bounds bounds{};
+		bool isStatic = false;
+		bool isActive = false;
+		Layer layer = Layer::None;
+	};
+
+	/**
+	 * \brief Computes the bounds, state and layer of a body.
+	 * \return False if the entity no longer has a rigidbody or a collider.
+	 */
+	bool ComputeProxy(core::Entity entity, Proxy& proxy) const;
+
+	int AllocateNode();
+	void FreeNode(int node);
+
+	void InsertLeaf(int leaf);
+	void RemoveLeaf(int leaf);
+
+	/**
+	 * \brief Performs a rotation on the node if it is unbalanced.
+	 * \return The index of the new root of the subtree.
+	 */
+	int Balance(int nodeA);
+
+	std::vector<Node> _nodes;
+	int _root = NULL_NODE;
+	int _freeList = NULL_NODE;
+
+	std::vector<Proxy> _proxies;
+
+	core::EntityManager& _entityManager;
+	RigidbodyManager& _rigidbodyManager;
+	AabbColliderManager& _aabbManager;
+	CircleColliderManager& _circleManager;
+	const LayerCollisionMatrix& _layerCollisionMatrix;
+};
+}
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
 #include "manifold.hpp"
 
 #include "engine/component.hpp"
@@ -11,140 +14,84 @@
 
 namespace game
 {
-struct CircleCollider;
-struct AabbCollider;
+/**
+ * \brief Tag telling which collider a body has.
+ * It is stored in the Rigidbody so the narrow phase can dispatch on it without looking up the components.
+ */
+enum class ShapeType : std::uint8_t
+{
+	None = 0,
+	Circle,
+	Aabb,
+};
+
+/**
+ * \brief Number of shape types that have a collider (all but ShapeType::None).
+ */
+constexpr std::size_t SHAPE_TYPE_COUNT = 2;
 
 /**
- * \brief A pure virtual struct that represents colliders.
+ * \brief Base of the colliders, holds the data that is common to every shape.
+ * Colliders have no virtual methods, the shape is known from the ShapeType of the body.
  */
 struct Collider
 {
-public:
-	Collider() = default;
-	Collider(Collider&& col) noexcept = default;
-	virtual ~Collider() = default;
-	Collider& operator=(Collider&& col) = default;
-	Collider& operator=(const Collider& col) = default;
-	Collider(const Collider& col) = default;
-
 	/**
 	* \brief The center of the collider.
 	*/
-	core::Vec2f center{};
+	Vec2s center{};
+};
 
+/**
+ * \brief A circle collider.
+ */
+struct CircleCollider final : Collider
+{
 	/**
-	 * \brief Tests the collision against a generic collider.
-	 * \param transform The transform of this collider.
-	 * \param collider The collider to collide with.
-	 * \param colliderTransform The transform of the collider to collide with.
-	 * \return The manifold of that collision.
+	 * \brief Radius of the circle.
 	 */
-	virtual Manifold TestCollision(
-		const Transform* transform,
-		const Collider* collider,
-		const Transform* colliderTransform
-	) const = 0;
+	Scalar radius = 0;
 
 	/**
-	 * \brief Tests the collision against a circle collider.
-	 * \param transform The transform of this collider.
-	 * \param collider The circle collider to collide with.
-	 * \param circleTransform The transform of the collider to collide with.
-	 * \return The manifold of that collision.
+	 * \brief Gets the size of the box that surrounds the collider.
+	 * \return The bounding box of the collider.
 	 */
-	virtual Manifold TestCollision(
-		const Transform* transform,
-		const CircleCollider* collider,
-		const Transform* circleTransform
-	) const = 0;
+	[[nodiscard]] Vec2s GetBoundingBoxSize() const;
+};
 
+/**
+ * \brief An Axis Aligned Bounding Box collider.
+ */
+struct AabbCollider final : Collider
+{
 	/**
-	 * \brief Tests the collision against a aabb collider.
-	 * \param transform The transform of this collider.
-	 * \param collider The circle collider to collide with.
-	 * \param aabbTransform The transform of the collider to collide with.
-	 * \return The manifold of that collision.
+	 * \brief Half of the width of the box.
 	 */
-	virtual Manifold TestCollision(
-		const Transform* transform,
-		const AabbCollider* collider,
-		const Transform* aabbTransform
-	) const = 0;
-
+	Scalar halfWidth = 0;
 	/**
-	 * \brief Find the furthest point in the specified direction.
-	 * \param transform The transform of this collider.
-	 * \param direction Direction in which to find the furthest point.
-	 * \return The furthest point.
+	 * \brief Half of the height of the box.
 	 */
-	[[nodiscard]] virtual core::Vec2f FindFurthestPoint(
-		const Transform* transform,
-		const core::Vec2f& direction
-	) const = 0;
+	Scalar halfHeight = 0;
 
 	/**
 	 * \brief Gets the size of the box that surrounds the collider.
 	 * \return The bounding box of the collider.
 	 */
-	[[nodiscard]] virtual core::Vec2f GetBoundingBoxSize() const = 0;
+	[[nodiscard]] Vec2s GetBoundingBoxSize() const;
 };
 
 /**
- * \brief A circle collider.
+ * \brief Box surrounding the collider of a body, in world space.
+ * It stays in floating point with every Scalar type, the broad phases only need to be conservative.
  */
-struct CircleCollider final : Collider
+struct ColliderBounds
 {
-public:
-	/**
-	 * \brief Radius of the circle.
-	 */
-	float radius = 0;
-
-	Manifold TestCollision(
-		const Transform* transform,
-		const Collider* collider,
-		const Transform* colliderTransform
-	) const override;
-
-	Manifold TestCollision(
-		const Transform* transform,
-		const CircleCollider* collider,
-		const Transform* circleTransform
-	) const override;
-
-	Manifold TestCollision(const Transform* transform, const AabbCollider* collider,
-	                       const Transform* aabbTransform) const override;
-
-	[[nodiscard]] core::Vec2f FindFurthestPoint(
-		const Transform* transform,
-		const core::Vec2f& direction
-	) const override;
-	[[nodiscard]] core::Vec2f GetBoundingBoxSize() const override;
-};
+	core::Vec2f center{};
 
-/**
- * \brief An Axis Aligned Bounding Box collider.
- */
-struct AabbCollider final : Collider
-{
 	/**
-	 * \brief Half of the width of the box.
-	 */
-	float halfWidth = 0;
-	/**
-	 * \brief Half of the height of the box.
+	 * \brief Size of the bounding box of the collider with the scale of its transform, the broad phases use half of it as the extent.
 	 */
-	float halfHeight = 0;
-
-	Manifold TestCollision(const Transform* transform, const Collider* collider,
-	                       const Transform* colliderTransform) const override;
-	Manifold TestCollision(const Transform* transform, const CircleCollider* collider,
-	                       const Transform* circleTransform) const override;
-	Manifold TestCollision(const Transform* transform, const AabbCollider* collider,
-	                       const Transform* aabbTransform) const override;
-	[[nodiscard]] core::Vec2f
-	FindFurthestPoint(const Transform* transform, const core::Vec2f& direction) const override;
-	[[nodiscard]] core::Vec2f GetBoundingBoxSize() const override;
+	core::Vec2f boundingBoxSize{};
 };
 
 class AabbColliderManager final :
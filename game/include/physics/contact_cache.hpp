@@ -0,0 +1,60 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "engine/entity.hpp"
+
+#include "physics/scalar.hpp"
+
+namespace game
+{
+/**
+ * \brief Impulses accumulated by the solver on a contact during the last step.
+ */
+struct CachedContact
+{
+	/**
+	 * \brief Smallest entity of the pair.
+	 */
+	core::Entity firstEntity = core::INVALID_ENTITY;
+
+	/**
+	 * \brief Biggest entity of the pair.
+	 */
+	core::Entity secondEntity = core::INVALID_ENTITY;
+
+	Scalar normalImpulse = 0.0f;
+	Scalar tangentImpulse = 0.0f;
+
+	[[nodiscard]] bool IsBefore(const CachedContact& other) const;
+};
+
+/**
+ * \brief Keeps the impulses of the contacts between two steps so the solver can be warm started.
+ * The contacts are stored sorted by entity pair, which keeps the cache deterministic and cheap to copy
+ * with the rest of the world when rolling back.
+ */
+class ContactCache
+{
+public:
+	/**
+	 * \brief Finds the impulses of a contact from the last step.
+	 * \return The cached contact, or nullptr if the bodies were not touching during the last step.
+	 */
+	[[nodiscard]] const CachedContact* Find(core::Entity entityA, core::Entity entityB) const;
+
+	/**
+	 * \brief Replaces the content of the cache with the contacts of this step.
+	 * The memory of the cache is reused, so it is only allocated when the number of contacts increases.
+	 * \param contacts Contacts solved this step, the pair does not need to be ordered.
+	 */
+	void Store(std::span<const CachedContact> contacts);
+
+	void Clear() { _contacts.clear(); }
+	[[nodiscard]] std::size_t Size() const { return _contacts.size(); }
+
+private:
+	std::vector<CachedContact> _contacts;
+};
+}
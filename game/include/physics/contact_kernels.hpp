@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#include "collider.hpp"
+#include "manifold.hpp"
+#include "transform.hpp"
+
+namespace game::algo
+{
+/**
+ * \brief Structure of arrays holding circle-circle candidate pairs.
+ * The colliders are stored in world space, with their scale already applied.
+ */
+struct CircleCircleBatch
+{
+	std::pmr::vector<Scalar> aX;
+	std::pmr::vector<Scalar> aY;
+	std::pmr::vector<Scalar> aRadius;
+	std::pmr::vector<Scalar> bX;
+	std::pmr::vector<Scalar> bY;
+	std::pmr::vector<Scalar> bRadius;
+
+	/**
+	 * \brief Creates an empty batch.
+	 * \param memoryResource Resource from which the arrays are allocated, usually the frame arena of the physics.
+	 */
+	explicit CircleCircleBatch(std::pmr::memory_resource* memoryResource = std::pmr::get_default_resource())
+		: aX(memoryResource),
+		  aY(memoryResource),
+		  aRadius(memoryResource),
+		  bX(memoryResource),
+		  bY(memoryResource),
+		  bRadius(memoryResource)
+	{
+	}
+
+	void Clear();
+	void Reserve(std::size_t size);
+	void Add(const CircleCollider& a, const Transform& ta, const CircleCollider& b, const Transform& tb);
+	[[nodiscard]] std::size_t Size() const { return aX.size(); }
+};
+
+/**
+ * \brief Structure of arrays holding aabb-circle candidate pairs.
+ * The colliders are stored in world space, with their scale already applied.
+ */
+struct AabbCircleBatch
+{
+	std::pmr::vector<Scalar> aX;
+	std::pmr::vector<Scalar> aY;
+	std::pmr::vector<Scalar> aHalfWidth;
+	std::pmr::vector<Scalar> aHalfHeight;
+	std::pmr::vector<Scalar> bX;
+	std::pmr::vector<Scalar> bY;
+	std::pmr::vector<Scalar> bRadius;
+
+	/**
+	 * \brief Creates an empty batch.
+	 * \param memoryResource Resource from which the arrays are allocated, usually the frame arena of the physics.
+	 */
+	explicit AabbCircleBatch(std::pmr::memory_resource* memoryResource = std::pmr::get_default_resource())
+		: aX(memoryResource),
+		  aY(memoryResource),
+		  aHalfWidth(memoryResource),
+		  aHalfHeight(memoryResource),
+		  bX(memoryResource),
+		  bY(memoryResource),
+		  bRadius(memoryResource)
+	{
+	}
+
+	void Clear();
+	void Reserve(std::size_t size);
+	void Add(const AabbCollider& a, const Transform& ta, const CircleCollider& b, const Transform& tb);
+	[[nodiscard]] std::size_t Size() const { return aX.size(); }
+};
+
+/**
+ * \brief Tests every pair of the batch using squared distances only.
+ * Uses AVX2 or SSE2 when available with float Scalars, the results are the same as the scalar path.
+ * \param batch The candidate pairs.
+ * \param hits Filled with the indices of the pairs that collide, in increasing order.
+ */
+void FindCircleCircleHits(const CircleCircleBatch& batch, std::pmr::vector<std::uint32_t>& hits);
+
+/**
+ * \brief Tests every pair of the batch using squared distances only.
+ * Uses AVX2 or SSE2 when available with float Scalars, the results are the same as the scalar path.
+ * \param batch The candidate pairs.
+ * \param hits Filled with the indices of the pairs that may collide, in increasing order.
+ */
+void FindAabbCircleHits(const AabbCircleBatch& batch, std::pmr::vector<std::uint32_t>& hits);
+
+/**
+ * \brief Same as FindCircleCircleHits without the SIMD paths, the tests check that both give the same hits.
+ */
+void FindCircleCircleHitsScalar(const CircleCircleBatch& batch, std::pmr::vector<std::uint32_t>& hits);
+
+/**
+ * \brief Same as FindAabbCircleHits without the SIMD paths, the tests check that both give the same hits.
+ */
+void FindAabbCircleHitsScalar(const AabbCircleBatch& batch, std::pmr::vector<std::uint32_t>& hits);
+
+/**
+ * \brief Computes the manifold of a pair of the batch, same as FindCircleCircleManifold.
+ * \param batch The candidate pairs.
+ * \param index Index of the pair in the batch.
+ * \return The manifold of the collisions between A and B.
+ */
+Manifold BuildCircleCircleManifold(const CircleCircleBatch& batch, std::size_t index);
+
+/**
+ * \brief Computes the manifold of a pair of the batch, same as FindAabbCircleManifold.
+ * \param batch The candidate pairs.
+ * \param index Index of the pair in the batch.
+ * \return The manifold of the collisions between A and B.
+ */
+Manifold BuildAabbCircleManifold(const AabbCircleBatch& batch, std::size_t index);
+}
@@ -1,7 +1,15 @@
 #pragma once
 
+#include <span>
+
+#include "physics/collision.hpp"
+
 namespace game
 {
+/**
+ * \brief Listener of the triggers of a PhysicsManager.
+ * It is registered with component masks, and only receives the triggers that match them.
+ */
 class OnTriggerInterface
 {
 public:
@@ -12,9 +20,17 @@ public:
 	OnTriggerInterface& operator=(const OnTriggerInterface& other) = default;
 	OnTriggerInterface& operator=(OnTriggerInterface&& other) = default;
 
-	virtual void OnTrigger(core::Entity entity1, core::Entity entity2) = 0;
+	/**
+	 * \brief Called once per step with all the triggers that matched the masks of the listener.
+	 * \param triggers The triggers, the first body always matching the first mask.
+	 */
+	virtual void OnTrigger(std::span<const Collision> triggers) = 0;
 };
 
+/**
+ * \brief Listener of the collisions of a PhysicsManager.
+ * It is registered with component masks, and only receives the collisions that match them.
+ */
 class OnCollisionInterface
 {
 public:
@@ -25,6 +41,10 @@ public:
 	OnCollisionInterface& operator=(const OnCollisionInterface& other) = default;
 	OnCollisionInterface& operator=(OnCollisionInterface&& other) = default;
 
-	virtual void OnCollision(core::Entity entity1, core::Entity entity2) = 0;
+	/**
+	 * \brief Called once per step with all the collisions that matched the masks of the listener.
+	 * \param collisions The collisions, the first body always matching the first mask.
+	 */
+	virtual void OnCollision(std::span<const Collision> collisions) = 0;
 };
 }
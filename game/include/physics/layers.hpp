@@ -1,6 +1,5 @@
 #pragma once
-#include <optional>
-
+#include <array>
 #include <cstdint>
 
 namespace game
@@ -15,32 +14,75 @@ enum class Layer : std::int8_t
 	Ball,
 };
 
-struct LayerMask
+/**
+ * \brief Maximum number of layers that fits in the collision matrix.
+ */
+constexpr std::size_t MAX_LAYER_NMB = 8;
+
+static_assert(static_cast<std::size_t>(Layer::Ball) < MAX_LAYER_NMB, "Too many layers for the collision matrix");
+
+/**
+ * \brief Table telling which layers collide with each other.
+ * Each layer has a byte in which the bit of every other layer is set if they collide.
+ * Every layer collides with every other one by default, and Layer::None always collides.
+ */
+class LayerCollisionMatrix
 {
-	std::uint8_t player : 1 = 1;
-	std::uint8_t wall : 1 = 1;
-	std::uint8_t door : 1 = 1;
-	std::uint8_t middleWall : 1 = 1;
-	std::uint8_t ball : 1 = 1;
+public:
+	constexpr LayerCollisionMatrix()
+	{
+		_rows.fill(0xFF);
+	}
 
-	[[nodiscard]] bool HasCollision(Layer layer) const;
+	[[nodiscard]] constexpr bool HasCollision(const Layer layerOne, const Layer layerTwo) const
+	{
+		return (_rows[Index(layerOne)] >> Index(layerTwo)) & 1u;
+	}
 
-	void SetCollision(Layer layer, bool value);
-};
+	constexpr void SetCollision(const Layer layerOne, const Layer layerTwo, const bool value)
+	{
+		if (layerOne == Layer::None || layerTwo == Layer::None) return;
 
-struct LayerCollisionMatrix
-{
-	LayerMask player{};
-	LayerMask wall{};
-	LayerMask door{};
-	LayerMask middleWall{};
-	LayerMask ball{};
+		SetBit(layerOne, layerTwo, value);
+		SetBit(layerTwo, layerOne, value);
+	}
 
-	std::optional<LayerMask> GetMask(Layer layer);
-	LayerMask& GetMaskRef(Layer layer);
+private:
+	[[nodiscard]] static constexpr std::size_t Index(const Layer layer)
+	{
+		return static_cast<std::size_t>(layer);
+	}
 
-	bool HasCollision(Layer layerOne, Layer layerTwo);
+	constexpr void SetBit(const Layer row, const Layer column, const bool value)
+	{
+		const auto bit = static_cast<std::uint8_t>(1u << Index(column));
+		if (value)
+		{
+			_rows[Index(row)] |= bit;
+		}
+		else
+		{
+			_rows[Index(row)] &= static_cast<std::uint8_t>(~bit);
+		}
+	}
 
-	void SetCollision(Layer layerOne, Layer layerTwo, bool value);
+	std::array<std::uint8_t, MAX_LAYER_NMB> _rows{};
 };
+
+/**
+ * \brief The layers collisions used in the game.
+ */
+constexpr LayerCollisionMatrix LAYER_COLLISION_MATRIX = []
+{
+	LayerCollisionMatrix matrix;
+	matrix.SetCollision(Layer::Ball, Layer::MiddleWall, false);
+	matrix.SetCollision(Layer::Wall, Layer::Wall, false);
+	matrix.SetCollision(Layer::Wall, Layer::Door, false);
+	matrix.SetCollision(Layer::Wall, Layer::MiddleWall, false);
+	matrix.SetCollision(Layer::MiddleWall, Layer::Door, false);
+	return matrix;
+}();
+
+static_assert(!LAYER_COLLISION_MATRIX.HasCollision(Layer::Door, Layer::Wall));
+static_assert(LAYER_COLLISION_MATRIX.HasCollision(Layer::Ball, Layer::Player));
 }
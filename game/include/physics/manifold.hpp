@@ -2,34 +2,36 @@
 
 #include "maths/vec2.hpp"
 
+#include "physics/scalar.hpp"
+
 namespace game
 {
 struct Manifold
 {
-	Manifold(const core::Vec2f& a, const core::Vec2f& b, const core::Vec2f& normal, float depth);
-	Manifold(const core::Vec2f& normal, float depth);
+	Manifold(const Vec2s& a, const Vec2s& b, const Vec2s& normal, Scalar depth);
+	Manifold(const Vec2s& normal, Scalar depth);
 	Manifold();
 
 	/**
 	 * \brief Point a of the manifold.
 	 */
-	core::Vec2f a;
+	Vec2s a;
 
 	/**
 	 * \brief Point b of the manifold.
 	 */
-	core::Vec2f b;
+	Vec2s b;
 
 	/**
 	 * \brief The normal of the manifold.
 	 * Represents the direction in which the collision should be solved.
 	 */
-	core::Vec2f normal;
+	Vec2s normal;
 
 	/**
 	 * \brief The depth of the collision. Can be seen as the magnitude of the normal.
 	 */
-	float depth{};
+	Scalar depth{};
 
 	/**
 	 * \brief Boolean indicating whether a collision happened.
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <type_traits>
+
 #include "collider.hpp"
 #include "manifold.hpp"
 
@@ -29,6 +31,17 @@ Manifold FindCircleCircleManifold(
 	const CircleCollider* a, const Transform* ta,
 	const CircleCollider* b, const Transform* tb);
 
+/**
+ * \brief Builds the manifold of two circles that are known to overlap.
+ * Circles that have the same center are separated on the y axis.
+ * \param aPos Center of the circle A, in world space.
+ * \param aRadius Scaled radius of the circle A.
+ * \param bPos Center of the circle B, in world space.
+ * \param bRadius Scaled radius of the circle B.
+ * \return The manifold of the collisions between A and B.
+ */
+Manifold CircleCircleContact(const Vec2s& aPos, Scalar aRadius, const Vec2s& bPos, Scalar bRadius);
+
 /**
  * \brief Finds the collision manifold between A and B.
  * \param a AABB collider of the object A.
@@ -64,5 +77,46 @@ Manifold FindAabbCircleManifold(
 Manifold FindCircleAabbManifold(
 	const CircleCollider* a, const Transform* ta,
 	const AabbCollider* b, const Transform* tb);
+
+/**
+ * \brief Collider struct matching a shape type.
+ */
+template <ShapeType Shape>
+using ShapeCollider = std::conditional_t<Shape == ShapeType::Circle, CircleCollider, AabbCollider>;
+
+/**
+ * \brief Finds the collision manifold between A and B, resolved at compile time from the shape types.
+ * Some combinations call the algorithm with swapped arguments,
+ * so that the manifold has the orientation expected by the solvers.
+ * \param a Collider of the object A.
+ * \param ta Transform of the object A.
+ * \param b Collider of the object B.
+ * \param tb Transform of the object B.
+ * \return The manifold of the collisions between A and B.
+ */
+template <ShapeType ShapeA, ShapeType ShapeB>
+Manifold FindManifold(
+	const ShapeCollider<ShapeA>& a, const Transform& ta,
+	const ShapeCollider<ShapeB>& b, const Transform& tb)
+{
+	static_assert(ShapeA != ShapeType::None && ShapeB != ShapeType::None, "Both bodies need a collider");
+
+	if constexpr (ShapeA == ShapeType::Circle && ShapeB == ShapeType::Circle)
+	{
+		return FindCircleCircleManifold(&b, &tb, &a, &ta);
+	}
+	else if constexpr (ShapeA == ShapeType::Circle && ShapeB == ShapeType::Aabb)
+	{
+		return FindCircleAabbManifold(&a, &ta, &b, &tb);
+	}
+	else if constexpr (ShapeA == ShapeType::Aabb && ShapeB == ShapeType::Circle)
+	{
+		return FindAabbCircleManifold(&a, &ta, &b, &tb);
+	}
+	else
+	{
+		return FindAabbAabbManifold(&b, &tb, &a, &ta).Swaped();
+	}
+}
 }
 }
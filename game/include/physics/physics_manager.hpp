@@ -1,10 +1,15 @@
 #pragma once
+#include <chrono>
+#include <memory>
+#include <memory_resource>
 #include <optional>
+#include <span>
 
 #include <SFML/System/Time.hpp>
 
-#include "broad_phase_grid.hpp"
+#include "broad_phase.hpp"
 #include "collision.hpp"
+#include "contact_cache.hpp"
 #include "rigidbody.hpp"
 #include "solver.hpp"
 #include "event_interfaces.hpp"
@@ -15,15 +20,36 @@
 
 #include "graphics/graphics.hpp"
 
-#include "utils/action_utility.hpp"
+#include "utils/frame_arena.hpp"
 
 namespace core
 {
+class ThreadPool;
 class TransformManager;
 }
 
 namespace game
 {
+/**
+ * \brief Time spent in every stage of a physics step, with the number of pairs and contacts they worked on.
+ */
+struct PhysicsStepStats
+{
+	std::chrono::nanoseconds broadPhase{};
+	std::chrono::nanoseconds narrowPhase{};
+	std::chrono::nanoseconds solve{};
+	std::chrono::nanoseconds sleep{};
+	std::chrono::nanoseconds dispatchEvents{};
+
+	/**
+	 * \brief Gravity and the integration of the velocities and positions.
+	 */
+	std::chrono::nanoseconds integrate{};
+
+	std::size_t pairCount = 0;
+	std::size_t contactCount = 0;
+};
+
 /**
  * \brief PhysicsManager is a class that holds both BodyManager and BoxManager and manages the physics fixed update.
  * It allows to register OnTriggerInterface to be called when a trigger occurs.
@@ -31,17 +57,40 @@ namespace game
 class PhysicsManager final : public core::DrawInterface
 {
 public:
-	explicit PhysicsManager(core::EntityManager& entityManager);
+	/**
+	 * \brief Speed (in m/s) under which a body starts to count down before sleeping.
+	 */
+	static constexpr Scalar SLEEP_VELOCITY = 0.05f;
+
+	/**
+	 * \brief Time (in seconds) every body of an island has to stay slow before the island sleeps.
+	 */
+	static constexpr Scalar TIME_TO_SLEEP = 0.5f;
+
+	/**
+	 * \brief Mask matched by every entity, used to register listeners that receive all the collisions.
+	 */
+	static constexpr auto ANY_ENTITY_MASK = static_cast<core::EntityMask>(core::ComponentType::Empty);
+
+	explicit PhysicsManager(core::EntityManager& entityManager,
+	                        BroadPhaseType broadPhaseType = BroadPhaseType::Grid);
 
 	static std::optional<core::ComponentType>
 	HasCollider(const core::EntityManager& entityManager, core::Entity entity);
-	[[nodiscard]] static Collider* GetCollider(
-		const core::EntityManager& entityManager,
-		AabbColliderManager& aabbManager,
-		CircleColliderManager& circleManager,
-		core::Entity entity);
 
-	[[nodiscard]] Collider* GetCollider(core::Entity entity);
+	/**
+	 * \brief Gets the box surrounding the collider of a body, using the shape type of the body.
+	 * \param body Rigidbody of the entity.
+	 * \param entity Entity of the body.
+	 * \param aabbManager Manager for Aabb colliders.
+	 * \param circleManager Manager for circle colliders.
+	 * \return The bounds of the collider, or nothing if the body has no collider.
+	 */
+	[[nodiscard]] static std::optional<ColliderBounds> GetColliderBounds(
+		const Rigidbody& body,
+		core::Entity entity,
+		const AabbColliderManager& aabbManager,
+		const CircleColliderManager& circleManager);
 
 	[[nodiscard]] const Rigidbody& GetRigidbody(core::Entity entity) const;
 	[[nodiscard]] Rigidbody& GetRigidbody(core::Entity entity);
@@ -56,29 +105,123 @@ public:
 	void SetCircleCollider(core::Entity entity, const CircleCollider& circleCollider);
 	[[nodiscard]] CircleCollider& GetCircleCollider(core::Entity entity);
 
+	/**
+	 * \brief Changes the algorithm used for the broad phase.
+	 * The broad phase does not hold any rollback state, so this can be done at any time.
+	 * \param broadPhaseType The algorithm to use.
+	 */
+	void SetBroadPhaseType(BroadPhaseType broadPhaseType);
+	[[nodiscard]] BroadPhaseType GetBroadPhaseType() const { return _broadPhaseType; }
+
+	/**
+	 * \brief Sets the area of the level, used by the broad phase to partition the space.
+	 * It should be called when the level changes. Bodies can still go outside of it.
+	 * \param min Bottom left point of the level.
+	 * \param max Top right point of the level.
+	 */
+	void SetWorldBounds(core::Vec2f min, core::Vec2f max);
+
+	/**
+	 * \brief Sets the number of passes done by the solvers on the collisions every step.
+	 * \param velocityIterations Passes of the impulse solver.
+	 * \param positionIterations Passes of the position solver.
+	 */
+	void SetSolverIterations(std::uint32_t velocityIterations, std::uint32_t positionIterations);
+
+	/**
+	 * \brief Sets the pool used to solve the contacts in parallel.
+	 * The result of the solver does not depend on the number of threads of the pool.
+	 * \param threadPool Pool of threads, or nullptr to solve on the calling thread.
+	 */
+	void SetThreadPool(core::ThreadPool* threadPool) { _impulseSolver.SetThreadPool(threadPool); }
+
 	void SetCenter(const sf::Vector2f center) { _center = center; }
 	void SetWindowSize(const sf::Vector2f newWindowSize) { _windowSize = newWindowSize; }
 
 	void MoveBodies(sf::Time deltaTime);
 	void FixedUpdate(sf::Time deltaTime);
 
+	/**
+	 * \brief Gets the timings of the last call to FixedUpdate.
+	 */
+	[[nodiscard]] const PhysicsStepStats& GetLastStepStats() const { return _lastStepStats; }
+
 	/**
 	 * \brief RegisterTriggerListener is a method that stores an OnTriggerInterface in the PhysicsManager that will call the OnTrigger method in case of a trigger.
+	 * Only the triggers between a body with all the components of the first mask and a body with all the components
+	 * of the second mask are given to the listener.
 	 * \param onTriggerInterface is the OnTriggerInterface to be called when a trigger occurs.
+	 * \param firstMask Components of the first body of the triggers given to the listener.
+	 * \param secondMask Components of the second body of the triggers given to the listener.
 	 */
-	void RegisterTriggerListener(OnTriggerInterface& onTriggerInterface);
-	void RegisterCollisionListener(OnCollisionInterface& onCollisionInterface);
+	void RegisterTriggerListener(OnTriggerInterface& onTriggerInterface,
+	                             core::EntityMask firstMask = ANY_ENTITY_MASK,
+	                             core::EntityMask secondMask = ANY_ENTITY_MASK);
+
+	/**
+	 * \brief Stores an OnCollisionInterface that is called with the collisions of each step.
+	 * Only the collisions between a body with all the components of the first mask and a body with all the components
+	 * of the second mask are given to the listener.
+	 * \param onCollisionInterface Listener to call after the collisions have been solved.
+	 * \param firstMask Components of the first body of the collisions given to the listener.
+	 * \param secondMask Components of the second body of the collisions given to the listener.
+	 */
+	void RegisterCollisionListener(OnCollisionInterface& onCollisionInterface,
+	                               core::EntityMask firstMask = ANY_ENTITY_MASK,
+	                               core::EntityMask secondMask = ANY_ENTITY_MASK);
 
 	void CopyAllComponents(const PhysicsManager& physicsManager);
 	void Draw(sf::RenderTarget& renderTarget) override;
 
 	void ApplyGravity();
 	void ResolveCollisions(sf::Time deltaTime);
-	void SolveCollisions(const std::vector<Collision>& collisions, sf::Time deltaTime);
+	void SolveCollisions(std::span<const Collision> collisions, sf::Time deltaTime);
 
 private:
-	static void SendCollisionCallbacks(const std::vector<Collision>& collisions,
-	                                   core::Action<core::Entity, core::Entity>& action);
+	/**
+	 * \brief Updates the shape type stored in the rigidbody from the colliders of the entity.
+	 */
+	void UpdateShapeType(core::Entity entity);
+
+	/**
+	 * \brief Wakes up the sleeping bodies of the collisions, with every body of their islands.
+	 */
+	void WakeUpIslands(std::span<const Collision> collisions);
+
+	/**
+	 * \brief Updates the sleep timers and puts to sleep the islands whose bodies have all been slow for long enough.
+	 * Islands are groups of non static bodies linked by collisions.
+	 */
+	void UpdateSleep(std::span<const Collision> collisions, sf::Time deltaTime);
+
+	template <ShapeType Shape>
+	[[nodiscard]] const algo::ShapeCollider<Shape>& GetShape(core::Entity entity) const;
+
+	/**
+	 * \brief Runs the narrow phase on pairs that all have the same combination of shapes.
+	 */
+	template <ShapeType FirstShape, ShapeType SecondShape>
+	void TestCollisions(std::span<const std::pair<core::Entity, core::Entity>> pairs,
+	                    std::pmr::vector<Collision>& collisions, std::pmr::vector<Collision>& triggers);
+
+	/**
+	 * \brief A listener with the collisions that have been filtered for it during this step.
+	 */
+	template <typename Listener>
+	struct CollisionEventBuffer
+	{
+		Listener* listener = nullptr;
+		core::EntityMask firstMask = ANY_ENTITY_MASK;
+		core::EntityMask secondMask = ANY_ENTITY_MASK;
+		std::vector<Collision> collisions;
+	};
+
+	/**
+	 * \brief Fills the buffer of every listener with the collisions that match its masks.
+	 */
+	template <typename Listener>
+	void FillEventBuffers(std::span<const Collision> collisions,
+	                      std::vector<CollisionEventBuffer<Listener>>& eventBuffers) const;
 
 	core::EntityManager& _entityManager;
 	RigidbodyManager _rigidbodyManager;
@@ -86,16 +229,31 @@ private:
 	AabbColliderManager _aabbManager;
 	CircleColliderManager _circleManager;
 
-	core::Action<core::Entity, core::Entity> _onTriggerAction;
-	core::Action<core::Entity, core::Entity> _onCollisionAction;
+	std::vector<CollisionEventBuffer<OnTriggerInterface>> _triggerEventBuffers;
+	std::vector<CollisionEventBuffer<OnCollisionInterface>> _collisionEventBuffers;
 
+	/**
+	 * \brief Impulses of the contacts of the last step, copied with the components to stay deterministic.
+	 */
+	ContactCache _contactCache;
 	ImpulseSolver _impulseSolver;
 	SmoothPositionSolver _smoothPositionSolver;
-	BroadPhaseGrid _grid;
+	LayerCollisionMatrix _layerCollisionMatrix = LAYER_COLLISION_MATRIX;
+
+	core::Vec2f _worldMin{-500.0f, -500.0f};
+	core::Vec2f _worldMax{500.0f, 500.0f};
+	BroadPhaseType _broadPhaseType;
+	std::unique_ptr<BroadPhase> _broadPhase;
 
-	core::Vec2f _gravity = {0, -9.81f};
+	Vec2s _gravity = {0, -9.81f};
 
-	LayerCollisionMatrix _layerCollisionMatrix;
+	PhysicsStepStats _lastStepStats{};
+
+	/**
+	 * \brief Memory of the temporaries of a step, like the pairs and the collisions, reset at every step.
+	 * It is not part of the state of the world, so it is not copied with the components.
+	 */
+	core::FrameArena _frameArena;
 
 	// Used for debug
 	sf::Vector2f _center{};
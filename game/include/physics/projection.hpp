@@ -1,13 +1,15 @@
 #pragma once
 
+#include "physics/scalar.hpp"
+
 namespace game
 {
 struct Projection
 {
-	float min;
-	float max;
+	Scalar min;
+	Scalar max;
 
 	[[nodiscard]] bool Overlaps(const Projection& other) const;
-	[[nodiscard]] float GetOverlap(const Projection& other) const;
+	[[nodiscard]] Scalar GetOverlap(const Projection& other) const;
 };
 }
@@ -54,13 +54,13 @@ struct Rigidbody
 	 * \brief Gets the position of the body in the world.
 	 * \return The position of the body in the world.
 	 */
-	[[nodiscard]] const core::Vec2f& Position() const;
+	[[nodiscard]] const Vec2s& Position() const;
 
 	/**
 	 * \brief Sets the position of the body in the world.
 	 * \param position The new position of the body.
 	 */
-	void SetPosition(const core::Vec2f& position);
+	void SetPosition(const Vec2s& position);
 
 	[[nodiscard]] core::Radian Rotation() const;
 	void SetRotation(core::Radian rotation);
@@ -69,39 +69,39 @@ struct Rigidbody
 	 * \brief Gets the force of the gravity on this body.
 	 * \return The force of the gravity.
 	 */
-	[[nodiscard]] const core::Vec2f& GravityAcceleration() const;
+	[[nodiscard]] const Vec2s& GravityAcceleration() const;
 	/**
 	 * \brief Sets the gravity force.
 	 * \param gravityAcceleration New gravity force.
 	 */
-	void SetGravityAcceleration(const core::Vec2f& gravityAcceleration);
+	void SetGravityAcceleration(const Vec2s& gravityAcceleration);
 
 	/**
 	 * \brief Gets the force on this body.
 	 * \return The force on this body.
 	 */
-	[[nodiscard]] const core::Vec2f& Force() const;
+	[[nodiscard]] const Vec2s& Force() const;
 	/**
 	 * \brief Adds force to this body.
 	 * \param addedForce The force to add to this body.
 	 */
-	void ApplyForce(const core::Vec2f& addedForce);
+	void ApplyForce(const Vec2s& addedForce);
 	/**
 	 * \brief Sets the force of this body.
 	 * \param force The new force.
 	 */
-	void SetForce(const core::Vec2f& force);
+	void SetForce(const Vec2s& force);
 
 	/**
 	 * \brief Gets the velocity of this body.
 	 * \return The velocity of this body.
 	 */
-	[[nodiscard]] const core::Vec2f& Velocity() const;
+	[[nodiscard]] const Vec2s& Velocity() const;
 	/**
 	 * \brief Sets the velocity of this body.
 	 * \param velocity The new velocity.
 	 */
-	void SetVelocity(const core::Vec2f& velocity);
+	void SetVelocity(const Vec2s& velocity);
 
 	/**
 	 * \brief Computes the mass of this body. Only the inverted mass is stored,
@@ -109,17 +109,17 @@ struct Rigidbody
 	 * \see InvMass()
 	 * \return The mass of this body.
 	 */
-	[[nodiscard]] float Mass() const;
+	[[nodiscard]] Scalar Mass() const;
 	/**
 	 * \brief Returns 1 / Mass of this body.
 	 * \return The inverted mass of this body.
 	 */
-	[[nodiscard]] float InvMass() const;
+	[[nodiscard]] Scalar InvMass() const;
 	/**
 	 * \brief Sets the mass of this body.
 	 * \param mass The new mass.
 	 */
-	void SetMass(float mass);
+	void SetMass(Scalar mass);
 
 	/**
 	 * \brief Gets a boolean indicating whether this body takes gravity.
@@ -136,37 +136,37 @@ struct Rigidbody
 	 * \brief Gets the static friction of this body.
 	 * \return The static friction.
 	 */
-	[[nodiscard]] float StaticFriction() const;
+	[[nodiscard]] Scalar StaticFriction() const;
 	/**
 	 * \brief Sets the static friction of this body.
 	 * \param staticFriction The new static friction.
 	 */
-	void SetStaticFriction(float staticFriction);
+	void SetStaticFriction(Scalar staticFriction);
 
 	/**
 	 * \brief Gets the dynamic friction of this body.
 	 * \return The dynamic friction.
 	 */
-	[[nodiscard]] float DynamicFriction() const;
+	[[nodiscard]] Scalar DynamicFriction() const;
 	/**
 	 * \brief Sets the dynamic friction of this body.
 	 * \param dynamicFriction The new dynamic friction.
 	 */
-	void SetDynamicFriction(float dynamicFriction);
+	void SetDynamicFriction(Scalar dynamicFriction);
 
 	/**
 	 * \brief Gets the restitution of this body. Can be seen as the "Bounciness".
 	 * \return The restitution.
 	 */
-	[[nodiscard]] float Restitution() const;
+	[[nodiscard]] Scalar Restitution() const;
 	/**
 	 * \brief Sets the restitution of this body. Can be seen as the "Bounciness".
 	 * \param restitution The new restitution.
 	 */
-	void SetRestitution(float restitution);
+	void SetRestitution(Scalar restitution);
 
-	[[nodiscard]] float DragFactor() const { return _dragFactor; }
-	void SetDragFactor(const float dragFactor) { _dragFactor = dragFactor; }
+	[[nodiscard]] Scalar DragFactor() const { return _dragFactor; }
+	void SetDragFactor(const Scalar dragFactor) { _dragFactor = dragFactor; }
 
 	[[nodiscard]] Layer GetLayer() const { return _layer; }
 	void SetLayer(const Layer layer) { _layer = layer; }
@@ -178,18 +178,67 @@ struct Rigidbody
 	[[nodiscard]] BodyType GetBodyType() const { return _bodyType; }
 	void SetBodyType(const BodyType bodyType) { _bodyType = bodyType; }
 
+	/**
+	 * \brief Gets the type of the collider of this body.
+	 * It is kept up to date by the PhysicsManager when a collider or a rigidbody is added.
+	 * \return The shape type of the collider, None if the body has no collider.
+	 */
+	[[nodiscard]] ShapeType GetShapeType() const { return _shapeType; }
+	void SetShapeType(const ShapeType shapeType) { _shapeType = shapeType; }
+
+	/**
+	 * \brief Tells if the body is simulated.
+	 * Sleeping bodies are not integrated nor solved until something wakes them up.
+	 * \return True if the body is awake.
+	 */
+	[[nodiscard]] bool IsAwake() const { return _isAwake; }
+
+	/**
+	 * \brief Wakes the body up and resets its sleep timer.
+	 */
+	void WakeUp();
+
+	/**
+	 * \brief Puts the body to sleep, which stops it.
+	 * \param island Entity identifying the island the body was sleeping with.
+	 */
+	void Sleep(core::Entity island);
+
+	/**
+	 * \brief Gets the time (in seconds) during which the body has been slow enough to sleep.
+	 */
+	[[nodiscard]] Scalar SleepTime() const { return _sleepTime; }
+	void SetSleepTime(const Scalar sleepTime) { _sleepTime = sleepTime; }
+
+	/**
+	 * \brief Gets the island with which the body has been put to sleep.
+	 * Every body of an island is woken up at the same time.
+	 */
+	[[nodiscard]] core::Entity SleepIsland() const { return _sleepIsland; }
+
+	/**
+	 * \brief Tells if the body has been moved since the end of the last physics step.
+	 * It is used to know if static bodies need to be tested against sleeping bodies.
+	 */
+	[[nodiscard]] bool HasMoved() const { return _transform.position != _previousPosition; }
+
+	/**
+	 * \brief Marks the current position as the position at the end of the step.
+	 */
+	void ResetMoved() { _previousPosition = _transform.position; }
+
 private:
-	core::Vec2f _gravityAcceleration;
-	core::Vec2f _force;
-	core::Vec2f _velocity;
+	Vec2s _gravityAcceleration;
+	Vec2s _force;
+	Vec2s _velocity;
 
-	float _invMass{};
+	Scalar _invMass{};
 	bool _takesGravity = false;
 
-	float _staticFriction{};
-	float _dynamicFriction{};
-	float _restitution{};
-	float _dragFactor = 1.0f;
+	Scalar _staticFriction{};
+	Scalar _dynamicFriction{};
+	Scalar _restitution{};
+	Scalar _dragFactor = 1.0f;
 
 	Transform _transform{};
 
@@ -197,6 +246,12 @@ private:
 
 	BodyType _bodyType = BodyType::Static;
 	Layer _layer = Layer::None;
+	ShapeType _shapeType = ShapeType::None;
+
+	bool _isAwake = true;
+	Scalar _sleepTime = 0.0f;
+	core::Entity _sleepIsland = core::INVALID_ENTITY;
+	Vec2s _previousPosition{};
 };
 
 /**
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cmath>
+
+#include "maths/fixed.hpp"
+#include "maths/vec2.hpp"
+
+namespace game
+{
+/**
+ * \brief Number used by the physics for the state of the bodies and all the collision math.
+ * It is a float by default, or a fixed point number when the game is built with
+ * PHYSICS_FIXED_POINT (GPR_PHYSICS_FIXED_POINT=16 or 32), so that the simulation gives the same bits
+ * on every platform and compiler.
+ */
+#if GPR_PHYSICS_FIXED_POINT == 16
+using Scalar = core::Fixed16;
+#elif GPR_PHYSICS_FIXED_POINT == 32
+using Scalar = core::Fixed32;
+#else
+using Scalar = float;
+#endif
+
+/**
+ * \brief Vector of the physics, see Scalar.
+ */
+using Vec2s = core::Vec2<Scalar>;
+
+constexpr bool IS_PHYSICS_FIXED_POINT = core::IS_FIXED<Scalar>;
+
+#if GPR_PHYSICS_FIXED_POINT
+inline Scalar Abs(const Scalar value) { return core::Abs(value); }
+inline Scalar Sqrt(const Scalar value) { return core::Sqrt(value); }
+#else
+inline Scalar Abs(const Scalar value) { return std::abs(value); }
+inline Scalar Sqrt(const Scalar value) { return std::sqrt(value); }
+#endif
+}
@@ -1,10 +1,18 @@
 #pragma once
 
+#include <cstdint>
+#include <span>
 #include <vector>
 
 #include "physics/collision.hpp"
+#include "physics/contact_cache.hpp"
 #include "physics/rigidbody.hpp"
 
+namespace core
+{
+class ThreadPool;
+}
+
 namespace game
 {
 /**
@@ -13,7 +21,7 @@ namespace game
 class Solver
 {
 public:
-	Solver(core::EntityManager& entityManager, RigidbodyManager& rigidbodyManager);
+	Solver(core::EntityManager& entityManager, RigidbodyManager& rigidbodyManager, std::uint32_t iterations);
 
 	virtual ~Solver() = default;
 	Solver(const Solver& other) = default;
@@ -26,25 +34,127 @@ public:
 	 * \param collisions Collisions to solve.
 	 * \param deltaTime Time elapsed since the last frame.
 	 */
-	virtual void Solve(const std::vector<Collision>& collisions, float deltaTime) = 0;
+	virtual void Solve(std::span<const Collision> collisions, Scalar deltaTime) = 0;
+
+	/**
+	 * \brief Sets the number of passes done on all the collisions each time they are solved.
+	 * \param iterations Number of passes, at least one pass is always done.
+	 */
+	void SetIterations(std::uint32_t iterations);
+	[[nodiscard]] std::uint32_t Iterations() const { return _iterations; }
 
 protected:
 	core::EntityManager& _entityManager;
 	RigidbodyManager& _rigidbodyManager;
+	std::uint32_t _iterations;
 };
 
 /**
 * \brief Solver with impulse and friction.
+* The impulses are accumulated over the iterations and kept in a contact cache,
+* so a contact that persists starts the next step from the impulses of the last one.
+*
+* The contacts are colored so that two contacts of the same color never move the same body.
+* Colors are solved one after the other and the contacts of a color can be split between threads.
+* The order of the colors and the chunks only depend on the collisions, so the result
+* is the same whatever the number of threads.
 */
 class ImpulseSolver final : public Solver
 {
 public:
-	ImpulseSolver(core::EntityManager& entityManager, RigidbodyManager& rigidbodyManager)
-		: Solver(entityManager, rigidbodyManager)
+	static constexpr std::uint32_t DEFAULT_ITERATIONS = 4;
+
+	ImpulseSolver(core::EntityManager& entityManager, RigidbodyManager& rigidbodyManager,
+	              ContactCache& contactCache)
+		: Solver(entityManager, rigidbodyManager, DEFAULT_ITERATIONS), _contactCache(contactCache)
 	{
 	}
 
-	void Solve(const std::vector<Collision>& collisions, float deltaTime) override;
+	/**
+	 * \brief Maximum number of colors, the contacts that do not fit in them are solved on a single thread.
+	 */
+	static constexpr std::size_t MAX_COLOR_NMB = 64;
+
+	/**
+	 * \brief Number of contacts of a color given to a thread at once.
+	 */
+	static constexpr std::size_t CONTACTS_PER_CHUNK = 64;
+
+	void Solve(std::span<const Collision> collisions, Scalar deltaTime) override;
+
+	/**
+	 * \brief Sets the pool used to solve the contacts of a color in parallel.
+	 * \param threadPool Pool of threads, or nullptr to solve everything on the calling thread.
+	 */
+	void SetThreadPool(core::ThreadPool* threadPool) { _threadPool = threadPool; }
+
+private:
+	/**
+	 * \brief Data of a collision that stays the same during all the iterations.
+	 * Bodies without collisions are null, they are seen as not moving.
+	 */
+	struct ContactConstraint
+	{
+		core::Entity entityA = core::INVALID_ENTITY;
+		core::Entity entityB = core::INVALID_ENTITY;
+		Rigidbody* bodyA = nullptr;
+		Rigidbody* bodyB = nullptr;
+		Scalar invMassA = 0.0f;
+		Scalar invMassB = 0.0f;
+
+		Vec2s normal{};
+		Vec2s tangent{};
+
+		/**
+		 * \brief Mass seen by an impulse along the normal or the tangent.
+		 */
+		Scalar effectiveMass = 0.0f;
+
+		/**
+		 * \brief Normal velocity the contact has to reach, taken from the restitution.
+		 */
+		Scalar velocityBias = 0.0f;
+
+		Scalar staticFriction = 0.0f;
+		Scalar dynamicFriction = 0.0f;
+
+		Scalar normalImpulse = 0.0f;
+		Scalar tangentImpulse = 0.0f;
+	};
+
+	void PrepareConstraints(std::span<const Collision> collisions);
+
+	/**
+	 * \brief Sorts the constraints by color, keeping the order of the collisions inside a color.
+	 */
+	void ColorConstraints();
+
+	/**
+	 * \brief Calls the function on every constraint, color by color.
+	 */
+	template <typename Function>
+	void ForEachConstraint(Function function);
+
+	static void ApplyImpulse(const ContactConstraint& constraint, Vec2s impulse);
+	static void SolveConstraint(ContactConstraint& constraint);
+	void StoreImpulses();
+
+	ContactCache& _contactCache;
+	std::vector<ContactConstraint> _constraints;
+
+	/**
+	 * \brief Index of the first constraint of every color, with the end of the constraints at the back.
+	 * The last color holds the constraints that did not fit in the others.
+	 */
+	std::vector<std::size_t> _colorOffsets;
+
+	// Buffers used during a solve, kept as members so they are only allocated when the contacts increase
+	std::vector<std::uint64_t> _bodyColors;
+	std::vector<std::size_t> _constraintColors;
+	std::vector<ContactConstraint> _sortedConstraints;
+	std::vector<CachedContact> _cachedContacts;
+
+	core::ThreadPool* _threadPool = nullptr;
 };
 
 /**
@@ -53,11 +163,32 @@ public:
 class SmoothPositionSolver final : public Solver
 {
 public:
+	static constexpr std::uint32_t DEFAULT_ITERATIONS = 1;
+
 	SmoothPositionSolver(core::EntityManager& entityManager, RigidbodyManager& rigidbodyManager)
-		: Solver(entityManager, rigidbodyManager)
+		: Solver(entityManager, rigidbodyManager, DEFAULT_ITERATIONS)
 	{
 	}
 
-	void Solve(const std::vector<Collision>& collisions, float deltaTime) override;
+	void Solve(std::span<const Collision> collisions, Scalar deltaTime) override;
+
+private:
+	/**
+	 * \brief Data of a collision that stays the same during all the iterations.
+	 * The depth is updated with the displacement of the bodies since the start of the solve.
+	 */
+	struct PositionConstraint
+	{
+		Rigidbody* bodyA = nullptr;
+		Rigidbody* bodyB = nullptr;
+		Scalar invMassA = 0.0f;
+		Scalar invMassB = 0.0f;
+		Vec2s normal{};
+		Scalar depth = 0.0f;
+		Vec2s startPositionA{};
+		Vec2s startPositionB{};
+	};
+
+	std::vector<PositionConstraint> _constraints;
 };
 }
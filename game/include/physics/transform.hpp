@@ -3,6 +3,8 @@
 #include "maths/angle.hpp"
 #include "maths/vec2.hpp"
 
+#include "physics/scalar.hpp"
+
 namespace game
 {
 /**
@@ -16,12 +18,12 @@ public:
 	/**
 	 * \brief The position of this object.
 	 */
-	core::Vec2f position{};
+	Vec2s position{};
 
 	/**
 	 * \brief The scale of this object.
 	 */
-	core::Vec2f scale{1, 1};
+	Vec2s scale{1, 1};
 
 	/**
 	 * \brief The rotation of this object.
@@ -2,7 +2,7 @@
 
 #include <SFML/System/Clock.hpp>
 
-#include "network/network_server.hpp"
+#include "network/match_server.hpp"
 
 int main(const int argc, char** argv)
 {
@@ -13,7 +13,7 @@ int main(const int argc, char** argv)
 		port = static_cast<unsigned short>(std::stoi(portArg));
 	}
 
-	game::NetworkServer server;
+	game::MatchServer server;
 	if (port != 0)
 	{
 		server.SetTcpPort(port);
@@ -23,9 +23,11 @@ int main(const int argc, char** argv)
 	sf::Clock clock;
 	while (server.IsOpen())
 	{
+		server.WaitForEvents();
 		const auto dt = clock.restart();
 		server.Update(dt);
 	}
+	server.End();
 
 	return 0;
 }
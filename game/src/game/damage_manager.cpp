@@ -1,25 +1,11 @@
 #include "game/damage_manager.hpp"
 
-void game::DamageManager::OnCollision(const core::Entity entity1, const core::Entity entity2)
+void game::DamageManager::OnCollision(const std::span<const Collision> collisions)
 {
-	// Check the order of the entities
-	const bool oneIsDamager = _entityManager.HasComponent(entity1,
-	                                                      static_cast<core::EntityMask>(ComponentType::Damager));
-	const bool twoIsPlayer = _entityManager.HasComponent(entity2,
-	                                                     static_cast<core::EntityMask>(ComponentType::PlayerCharacter));
-
-	const bool oneIsPlayer = _entityManager.HasComponent(entity1,
-	                                                     static_cast<core::EntityMask>(ComponentType::PlayerCharacter));
-	const bool twoIsDamager = _entityManager.HasComponent(entity2,
-	                                                      static_cast<core::EntityMask>(ComponentType::Damager));
-
-	if (oneIsDamager && twoIsPlayer)
-	{
-		HandleCollision(entity2);
-	}
-	else if (oneIsPlayer && twoIsDamager)
+	// Registered with the damager first and the player second
+	for (const auto& [damagerEntity, playerEntity, _] : collisions)
 	{
-		HandleCollision(entity1);
+		HandleCollision(playerEntity);
 	}
 }
 
@@ -49,25 +49,19 @@ void game::FallingDoorManager::SetFallingDoor(const core::Entity entity, const F
 	SetComponent(entity, fallingDoor);
 }
 
-void game::FallingDoorManager::OnCollision(const core::Entity entity1, const core::Entity entity2)
+void game::FallingDoorManager::OnCollision(const std::span<const Collision> collisions)
 {
-	const bool oneIsDoor = _entityManager.HasComponent(entity1,
-		static_cast<core::EntityMask>(ComponentType::FallingDoor));
-	const bool twoIsPlayer = _entityManager.HasComponent(entity2,
-		static_cast<core::EntityMask>(ComponentType::PlayerCharacter));
-
-	const bool oneIsPlayer = _entityManager.HasComponent(entity1,
-		static_cast<core::EntityMask>(ComponentType::PlayerCharacter));
-	const bool twoIsDoor = _entityManager.HasComponent(entity2,
-		static_cast<core::EntityMask>(ComponentType::FallingDoor));
-
-	if (oneIsDoor && twoIsPlayer)
-	{
-		HandleCollision(entity1, entity2);
-	}
-	else if (oneIsPlayer && twoIsDoor)
+	// Registered with the door first and the player second
+	for (const auto& [doorEntity, playerEntity, _] : collisions)
 	{
-		HandleCollision(entity2, entity1);
+		// The door may already have been opened by another collision of this step
+		const bool isDoor = _entityManager.HasComponent(doorEntity,
+			static_cast<core::EntityMask>(ComponentType::FallingDoor));
+		const bool isDestroyed = _entityManager.HasComponent(doorEntity,
+			static_cast<core::EntityMask>(ComponentType::Destroyed));
+		if (!isDoor || isDestroyed) continue;
+
+		HandleCollision(doorEntity, playerEntity);
 	}
 }
 
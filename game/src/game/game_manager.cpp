@@ -1,12 +1,13 @@
 // ReSharper disable CppUseStructuredBinding
 #include "game/game_manager.hpp"
 
+#include <algorithm>
 #include <chrono>
+#include <limits>
 #include <imgui.h>
 
 #include "maths/basic.hpp"
 
-#include "utils/conversion.hpp"
 #include "utils/log.hpp"
 
 
@@ -213,6 +214,16 @@ void ClientGameManager::Update(const sf::Time dt)
 	}
 
 	_fixedTimer += dt.asSeconds();
+	if (_state & Started && !(_state & Finished) && _clientPlayer != INVALID_PLAYER)
+	{
+		// The frames follow the synchronized clock instead of the timer alone, so all the clients play the same frame at the same time
+		const long long frameAdvantage = GetFrameAdvantage();
+		if (frameAdvantage > MAX_FRAME_ADVANTAGE || frameAdvantage < -MAX_FRAME_ADVANTAGE)
+		{
+			_fixedTimer -= static_cast<float>(frameAdvantage) * FIXED_PERIOD;
+		}
+	}
+
 	while (_fixedTimer > FIXED_PERIOD)
 	{
 		FixedUpdate();
@@ -453,17 +464,19 @@ void ClientGameManager::FixedUpdate()
 		return;
 	}
 
+	// Only the inputs that the server has not echoed back yet are sent
 	const auto& inputs = _rollbackManager.GetInputs(playerNumber);
-	auto playerInputPacket = std::make_unique<PlayerInputPacket>();
-	playerInputPacket->playerNumber = playerNumber;
-	playerInputPacket->currentFrame = core::ConvertToBinary(_currentFrame);
-	for (size_t i = 0; i < playerInputPacket->inputs.size(); i++)
+	PlayerInputPacket playerInputPacket{};
+	playerInputPacket.playerNumber = playerNumber;
+	playerInputPacket.currentFrame = _currentFrame;
+	playerInputPacket.ackFrame = GetInputAckFrame();
+	const Frame unacknowledgedCount = _currentFrame - std::min(_sentInputAckFrame, _currentFrame) + 1;
+	playerInputPacket.inputCount = static_cast<std::uint8_t>(std::min<std::size_t>(unacknowledgedCount, MAX_INPUT_NMB));
+	for (std::size_t i = 0; i < playerInputPacket.inputCount; i++)
 	{
-		if (i > _currentFrame) break;
-
-		playerInputPacket->inputs[i] = inputs[i];
+		playerInputPacket.inputs[i] = inputs[i];
 	}
-	_packetSenderInterface.SendUnreliablePacket(std::move(playerInputPacket));
+	_packetSenderInterface.SendUnreliablePacket(playerInputPacket);
 
 
 	_currentFrame++;
@@ -478,12 +491,44 @@ void ClientGameManager::SetPlayerInput(const PlayerNumber playerNumber, const Pl
 	GameManager::SetPlayerInput(playerNumber, playerInput, inputFrame);
 }
 
+void ClientGameManager::AcknowledgeInputs(const Frame ackFrame)
+{
+	_sentInputAckFrame = std::max(_sentInputAckFrame, ackFrame);
+}
+
+Frame ClientGameManager::GetInputAckFrame() const
+{
+	Frame ackFrame = std::numeric_limits<Frame>::max();
+	for (PlayerNumber i = 0; i < MAX_PLAYER_NMB; i++)
+	{
+		if (i == _clientPlayer) continue;
+
+		ackFrame = std::min(ackFrame, _rollbackManager.GetLastReceivedFrame(i));
+	}
+	return ackFrame;
+}
+
 void ClientGameManager::StartGame(unsigned long long int startingTime)
 {
 	core::LogInfo(fmt::format("Start game at starting time: {}", startingTime));
 	_startingTime = startingTime;
 }
 
+long long ClientGameManager::GetFrameAdvantage() const
+{
+	using namespace std::chrono;
+	const auto ms = static_cast<long long>(duration_cast<milliseconds>(
+		system_clock::now().time_since_epoch()
+		).count());
+	const auto elapsed = ms - static_cast<long long>(_startingTime);
+	if (elapsed < 0) return static_cast<long long>(_currentFrame);
+
+	// The frame f starts at f * FIXED_PERIOD, the current frame is the next one to play
+	const auto fixedPeriodMs = static_cast<long long>(FIXED_PERIOD * 1000.0f);
+	const long long expectedFrame = elapsed / fixedPeriodMs + 1;
+	return static_cast<long long>(_currentFrame) - expectedFrame;
+}
+
 void ClientGameManager::DrawImGui()
 {
 	ImGui::Text(_state & Started ? "Game has started" : "Game has not started");
@@ -495,6 +540,10 @@ void ClientGameManager::DrawImGui()
 			system_clock::now().time_since_epoch()
 			).count();
 		ImGui::Text("Current Time: %llu", ms);
+		if (_state & Started)
+		{
+			ImGui::Text("Frame Advantage: %lld", GetFrameAdvantage());
+		}
 	}
 
 	ImGui::Checkbox("Draw Physics", &_drawPhysics);
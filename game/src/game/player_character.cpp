@@ -72,7 +72,7 @@ void PlayerCharacterManager::FixedUpdate(const sf::Time deltaTime)
 
 		if (input & player_input_enum::PlayerInput::Shoot && playerCharacter.hasBall)
 		{
-			const auto currentPlayerSpeed = playerBody.Velocity().GetMagnitude();
+			const auto currentPlayerSpeed = static_cast<float>(playerBody.Velocity().GetMagnitude());
 			const auto ballVelocity = playerCharacter.aimDirection *
 				((core::Vec2f::Dot(playerBody.Velocity(), playerCharacter.aimDirection) > 0.0f ? currentPlayerSpeed : 0.0f)
 				+ BALL_SPEED);
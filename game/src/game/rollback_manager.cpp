@@ -36,12 +36,17 @@ RollbackManager::RollbackManager(GameManager& gameManager, core::EntityManager&
 		std::ranges::fill(input, '\0');
 	}
 
+	constexpr auto playerMask = static_cast<core::EntityMask>(ComponentType::PlayerCharacter);
+	constexpr auto ballMask = static_cast<core::EntityMask>(ComponentType::Bullet);
+	constexpr auto doorMask = static_cast<core::EntityMask>(ComponentType::FallingDoor);
+	constexpr auto damagerMask = static_cast<core::EntityMask>(ComponentType::Damager);
+
 	_currentPhysicsManager.RegisterTriggerListener(*this);
-	_currentPhysicsManager.RegisterCollisionListener(*this);
-	_currentPhysicsManager.RegisterCollisionListener(_currentFallingDoorManager);
-	_lastValidatePhysicsManager.RegisterCollisionListener(_lastValidateFallingDoorManager);
-	_currentPhysicsManager.RegisterCollisionListener(_currentDamageManager);
-	_lastValidatePhysicsManager.RegisterCollisionListener(_lastValidateDamageManager);
+	_currentPhysicsManager.RegisterCollisionListener(*this, playerMask, ballMask);
+	_currentPhysicsManager.RegisterCollisionListener(_currentFallingDoorManager, doorMask, playerMask);
+	_lastValidatePhysicsManager.RegisterCollisionListener(_lastValidateFallingDoorManager, doorMask, playerMask);
+	_currentPhysicsManager.RegisterCollisionListener(_currentDamageManager, damagerMask, playerMask);
+	_lastValidatePhysicsManager.RegisterCollisionListener(_lastValidateDamageManager, damagerMask, playerMask);
 }
 
 void RollbackManager::SimulateToCurrentFrame()
@@ -300,14 +305,14 @@ PhysicsState RollbackManager::GetValidatePhysicsState(const PlayerNumber playerN
 	const auto* posPtr = reinterpret_cast<const PhysicsState*>(&pos);
 
 	// Adding position
-	for (size_t i = 0; i < sizeof(core::Vec2f) / sizeof(PhysicsState); i++)
+	for (size_t i = 0; i < sizeof(Vec2s) / sizeof(PhysicsState); i++)
 	{
 		state += posPtr[i];
 	}
 
 	// Adding velocity
 	const auto* velocityPtr = reinterpret_cast<const PhysicsState*>(&rigidbody.Velocity());
-	for (size_t i = 0; i < sizeof(core::Vec2f) / sizeof(PhysicsState); i++)
+	for (size_t i = 0; i < sizeof(Vec2s) / sizeof(PhysicsState); i++)
 	{
 		state += velocityPtr[i];
 	}
@@ -333,6 +338,17 @@ void RollbackManager::SetupLevel(const core::Entity wallLeftEntity, const core::
 	CreateWall(wallBottomEntity, WALL_BOTTOM_POS, HORIZONTAL_WALLS_SIZE);
 	CreateWall(wallTopEntity, WALL_TOP_POS, HORIZONTAL_WALLS_SIZE);
 
+	// The walls are much longer than the arena, so the broad phase only covers the inside of the walls.
+	// Falling walls and anything outside of it end up in the overflow bucket of the grid.
+	const core::Vec2f levelMin{
+		WALL_LEFT_POS.x - VERTICAL_WALLS_SIZE.x, WALL_BOTTOM_POS.y - HORIZONTAL_WALLS_SIZE.y
+	};
+	const core::Vec2f levelMax{
+		WALL_RIGHT_POS.x + VERTICAL_WALLS_SIZE.x, WALL_TOP_POS.y + HORIZONTAL_WALLS_SIZE.y
+	};
+	_currentPhysicsManager.SetWorldBounds(levelMin, levelMax);
+	_lastValidatePhysicsManager.SetWorldBounds(levelMin, levelMax);
+
 	_currentDamageManager.AddComponent(wallBottomEntity);
 	_lastValidateDamageManager.AddComponent(wallBottomEntity);
 }
@@ -473,38 +489,28 @@ PlayerInput RollbackManager::GetInputAtFrame(const PlayerNumber playerNumber, co
 	return _inputs[playerNumber][frameDifference];
 }
 
-void RollbackManager::OnTrigger(const core::Entity, const core::Entity)
+void RollbackManager::OnTrigger(std::span<const Collision>)
 {
 }
 
-void RollbackManager::OnCollision(const core::Entity entity1, const core::Entity entity2)
+void RollbackManager::OnCollision(const std::span<const Collision> collisions)
 {
-	const auto manageCollision =
-		[this](const core::Entity playerEntity, const core::Entity ballEntity)
+	// Registered with the player first and the ball second
+	for (const auto& [playerEntity, ballEntity, _] : collisions)
 	{
+		// The ball may already have been caught by another player during this step
+		const bool isBall = _entityManager.HasComponent(ballEntity,
+		                                                static_cast<core::EntityMask>(ComponentType::Bullet));
+		const bool isDestroyed = _entityManager.HasComponent(ballEntity,
+		                                                     static_cast<core::EntityMask>(ComponentType::Destroyed));
+		if (!isBall || isDestroyed) continue;
+
 		PlayerCharacter& playerCharacter = _currentPlayerManager.GetComponent(playerEntity);
 		if (!playerCharacter.hasBall)
 		{
 			_gameManager.DestroyEntity(ballEntity);
 			playerCharacter.CatchBall();
 		}
-	};
-
-	const auto arePlayerAndBullet = [this](const core::Entity firstEntity, const core::Entity secondEntity)
-	{
-		return _entityManager.HasComponent(firstEntity, static_cast<core::EntityMask>(ComponentType::PlayerCharacter))
-			&&
-			_entityManager.HasComponent(secondEntity, static_cast<core::EntityMask>(ComponentType::Bullet));
-	};
-
-	if (arePlayerAndBullet(entity1, entity2))
-	{
-		manageCollision(entity1, entity2);
-	}
-
-	if (arePlayerAndBullet(entity2, entity1))
-	{
-		manageCollision(entity2, entity1);
 	}
 }
 
@@ -1,10 +1,6 @@
-// ReSharper disable CppClangTidyCppcoreguidelinesProTypeStaticCastDowncast
 #include "network/client.hpp"
 
-#include "maths/basic.hpp"
-
 #include "utils/assert.hpp"
-#include "utils/conversion.hpp"
 
 #ifdef TRACY_ENABLE
 #include <Tracy.hpp>
@@ -12,104 +8,64 @@
 
 namespace game
 {
-void Client::ReceivePacket(const Packet* packet)
+void Client::ReceivePacket(const Packet& packet)
 {
 	#ifdef TRACY_ENABLE
 	ZoneScoped;
 	#endif
 
-	switch (packet->packetType)
+	switch (GetPacketType(packet))
 	{
 	case PacketType::SpawnPlayer:
 		{
-			const auto* spawnPlayerPacket = static_cast<const SpawnPlayerPacket*>(packet);
-			const auto clientId = core::ConvertFromBinary<ClientId>(spawnPlayerPacket->clientId);
-
-			const PlayerNumber playerNumber = spawnPlayerPacket->playerNumber;
-			if (clientId == _clientId)
+			const auto& spawnPlayerPacket = std::get<SpawnPlayerPacket>(packet);
+			const PlayerNumber playerNumber = spawnPlayerPacket.playerNumber;
+			if (spawnPlayerPacket.clientId == _clientId)
 			{
 				_gameManager.SetClientPlayer(playerNumber);
 			}
 
-			const auto pos = core::ConvertFromBinary<core::Vec2f>(spawnPlayerPacket->pos);
-			const auto rotation = core::ConvertFromBinary<core::Degree>(spawnPlayerPacket->angle);
-
-			_gameManager.SpawnPlayer(playerNumber, pos, rotation);
+			_gameManager.SpawnPlayer(playerNumber, spawnPlayerPacket.pos, spawnPlayerPacket.angle);
 			break;
 		}
 	case PacketType::StartGame:
 		{
 			core::LogInfo("Start Game Packet Received");
-			using namespace std::chrono;
-			const auto startingTime = (duration_cast<duration<long long, std::milli>>(
-				system_clock::now().time_since_epoch()
-			) + milliseconds(START_DELAY)).count() - milliseconds(static_cast<long long>(_currentPing)).count();
-
-			_gameManager.StartGame(startingTime);
-			break;
-		}
-	case PacketType::Input:
-		{
-			const auto* playerInputPacket = static_cast<const PlayerInputPacket*>(packet);
-			const auto playerNumber = playerInputPacket->playerNumber;
-			const auto inputFrame = core::ConvertFromBinary<Frame>(playerInputPacket->currentFrame);
-
-			if (playerNumber == _gameManager.GetPlayerNumber())
+			_serverStartingTime = std::get<StartGamePacket>(packet).startTime;
+			if (_clockOffsetEstimator.HasSample())
 			{
-				// Verify the inputs coming back from the server
-				const auto& inputs = _gameManager.GetRollbackManager().GetInputs(playerNumber);
-				const auto currentFrame = _gameManager.GetRollbackManager().GetCurrentFrame();
-				for (size_t i = 0; i < playerInputPacket->inputs.size(); i++)
-				{
-					const auto index = static_cast<unsigned long long>(currentFrame) - inputFrame + i;
-					if (index > inputs.size()) break;
-
-					if (inputs[index] != playerInputPacket->inputs[i])
-					{
-						gpr_assert(false, "Inputs coming back from server are not coherent!!!");
-					}
-
-					if (inputFrame - i == 0) break;
-				}
-				break;
+				_gameManager.StartGame(_clockOffsetEstimator.ToClientTime(_serverStartingTime));
 			}
-
-			//discard delayed input packet
-			if (inputFrame < _gameManager.GetRollbackManager().GetLastReceivedFrame(playerNumber))
+			else
 			{
-				break;
-			}
-
-			for (Frame i = 0; i < playerInputPacket->inputs.size(); i++)
-			{
-				_gameManager.SetPlayerInput(playerNumber,
-				                            playerInputPacket->inputs[i],
-				                            inputFrame - i);
-
-				if (inputFrame - i == 0)
-				{
-					break;
-				}
+				// Without any ping back, the packet is assumed to have taken half of the round trip
+				const auto startingTime = GetSystemTime() + static_cast<std::uint64_t>(START_DELAY) -
+					static_cast<std::uint64_t>(_currentPing / 2.0f);
+				_gameManager.StartGame(startingTime);
 			}
 			break;
 		}
-	case PacketType::ValidateState:
+	case PacketType::ServerInputs:
 		{
-			const auto* validateFramePacket = static_cast<const ValidateFramePacket*>(packet);
-			const auto newValidateFrame = core::ConvertFromBinary<Frame>(validateFramePacket->newValidateFrame);
-			std::array<PhysicsState, MAX_PLAYER_NMB> physicsStates{};
-			for (size_t i = 0; i < validateFramePacket->physicsState.size(); i++)
+			const auto& serverInputsPacket = std::get<ServerInputsPacket>(packet);
+			for (PlayerNumber playerNumber = 0; playerNumber < MAX_PLAYER_NMB; playerNumber++)
 			{
-				auto* statePtr = reinterpret_cast<std::uint8_t*>(physicsStates.data());
-				statePtr[i] = validateFramePacket->physicsState[i];
+				const auto inputCount = serverInputsPacket.inputCounts[playerNumber];
+				ReceivePlayerInputs(playerNumber, serverInputsPacket.lastReceivedFrames[playerNumber],
+				                    std::span(serverInputsPacket.inputs[playerNumber].data(), inputCount));
 			}
-			_gameManager.ConfirmValidateFrame(newValidateFrame, physicsStates);
+
+			// The validate frame is sent again until a newer one replaces it
+			const Frame newValidateFrame = serverInputsPacket.validateFrame;
+			if (newValidateFrame <= _gameManager.GetLastValidateFrame()) break;
+
+			_gameManager.ConfirmValidateFrame(newValidateFrame, serverInputsPacket.physicsStates);
 			break;
 		}
 	case PacketType::LoseGame:
 		{
-			const auto* loseGamePacket = static_cast<const LoseGamePacket*>(packet);
-			if (loseGamePacket->hasLost)
+			const auto& loseGamePacket = std::get<LoseGamePacket>(packet);
+			if (loseGamePacket.hasLost)
 			{
 				_gameManager.LoseGame();
 			}
@@ -117,39 +73,27 @@ void Client::ReceivePacket(const Packet* packet)
 		}
 	case PacketType::Ping:
 		{
-			const auto* pingPacket = static_cast<const PingPacket*>(packet);
-			const auto clientId = core::ConvertFromBinary<ClientId>(pingPacket->clientId);
-			if (clientId == _clientId)
+			const auto& pingPacket = std::get<PingPacket>(packet);
+			if (pingPacket.clientId == _clientId)
 			{
-				const auto originTime = core::ConvertFromBinary<unsigned long long>(pingPacket->time);
-				using namespace std::chrono;
-				const auto currentTime = duration_cast<duration<unsigned long long, std::milli>>(
-					system_clock::now().time_since_epoch()
-				).count();
+				const auto originTime = pingPacket.time;
+				const auto currentTime = GetSystemTime();
 				const auto delta = currentTime - originTime;
 				const auto ping = static_cast<float>(delta);
 
 				//calculate average and var ping
-				if (_srtt < 0.0f)
-				{
-					_srtt = ping;
-					_rttvar = ping / 2.0f;
-				}
-				else
-				{
-					_srtt = (1.0f - ALPHA) * _srtt + ALPHA * ping;
-					_rttvar = (1.0f - BETA) * _rttvar + BETA * core::Abs(_srtt - ping);
-				}
-
-				_rto = _srtt + std::max(G, K * _rttvar);
-				_currentPing = _srtt;
+				_rttEstimator.AddSample(ping);
+				_currentPing = _rttEstimator.GetSmoothedRtt();
+
+				_clockOffsetEstimator.AddSample(originTime, pingPacket.serverTime, currentTime);
+				UpdateStartingTime();
 			}
 			break;
 		}
 	case PacketType::SpawnFallingWall:
 		{
-			const auto* spawnFallingWallPacket = static_cast<const SpawnFallingWallPacket*>(packet);
-			const auto spawnFrame = core::ConvertFromBinary<Frame>(spawnFallingWallPacket->spawnFrame);
+			const auto& spawnFallingWallPacket = std::get<SpawnFallingWallPacket>(packet);
+			const Frame spawnFrame = spawnFallingWallPacket.spawnFrame;
 			if (spawnFrame <= _gameManager.GetRollbackManager().GetCurrentFrame())
 			{
 				core::LogWarning("Spawn frame is smaller than current frame.");
@@ -158,9 +102,8 @@ void Client::ReceivePacket(const Packet* packet)
 
 			FallingWallSpawnInstructions fallingWallSpawnInstructions{};
 			fallingWallSpawnInstructions.spawnFrame = spawnFrame;
-			fallingWallSpawnInstructions.doorPosition = core::ConvertFromBinary<float>(
-				spawnFallingWallPacket->doorPosition);
-			fallingWallSpawnInstructions.requiresBall = spawnFallingWallPacket->requiresBall;
+			fallingWallSpawnInstructions.doorPosition = spawnFallingWallPacket.doorPosition;
+			fallingWallSpawnInstructions.requiresBall = spawnFallingWallPacket.requiresBall;
 
 			_gameManager.SetFallingWallSpawnInstructions(fallingWallSpawnInstructions);
 			break;
@@ -170,6 +113,58 @@ void Client::ReceivePacket(const Packet* packet)
 	}
 }
 
+void Client::ReceivePlayerInputs(const PlayerNumber playerNumber, const Frame inputFrame,
+                                 const std::span<const PlayerInput> inputs)
+{
+	if (playerNumber == _gameManager.GetPlayerNumber())
+	{
+		// Verify the inputs coming back from the server
+		const auto& localInputs = _gameManager.GetRollbackManager().GetInputs(playerNumber);
+		const auto currentFrame = _gameManager.GetRollbackManager().GetCurrentFrame();
+		for (size_t i = 0; i < inputs.size(); i++)
+		{
+			const auto index = static_cast<unsigned long long>(currentFrame) - inputFrame + i;
+			if (index >= localInputs.size()) break;
+
+			if (localInputs[index] != inputs[i])
+			{
+				gpr_assert(false, "Inputs coming back from server are not coherent!!!");
+			}
+
+			if (inputFrame - i == 0) break;
+		}
+
+		// The last frame received by the server is the acknowledgement, the next packets start from it
+		_gameManager.AcknowledgeInputs(inputFrame);
+		return;
+	}
+
+	//discard delayed inputs
+	if (inputFrame < _gameManager.GetRollbackManager().GetLastReceivedFrame(playerNumber))
+	{
+		return;
+	}
+
+	for (Frame i = 0; i < inputs.size(); i++)
+	{
+		_gameManager.SetPlayerInput(playerNumber,
+		                            inputs[i],
+		                            inputFrame - i);
+
+		if (inputFrame - i == 0)
+		{
+			break;
+		}
+	}
+}
+
+void Client::UpdateStartingTime()
+{
+	if (_serverStartingTime == 0 || !_clockOffsetEstimator.HasSample()) return;
+
+	_gameManager.SetStartingTime(_clockOffsetEstimator.ToClientTime(_serverStartingTime));
+}
+
 void Client::Update(const sf::Time dt)
 {
 	#ifdef TRACY_ENABLE
@@ -181,14 +176,12 @@ void Client::Update(const sf::Time dt)
 	{
 		if (_clientId != INVALID_CLIENT_ID)
 		{
-			using namespace std::chrono;
-			auto pingPacket = std::make_unique<PingPacket>();
-			pingPacket->time = core::ConvertToBinary(duration_cast<duration<unsigned long long, std::milli>>(
-				system_clock::now().time_since_epoch()).count());
-			pingPacket->clientId = core::ConvertToBinary(_clientId);
-			SendUnreliablePacket(std::move(pingPacket));
+			PingPacket pingPacket{};
+			pingPacket.time = GetSystemTime();
+			pingPacket.clientId = _clientId;
+			SendUnreliablePacket(pingPacket);
 		}
-		_pingTimer = PING_PERIOD_;
+		_pingTimer = _clockOffsetEstimator.IsSynchronized() ? PING_PERIOD_ : SYNCHRONIZATION_PING_PERIOD_;
 	}
 }
 }
@@ -0,0 +1,103 @@
+#include "network/clock_offset_estimator.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <span>
+
+namespace game
+{
+std::uint64_t GetSystemTime()
+{
+	using namespace std::chrono;
+	return static_cast<std::uint64_t>(duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count());
+}
+
+void ClockOffsetEstimator::AddSample(const std::uint64_t clientSendTime, const std::uint64_t serverTime,
+                                     const std::uint64_t clientReceiveTime)
+{
+	// A clock that went back gives a round trip that has no meaning
+	if (clientReceiveTime < clientSendTime) return;
+
+	Sample& sample = _samples[_sampleCount % SAMPLE_COUNT];
+	sample.rtt = static_cast<double>(clientReceiveTime - clientSendTime);
+	sample.clientTime = static_cast<double>(clientSendTime) + sample.rtt / 2.0;
+	sample.offset = static_cast<double>(serverTime) - sample.clientTime;
+	_sampleCount++;
+
+	if (_sampleCount % SAMPLE_COUNT == 0)
+	{
+		_driftPoints[_driftPointCount % DRIFT_POINT_COUNT] = std::ranges::min(_samples, {}, &Sample::rtt);
+		_driftPointCount++;
+		FitDrift();
+	}
+	FitSamples();
+}
+
+double ClockOffsetEstimator::GetOffset(const std::uint64_t clientTime) const
+{
+	return _offset + _drift * (static_cast<double>(clientTime) - _referenceTime);
+}
+
+std::uint64_t ClockOffsetEstimator::ToClientTime(const std::uint64_t serverTime) const
+{
+	// The drift is small enough that the offset at the server time is the one at the client time
+	const double clientTime = static_cast<double>(serverTime) - GetOffset(serverTime);
+	return static_cast<std::uint64_t>(std::llround(clientTime));
+}
+
+void ClockOffsetEstimator::FitSamples()
+{
+	const std::size_t count = std::min(_sampleCount, SAMPLE_COUNT);
+	const auto samples = std::span(_samples.data(), count);
+
+	_minRtt = std::ranges::min(samples, {}, &Sample::rtt).rtt;
+
+	// The samples delayed by a queue on the way are left out, their offset is wrong by half the delay
+	double timeSum = 0.0;
+	double offsetSum = 0.0;
+	std::size_t usedCount = 0;
+	for (const Sample& sample : samples)
+	{
+		if (sample.rtt > _minRtt + RTT_TOLERANCE) continue;
+
+		timeSum += sample.clientTime;
+		offsetSum += sample.offset;
+		usedCount++;
+	}
+
+	_referenceTime = timeSum / static_cast<double>(usedCount);
+	_offset = offsetSum / static_cast<double>(usedCount);
+}
+
+void ClockOffsetEstimator::FitDrift()
+{
+	const std::size_t count = std::min(_driftPointCount, DRIFT_POINT_COUNT);
+	const auto points = std::span(_driftPoints.data(), count);
+
+	const double firstTime = std::ranges::min(points, {}, &Sample::clientTime).clientTime;
+	const double lastTime = std::ranges::max(points, {}, &Sample::clientTime).clientTime;
+	if (lastTime - firstTime < MIN_DRIFT_SPAN) return;
+
+	double timeSum = 0.0;
+	double offsetSum = 0.0;
+	for (const Sample& point : points)
+	{
+		timeSum += point.clientTime;
+		offsetSum += point.offset;
+	}
+	const double meanTime = timeSum / static_cast<double>(count);
+	const double meanOffset = offsetSum / static_cast<double>(count);
+
+	// Least squares line through the points, centered on their mean time
+	double timeOffsetSum = 0.0;
+	double timeSquareSum = 0.0;
+	for (const Sample& point : points)
+	{
+		const double time = point.clientTime - meanTime;
+		timeOffsetSum += time * (point.offset - meanOffset);
+		timeSquareSum += time * time;
+	}
+	_drift = std::clamp(timeOffsetSum / timeSquareSum, -MAX_DRIFT, MAX_DRIFT);
+}
+}
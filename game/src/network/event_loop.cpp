@@ -0,0 +1,187 @@
+#include "network/event_loop.hpp"
+
+#ifdef __linux__
+#include <algorithm>
+#include <span>
+
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#endif
+
+#include "utils/log.hpp"
+
+#ifdef TRACY_ENABLE
+#include <Tracy.hpp>
+#endif
+
+namespace game
+{
+#ifdef __linux__
+namespace
+{
+/**
+ * \brief SFML keeps the handles of its sockets protected, they are read through a member pointer of a derived class.
+ */
+struct SocketHandleAccess : sf::Socket
+{
+	static sf::SocketHandle Get(const sf::Socket& socket)
+	{
+		return (socket.*&SocketHandleAccess::getHandle)();
+	}
+};
+}
+
+EventLoop::EventLoop()
+	: _epollFd(epoll_create1(EPOLL_CLOEXEC)),
+	  _timerFd(timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC))
+{
+	if (_epollFd < 0 || _timerFd < 0)
+	{
+		core::LogError("[Network] Could not create the event loop");
+		return;
+	}
+
+	epoll_event event{};
+	event.events = EPOLLIN;
+	event.data.fd = _timerFd;
+	epoll_ctl(_epollFd, EPOLL_CTL_ADD, _timerFd, &event);
+}
+
+EventLoop::~EventLoop()
+{
+	if (_timerFd >= 0) close(_timerFd);
+	if (_epollFd >= 0) close(_epollFd);
+}
+
+void EventLoop::AddSocket(sf::Socket& socket)
+{
+	epoll_event event{};
+	event.events = EPOLLIN;
+	event.data.fd = SocketHandleAccess::Get(socket);
+	if (epoll_ctl(_epollFd, EPOLL_CTL_ADD, event.data.fd, &event) != 0)
+	{
+		core::LogError("[Network] Could not add a socket to the event loop");
+	}
+}
+
+void EventLoop::RemoveSocket(sf::Socket& socket)
+{
+	epoll_ctl(_epollFd, EPOLL_CTL_DEL, SocketHandleAccess::Get(socket), nullptr);
+}
+
+void EventLoop::SetWriteInterest(sf::Socket& socket, const bool isInterested)
+{
+	epoll_event event{};
+	event.events = isInterested ? EPOLLIN | EPOLLOUT : EPOLLIN;
+	event.data.fd = SocketHandleAccess::Get(socket);
+	epoll_ctl(_epollFd, EPOLL_CTL_MOD, event.data.fd, &event);
+}
+
+void EventLoop::SetTickPeriod(const sf::Time period)
+{
+	const std::int64_t periodMicroseconds = period.asMicroseconds();
+	itimerspec timerSpec{};
+	timerSpec.it_interval.tv_sec = static_cast<time_t>(periodMicroseconds / 1'000'000);
+	timerSpec.it_interval.tv_nsec = static_cast<long>(periodMicroseconds % 1'000'000 * 1'000);
+	// A zero value disarms the timer
+	timerSpec.it_value = timerSpec.it_interval;
+	timerfd_settime(_timerFd, 0, &timerSpec, nullptr);
+}
+
+std::uint64_t EventLoop::Wait()
+{
+	#ifdef TRACY_ENABLE
+	ZoneScoped;
+	#endif
+
+	std::array<epoll_event, MAX_EVENT_COUNT> events{};
+	const int eventCount = epoll_wait(_epollFd, events.data(), static_cast<int>(events.size()), -1);
+
+	std::uint64_t tickCount = 0;
+	_readyCount = 0;
+	for (int i = 0; i < eventCount; i++)
+	{
+		if (events[i].data.fd != _timerFd)
+		{
+			// A socket that is only writable has nothing to read, the update sends its bytes anyway
+			if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+			{
+				_readyHandles[_readyCount] = events[i].data.fd;
+				_readyCount++;
+			}
+			continue;
+		}
+
+		std::uint64_t expirations = 0;
+		if (read(_timerFd, &expirations, sizeof(expirations)) == sizeof(expirations))
+		{
+			tickCount += expirations;
+		}
+	}
+	return tickCount;
+}
+
+bool EventLoop::IsReady(sf::Socket& socket) const
+{
+	const auto readyHandles = std::span(_readyHandles.data(), _readyCount);
+	return std::ranges::find(readyHandles, SocketHandleAccess::Get(socket)) != readyHandles.end();
+}
+#else
+EventLoop::EventLoop() = default;
+
+EventLoop::~EventLoop() = default;
+
+void EventLoop::AddSocket(sf::Socket& socket)
+{
+	_selector.add(socket);
+}
+
+void EventLoop::RemoveSocket(sf::Socket& socket)
+{
+	_selector.remove(socket);
+}
+
+void EventLoop::SetWriteInterest([[maybe_unused]] sf::Socket& socket, [[maybe_unused]] const bool isInterested)
+{
+}
+
+void EventLoop::SetTickPeriod(const sf::Time period)
+{
+	_tickPeriodMicroseconds = period.asMicroseconds();
+	_tickElapsedMicroseconds = 0;
+	_clock.restart();
+}
+
+std::uint64_t EventLoop::Wait()
+{
+	#ifdef TRACY_ENABLE
+	ZoneScoped;
+	#endif
+
+	if (_tickPeriodMicroseconds <= 0)
+	{
+		_selector.wait();
+		return 0;
+	}
+
+	// A zero timeout waits forever, so the selector is not used when the tick has already expired
+	const std::int64_t untilTick = _tickPeriodMicroseconds - _tickElapsedMicroseconds - _clock.getElapsedTime().
+		asMicroseconds();
+	if (untilTick > 0)
+	{
+		_selector.wait(sf::microseconds(untilTick));
+	}
+
+	_tickElapsedMicroseconds += _clock.restart().asMicroseconds();
+	const std::int64_t tickCount = _tickElapsedMicroseconds / _tickPeriodMicroseconds;
+	_tickElapsedMicroseconds -= tickCount * _tickPeriodMicroseconds;
+	return static_cast<std::uint64_t>(tickCount);
+}
+
+bool EventLoop::IsReady(sf::Socket& socket) const
+{
+	return _selector.isReady(socket);
+}
+#endif
+}
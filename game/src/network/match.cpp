@@ -0,0 +1,70 @@
+#include "network/match.hpp"
+
+#ifdef TRACY_ENABLE
+#include <Tracy.hpp>
+#endif
+
+namespace game
+{
+void Match::SendReliablePacket(const Packet& packet)
+{
+	_outgoingPackets.push_back({packet, true});
+}
+
+void Match::SendUnreliablePacket(const Packet& packet)
+{
+	_outgoingPackets.push_back({packet, false});
+}
+
+void Match::Begin()
+{
+	_gameManager.SetupLevel();
+}
+
+void Match::Update([[maybe_unused]] const sf::Time dt)
+{
+	#ifdef TRACY_ENABLE
+	ZoneScoped;
+	#endif
+
+	for (const Packet& packet : _receivedPackets)
+	{
+		ReceivePacket(packet);
+	}
+	_receivedPackets.clear();
+
+	// Only one packet is sent even if the match is late, it always carries all the inputs that are not acknowledged
+	if (_pendingTickCount > 0 && IsFull() && !HasEnded())
+	{
+		SendServerInputsPacket();
+	}
+	_pendingTickCount = 0;
+}
+
+void Match::End()
+{
+}
+
+void Match::PushReceivedPacket(const Packet& packet)
+{
+	_receivedPackets.push_back(packet);
+}
+
+void Match::SpawnNewPlayer(const ClientId clientId, const PlayerNumber newPlayerNumber)
+{
+	const core::Vec2f pos = SPAWN_POSITIONS[newPlayerNumber] * 3.0f;
+	constexpr auto rotation = core::Degree(0);
+	_gameManager.SpawnPlayer(newPlayerNumber, pos, rotation);
+
+	// The new client also needs the players that joined before it
+	for (PlayerNumber playerNumber = 0; playerNumber <= newPlayerNumber; playerNumber++)
+	{
+		SpawnPlayerPacket spawnPlayer{};
+		spawnPlayer.clientId = playerNumber == newPlayerNumber ? clientId : _clientMap[playerNumber];
+		spawnPlayer.playerNumber = playerNumber;
+		spawnPlayer.pos = SPAWN_POSITIONS[playerNumber] * 3.0f;
+		spawnPlayer.angle = rotation;
+		SendReliablePacket(spawnPlayer);
+	}
+}
+}
@@ -0,0 +1,586 @@
+#include "network/match_server.hpp"
+
+#include <algorithm>
+
+#include <fmt/format.h>
+
+#include "network/clock_offset_estimator.hpp"
+
+#include "utils/log.hpp"
+
+#ifdef TRACY_ENABLE
+#include <Tracy.hpp>
+#endif
+
+namespace game
+{
+MatchServer::MatchServer(const std::size_t threadCount)
+	: _scheduler(threadCount)
+{
+}
+
+void MatchServer::Begin()
+{
+	#ifdef TRACY_ENABLE
+	ZoneScoped;
+	#endif
+
+	sf::Socket::Status status = sf::Socket::Error;
+	while (status != sf::Socket::Done)
+	{
+		// bind the listener to a port
+		status = _tcpListener.listen(_tcpPort);
+		if (status != sf::Socket::Done)
+		{
+			_tcpPort++;
+		}
+	}
+
+	_tcpListener.setBlocking(false);
+	core::LogInfo(fmt::format("[Server] Tcp Socket on port: {}", _tcpPort));
+
+	status = sf::Socket::Error;
+	while (status != sf::Socket::Done)
+	{
+		status = _udpSocket.bind(_udpPort);
+		if (status != sf::Socket::Done)
+		{
+			_udpPort++;
+		}
+	}
+
+	_udpSocket.setBlocking(false);
+	core::LogInfo(fmt::format("[Server] Udp Socket on port: {}", _udpPort));
+	core::LogInfo(fmt::format("[Server] Updating the matches on {} threads", _scheduler.ThreadCount()));
+
+	_eventLoop.AddSocket(_tcpListener);
+	_eventLoop.AddSocket(_udpSocket);
+
+	_isOpen = true;
+}
+
+void MatchServer::WaitForEvents()
+{
+	_pendingTickCount += _eventLoop.Wait();
+}
+
+void MatchServer::Update([[maybe_unused]] const sf::Time dt)
+{
+	#ifdef TRACY_ENABLE
+	ZoneScoped;
+	#endif
+
+	AcceptConnections();
+	ReceiveTcpPackets();
+	ReceiveUdpPackets();
+
+	if (_pendingTickCount > 0)
+	{
+		for (auto& [matchId, matchSlot] : _matches)
+		{
+			// A match only sends the inputs once all its players have joined
+			if (!matchSlot.match->IsFull()) continue;
+
+			matchSlot.match->AddPendingTicks(_pendingTickCount);
+			matchSlot.hasWork = true;
+		}
+		_pendingTickCount = 0;
+	}
+
+	UpdateMatches();
+	DisconnectSilentClients();
+	FlushReliableChannels();
+	FlushTcpSends();
+	RemoveEndedMatches();
+	_udpSocket.FlushSends();
+	UpdateTickTimer();
+}
+
+void MatchServer::End()
+{
+	for (const auto& connection : _connections)
+	{
+		if (!connection->isUsingTcp) continue;
+
+		_eventLoop.RemoveSocket(connection->socket);
+		connection->socket.disconnect();
+	}
+	_connections.clear();
+	_udpConnections.clear();
+	_matches.clear();
+	_openMatchId = NO_MATCH;
+
+	_eventLoop.RemoveSocket(_tcpListener);
+	_eventLoop.RemoveSocket(_udpSocket);
+	_tcpListener.close();
+	_udpSocket.unbind();
+	UpdateTickTimer();
+	_isOpen = false;
+}
+
+void MatchServer::SetTcpPort(const unsigned short port)
+{
+	_tcpPort = port;
+}
+
+void MatchServer::AcceptConnections()
+{
+	if (!_eventLoop.IsReady(_tcpListener)) return;
+
+	while (true)
+	{
+		if (_nextConnection == nullptr)
+		{
+			_nextConnection = std::make_unique<Connection>();
+			// The accepted socket keeps the blocking mode of the sf::TcpSocket
+			_nextConnection->socket.setBlocking(false);
+		}
+
+		if (_tcpListener.accept(_nextConnection->socket) != sf::Socket::Done) return;
+
+		core::LogInfo(fmt::format("[Server] New player connection with address: {} and port: {}",
+		                          _nextConnection->socket.getRemoteAddress().toString(),
+		                          _nextConnection->socket.getRemotePort()));
+		_eventLoop.AddSocket(_nextConnection->socket);
+		_connections.push_back(std::move(_nextConnection));
+	}
+}
+
+void MatchServer::ReceiveTcpPackets()
+{
+	// Connections can be added by the loop, so they are accessed by index
+	for (std::size_t i = 0; i < _connections.size(); i++)
+	{
+		Connection& connection = *_connections[i];
+		if (connection.isDisconnected || !connection.isUsingTcp || !_eventLoop.IsReady(connection.socket)) continue;
+
+		const auto status = connection.receiver.Receive(connection.socket);
+		while (auto packet = connection.receiver.PopPacket())
+		{
+			ReceiveTcpPacket(connection, *packet);
+		}
+
+		if (status == sf::Socket::Disconnected || status == sf::Socket::Error)
+		{
+			DisconnectClient(connection);
+		}
+	}
+}
+
+void MatchServer::ReceiveUdpPackets()
+{
+	_udpSocket.ReceiveAll([this](const Datagram& datagram)
+	{
+		if (const auto packet = ReadPacket(std::span(datagram.data.data(), datagram.size)))
+		{
+			ReceiveUdpPacket(datagram, *packet);
+		}
+	});
+}
+
+void MatchServer::ReceiveTcpPacket(Connection& connection, const Packet& packet)
+{
+	if (GetPacketType(packet) != PacketType::Join)
+	{
+		core::LogWarning(fmt::format("[Server] Unexpected TCP packet: {}",
+		                             static_cast<int>(GetPacketType(packet))));
+		return;
+	}
+
+	if (connection.matchId != NO_MATCH || connection.isClosing) return;
+
+	JoinMatch(connection, std::get<JoinPacket>(packet));
+}
+
+void MatchServer::ReceiveUdpPacket(const Datagram& datagram, const Packet& packet)
+{
+	if (GetPacketType(packet) == PacketType::Join)
+	{
+		const auto& joinPacket = std::get<JoinPacket>(packet);
+		const auto it = std::ranges::find_if(_connections, [&](const auto& connection)
+		{
+			return connection->matchId != NO_MATCH && connection->clientId == joinPacket.clientId;
+		});
+		if (it == _connections.end())
+		{
+			// A client without TCP joins a match with its first UDP join
+			auto& connection = _connections.emplace_back(std::make_unique<Connection>());
+			connection->isUsingTcp = false;
+			connection->udpAddress = datagram.address;
+			connection->udpPort = datagram.port;
+			connection->lastReceiveTime = GetChannelTime();
+			_udpConnections[GetEndpointKey(datagram.address, datagram.port)] = connection.get();
+			JoinMatch(*connection, joinPacket);
+			return;
+		}
+
+		// The client sends its join until it is acknowledged, so it can be received several times
+		Connection& connection = **it;
+		const sf::IpAddress joinAddress = connection.isUsingTcp
+			                                  ? connection.socket.getRemoteAddress()
+			                                  : connection.udpAddress;
+		if (joinAddress != datagram.address) return;
+
+		if (connection.udpPort != 0)
+		{
+			_udpConnections.erase(GetEndpointKey(connection.udpAddress, connection.udpPort));
+		}
+		connection.udpAddress = datagram.address;
+		connection.udpPort = datagram.port;
+		connection.lastReceiveTime = GetChannelTime();
+		_udpConnections[GetEndpointKey(datagram.address, datagram.port)] = &connection;
+
+		JoinAckPacket joinAckPacket{};
+		joinAckPacket.clientId = connection.clientId;
+		joinAckPacket.udpPort = _udpPort;
+		const std::size_t packetSize = WritePacket(_sendingBuffer, joinAckPacket);
+		_udpSocket.QueueSend(std::span(_sendingBuffer.data(), packetSize), datagram.address, datagram.port);
+		return;
+	}
+
+	const auto it = _udpConnections.find(GetEndpointKey(datagram.address, datagram.port));
+	if (it == _udpConnections.end()) return;
+	Connection& connection = *it->second;
+	if (connection.isDisconnected) return;
+	connection.lastReceiveTime = GetChannelTime();
+
+	switch (GetPacketType(packet))
+	{
+	case PacketType::Input:
+		{
+			// A client can only send the inputs of its own player
+			const auto& playerInputPacket = std::get<PlayerInputPacket>(packet);
+			if (playerInputPacket.playerNumber != connection.playerNumber) return;
+
+			if (playerInputPacket.hasReliableAck)
+			{
+				connection.reliableChannel.ReceiveAck(playerInputPacket.reliableAck, connection.lastReceiveTime,
+				                                      connection.rttEstimator);
+			}
+
+			// A closing connection only waits for its acknowledgements
+			if (connection.isClosing) return;
+
+			MatchSlot& matchSlot = _matches[connection.matchId];
+			matchSlot.match->PushReceivedPacket(packet);
+			matchSlot.hasWork = true;
+			break;
+		}
+	case PacketType::Ping:
+		{
+			// The ping does not depend on the match, it is sent back right away with the time of the server
+			PingPacket pingPacket = std::get<PingPacket>(packet);
+			pingPacket.serverTime = GetSystemTime();
+			const std::size_t packetSize = WritePacket(_sendingBuffer, pingPacket);
+			_udpSocket.QueueSend(std::span(_sendingBuffer.data(), packetSize), datagram.address, datagram.port);
+			break;
+		}
+	case PacketType::Reliable:
+		{
+			connection.reliableChannel.Receive(std::get<ReliablePacket>(packet), connection.lastReceiveTime,
+			                                   connection.rttEstimator);
+			while (const auto message = connection.reliableChannel.PopMessage())
+			{
+				ReceiveUdpPacket(datagram, *message);
+			}
+			break;
+		}
+	default:
+		break;
+	}
+}
+
+void MatchServer::JoinMatch(Connection& connection, const JoinPacket& joinPacket)
+{
+	if (_openMatchId == NO_MATCH)
+	{
+		_openMatchId = _nextMatchId;
+		_nextMatchId++;
+
+		MatchSlot& matchSlot = _matches[_openMatchId];
+		matchSlot.match = std::make_unique<Match>();
+		matchSlot.match->Begin();
+		core::LogInfo(fmt::format("[Server] Opening match {}, {} matches are running", _openMatchId,
+		                          _matches.size()));
+	}
+
+	MatchSlot& matchSlot = _matches[_openMatchId];
+	const auto freeSlot = std::ranges::find(matchSlot.connections, nullptr);
+	const bool isAlreadyInMatch = std::ranges::any_of(matchSlot.connections, [&](const Connection* other)
+	{
+		return other != nullptr && other->clientId == joinPacket.clientId;
+	});
+	if (isAlreadyInMatch)
+	{
+		core::LogWarning(fmt::format("[Server] Client {} is already in match {}",
+		                             static_cast<unsigned>(joinPacket.clientId), _openMatchId));
+		DisconnectClient(connection);
+		return;
+	}
+
+	// The match gives the player numbers in the order of the joins, that are pushed in the same order
+	connection.clientId = joinPacket.clientId;
+	connection.matchId = _openMatchId;
+	connection.playerNumber = static_cast<PlayerNumber>(std::distance(matchSlot.connections.begin(), freeSlot));
+	*freeSlot = &connection;
+
+	core::LogInfo(fmt::format("[Server] Client {} joins match {} as player {}",
+	                          static_cast<unsigned>(connection.clientId), connection.matchId,
+	                          connection.playerNumber));
+
+	JoinAckPacket joinAckPacket{};
+	joinAckPacket.clientId = connection.clientId;
+	joinAckPacket.udpPort = _udpPort;
+	if (connection.isUsingTcp)
+	{
+		SendTcpPacket(connection, joinAckPacket);
+	}
+	else
+	{
+		const std::size_t packetSize = WritePacket(_sendingBuffer, joinAckPacket);
+		_udpSocket.QueueSend(std::span(_sendingBuffer.data(), packetSize), connection.udpAddress, connection.udpPort);
+	}
+
+	matchSlot.match->PushReceivedPacket(joinPacket);
+	matchSlot.hasWork = true;
+
+	if (std::ranges::find(matchSlot.connections, nullptr) == matchSlot.connections.end())
+	{
+		_openMatchId = NO_MATCH;
+	}
+}
+
+void MatchServer::UpdateMatches()
+{
+	#ifdef TRACY_ENABLE
+	ZoneScoped;
+	#endif
+
+	_updatedMatchIds.clear();
+	for (auto& [matchId, matchSlot] : _matches)
+	{
+		if (!matchSlot.hasWork || matchSlot.isAbandoned) continue;
+
+		_updatedMatchIds.push_back(matchId);
+		Match* match = matchSlot.match.get();
+		// A match stays on the same worker from one update to the next, unless it is stolen
+		_scheduler.Schedule(matchId, [match]
+		{
+			match->Update(sf::Time{});
+		});
+	}
+	_scheduler.WaitIdle();
+
+	// The sockets are only used by this thread, the packets are sent once all the matches are updated
+	for (const std::size_t matchId : _updatedMatchIds)
+	{
+		MatchSlot& matchSlot = _matches[matchId];
+		SendMatchPackets(matchSlot);
+		matchSlot.hasWork = false;
+	}
+}
+
+void MatchServer::SendMatchPackets(MatchSlot& matchSlot)
+{
+	for (const auto& [packet, isReliable] : matchSlot.match->GetOutgoingPackets())
+	{
+		// The players have already lost when one of them is too slow
+		if (matchSlot.isAbandoned) break;
+
+		if (isReliable)
+		{
+			for (Connection* connection : matchSlot.connections)
+			{
+				if (connection == nullptr || connection->isDisconnected || matchSlot.isAbandoned) continue;
+				SendReliablePacket(*connection, packet);
+			}
+		}
+		else
+		{
+			// The packet is serialized once for all the players
+			const std::size_t packetSize = WritePacket(_sendingBuffer, packet);
+			for (const Connection* connection : matchSlot.connections)
+			{
+				if (connection == nullptr || connection->udpPort == 0) continue;
+				_udpSocket.QueueSend(std::span(_sendingBuffer.data(), packetSize), connection->udpAddress,
+				                     connection->udpPort);
+			}
+		}
+	}
+	matchSlot.match->ClearOutgoingPackets();
+}
+
+void MatchServer::RemoveEndedMatches()
+{
+	const std::uint64_t time = GetChannelTime();
+	for (auto it = _matches.begin(); it != _matches.end();)
+	{
+		MatchSlot& matchSlot = it->second;
+		if (!matchSlot.isAbandoned && !matchSlot.match->HasEnded())
+		{
+			++it;
+			continue;
+		}
+
+		core::LogInfo(fmt::format("[Server] Closing match {}", it->first));
+		for (Connection* connection : matchSlot.connections)
+		{
+			if (connection == nullptr) continue;
+			connection->matchId = NO_MATCH;
+			connection->isClosing = true;
+			connection->closeTime = time;
+		}
+		if (_openMatchId == it->first)
+		{
+			_openMatchId = NO_MATCH;
+		}
+		it = _matches.erase(it);
+	}
+
+	// The connections of the closed matches once their last reliable messages are acknowledged,
+	// and the clients that left
+	std::erase_if(_connections, [this, time](const std::unique_ptr<Connection>& connection)
+	{
+		if (connection->isClosing && !connection->isDisconnected)
+		{
+			const bool isAcknowledged = connection->udpPort == 0 ||
+				connection->reliableChannel.GetWaitingMessageCount() == 0;
+			const float closingTimeout = CLOSING_TIMEOUT_RTO_COUNT *
+				connection->rttEstimator.GetRetransmissionTimeout();
+			if (!isAcknowledged && static_cast<float>(time - connection->closeTime) < closingTimeout) return false;
+
+			if (!isAcknowledged)
+			{
+				core::LogInfo(fmt::format("[Server] Client {} did not acknowledge the end of its match",
+				                          static_cast<unsigned>(connection->clientId)));
+			}
+		}
+		else if (!connection->isDisconnected)
+		{
+			return false;
+		}
+
+		// The client may already have joined another match from the same address
+		if (connection->udpPort != 0)
+		{
+			const auto udpConnection = _udpConnections.find(
+				GetEndpointKey(connection->udpAddress, connection->udpPort));
+			if (udpConnection != _udpConnections.end() && udpConnection->second == connection.get())
+			{
+				_udpConnections.erase(udpConnection);
+			}
+		}
+		if (connection->isUsingTcp)
+		{
+			connection->sender.Flush(connection->socket);
+			_eventLoop.RemoveSocket(connection->socket);
+			connection->socket.disconnect();
+		}
+		return true;
+	});
+}
+
+void MatchServer::DisconnectClient(Connection& connection)
+{
+	if (connection.isDisconnected) return;
+
+	core::LogInfo(fmt::format("[Server] Client {} is disconnected", static_cast<unsigned>(connection.clientId)));
+	connection.isDisconnected = true;
+	if (connection.matchId == NO_MATCH) return;
+
+	MatchSlot& matchSlot = _matches[connection.matchId];
+	for (Connection* other : matchSlot.connections)
+	{
+		if (other == nullptr || other->isDisconnected) continue;
+		SendReliablePacket(*other, LoseGamePacket{});
+	}
+	matchSlot.isAbandoned = true;
+}
+
+void MatchServer::SendTcpPacket(Connection& connection, const Packet& packet)
+{
+	// The sending buffer can hold a packet being sent to the other players of a match
+	std::array<std::uint8_t, MAX_TCP_FRAME_SIZE> frame{};
+	const std::size_t frameSize = WriteTcpFrame(frame, packet);
+	QueueTcpFrame(connection, std::span(frame.data(), frameSize));
+}
+
+void MatchServer::SendReliablePacket(Connection& connection, const Packet& packet)
+{
+	if (connection.reliableChannel.Send(packet)) return;
+
+	core::LogWarning(fmt::format("[Server] Client {} does not acknowledge the reliable packets, {} are waiting",
+	                             static_cast<unsigned>(connection.clientId),
+	                             connection.reliableChannel.GetWaitingMessageCount()));
+	DisconnectClient(connection);
+}
+
+void MatchServer::FlushReliableChannels()
+{
+	// The connections of the closed matches are still flushed, until their last messages are acknowledged
+	const std::uint64_t time = GetChannelTime();
+	for (const auto& connection : _connections)
+	{
+		if (connection->udpPort == 0 || connection->isDisconnected) continue;
+
+		const float retransmissionTimeout = connection->rttEstimator.GetRetransmissionTimeout();
+		for (const ReliablePacket& reliablePacket : connection->reliableChannel.GetPacketsToSend(
+			     time, retransmissionTimeout))
+		{
+			const std::size_t packetSize = WritePacket(_sendingBuffer, reliablePacket);
+			_udpSocket.QueueSend(std::span(_sendingBuffer.data(), packetSize), connection->udpAddress,
+			                     connection->udpPort);
+		}
+	}
+}
+
+void MatchServer::UpdateTickTimer()
+{
+	const bool needsTicks = !_matches.empty() || std::ranges::any_of(
+		_connections, [](const std::unique_ptr<Connection>& connection) { return connection->isClosing; });
+	if (needsTicks == _isTicking) return;
+
+	_eventLoop.SetTickPeriod(needsTicks ? sf::seconds(SERVER_TICK_PERIOD) : sf::Time{});
+	_isTicking = needsTicks;
+}
+
+void MatchServer::DisconnectSilentClients()
+{
+	const std::uint64_t time = GetChannelTime();
+	for (const auto& connection : _connections)
+	{
+		if (connection->udpPort == 0 || connection->isDisconnected) continue;
+		if (time - connection->lastReceiveTime < CLIENT_TIMEOUT) continue;
+
+		core::LogInfo(fmt::format("[Server] Client {} has sent nothing for {} ms",
+		                          static_cast<unsigned>(connection->clientId), time - connection->lastReceiveTime));
+		DisconnectClient(*connection);
+	}
+}
+
+void MatchServer::QueueTcpFrame(Connection& connection, const std::span<const std::uint8_t> frame)
+{
+	if (connection.sender.Send(connection.socket, frame)) return;
+
+	const TcpSendMetrics& metrics = connection.sender.GetMetrics();
+	core::LogWarning(fmt::format(
+		"[Server] Client {} does not read its TCP socket, {} bytes are waiting, {} frames were delayed",
+		static_cast<unsigned>(connection.clientId), metrics.queuedByteCount, metrics.delayedFrameCount));
+	DisconnectClient(connection);
+}
+
+void MatchServer::FlushTcpSends()
+{
+	for (const auto& connection : _connections)
+	{
+		if (connection->isDisconnected) continue;
+
+		connection->sender.Flush(connection->socket, _eventLoop);
+	}
+}
+
+std::uint64_t MatchServer::GetEndpointKey(const sf::IpAddress& address, const unsigned short port)
+{
+	return static_cast<std::uint64_t>(address.toInteger()) << 16 | port;
+}
+}
@@ -1,4 +1,3 @@
-#include <chrono>
 #include <imgui.h>
 #include <imgui_stdlib.h>
 
@@ -48,42 +47,28 @@ void NetworkClient::Update(const sf::Time dt)
 	Client::Update(dt);
 	if (_currentState != State::None)
 	{
-		auto status = sf::Socket::Done;
 		//Receive TCP Packet
-		while (status == sf::Socket::Done)
+		_tcpReceiver.Receive(_tcpSocket);
+		while (auto packet = _tcpReceiver.PopPacket())
 		{
-			sf::Packet packet;
-			status = _tcpSocket.receive(packet);
-			switch (status)
-			{
-			case sf::Socket::Done:
-				ReceiveNetPacket(packet, PacketSource::Tcp);
-				break;
-			case sf::Socket::NotReady:
-				//core::LogInfo("[Client] Error while receiving tcp socket is not ready");
-				break;
-			case sf::Socket::Partial:
-				core::LogInfo("[Client] Error while receiving TCP packet, PARTIAL");
-				break;
-			case sf::Socket::Disconnected:
-			case sf::Socket::Error:
-			default:
-				break;
-			}
+			ReceiveNetPacket(*packet, PacketSource::Tcp);
 		}
 
 		//Receive UDP packet
-		status = sf::Socket::Done;
+		auto status = sf::Socket::Done;
 		while (status == sf::Socket::Done)
 		{
-			sf::Packet packet;
 			sf::IpAddress sender;
 			unsigned short port;
-			status = _udpSocket.receive(packet, sender, port);
+			std::size_t receivedSize = 0;
+			status = _udpSocket.receive(_receivedBuffer.data(), _receivedBuffer.size(), receivedSize, sender, port);
 			switch (status)
 			{
 			case sf::Socket::Done:
-				ReceiveNetPacket(packet, PacketSource::Udp);
+				if (const auto packet = ReadPacket(std::span(_receivedBuffer.data(), receivedSize)))
+				{
+					ReceiveNetPacket(*packet, PacketSource::Udp);
+				}
 				break;
 			case sf::Socket::NotReady:
 				break;
@@ -106,9 +91,9 @@ void NetworkClient::Update(const sf::Time dt)
 				if (_serverUdpPort != 0)
 				{
 					//Need to send a join packet on the unreliable channel
-					auto joinPacket = std::make_unique<JoinPacket>();
-					joinPacket->clientId = core::ConvertToBinary<ClientId>(_clientId);
-					SendUnreliablePacket(std::move(joinPacket));
+					JoinPacket joinPacket{};
+					joinPacket.clientId = _clientId;
+					SendUnreliablePacket(joinPacket);
 				}
 				break;
 			}
@@ -122,6 +107,16 @@ void NetworkClient::Update(const sf::Time dt)
 	}
 
 	_gameManager.Update(dt);
+
+	// The acknowledgements that were not carried by the inputs are sent alone
+	if (_serverUdpPort != 0)
+	{
+		for (const ReliablePacket& reliablePacket : _reliableChannel.GetPacketsToSend(
+			     GetChannelTime(), _rttEstimator.GetRetransmissionTimeout()))
+		{
+			SendUnreliablePacket(reliablePacket);
+		}
+	}
 }
 
 void NetworkClient::End()
@@ -138,11 +133,17 @@ void NetworkClient::DrawImGui()
 	const auto windowName = "Client " + std::to_string(static_cast<unsigned>(_clientId));
 	ImGui::Begin(windowName.c_str());
 
-	if (_srtt > 0.0f)
+	if (_rttEstimator.HasSample())
 	{
-		ImGui::Text("SRTT: %f", _srtt);
-		ImGui::Text("RTTVAR: %f", _rttvar);
-		ImGui::Text("RTO: %f", _rto);
+		ImGui::Text("SRTT: %f", _rttEstimator.GetSmoothedRtt());
+		ImGui::Text("RTTVAR: %f", _rttEstimator.GetRttVariation());
+		ImGui::Text("RTO: %f", _rttEstimator.GetRetransmissionTimeout());
+	}
+	if (_clockOffsetEstimator.HasSample())
+	{
+		ImGui::Text("Clock Offset: %f", _clockOffsetEstimator.GetOffset(GetSystemTime()));
+		ImGui::Text("Clock Drift: %f", _clockOffsetEstimator.GetDrift());
+		ImGui::Text("Min RTT: %f", _clockOffsetEstimator.GetMinRtt());
 	}
 
 
@@ -153,7 +154,20 @@ void NetworkClient::DrawImGui()
 	{
 		_serverTcpPort = static_cast<unsigned short>(portBuffer);
 	}
-	if (_currentState == State::None &&
+	if (_currentState == State::None)
+	{
+		ImGui::Checkbox("Join with TCP", &_isUsingTcp);
+	}
+	if (_currentState == State::None && !_isUsingTcp &&
+		ImGui::Button("Join"))
+	{
+		// The server answers the join sent by the update on its UDP socket, which has the same port as its listener
+		_serverIpAddress = sf::IpAddress(_serverAddress);
+		_serverUdpPort = _serverTcpPort;
+		core::LogInfo("[Client] Joining server " + _serverAddress + " on UDP with port: " + std::to_string(_serverUdpPort));
+		_currentState = State::Joining;
+	}
+	else if (_currentState == State::None &&
 		ImGui::Button("Join"))
 	{
 		_tcpSocket.setBlocking(true);
@@ -163,13 +177,10 @@ void NetworkClient::DrawImGui()
 		{
 			core::LogInfo(
 				"[Client] Connect to server " + _serverAddress + " with port: " + std::to_string(_serverTcpPort));
-			auto joinPacket = std::make_unique<JoinPacket>();
-			joinPacket->clientId = core::ConvertToBinary<ClientId>(_clientId);
-			using namespace std::chrono;
-			const unsigned long clientTime = static_cast<unsigned long>(duration_cast<milliseconds>(
-				system_clock::now().time_since_epoch()).count());
-			joinPacket->startTime = core::ConvertToBinary<unsigned long>(clientTime);
-			SendReliablePacket(std::move(joinPacket));
+			_serverIpAddress = _tcpSocket.getRemoteAddress();
+			JoinPacket joinPacket{};
+			joinPacket.clientId = _clientId;
+			SendReliablePacket(joinPacket);
 			_currentState = State::Joining;
 		}
 		else
@@ -191,29 +202,46 @@ void NetworkClient::Draw(sf::RenderTarget& renderTarget)
 	_gameManager.Draw(renderTarget);
 }
 
-void NetworkClient::SendReliablePacket(const std::unique_ptr<Packet> packet)
+void NetworkClient::SendReliablePacket(const Packet& packet)
 {
 	//core::LogInfo("[Client] Sending reliable packet to server");
-	sf::Packet tcpPacket;
-	GeneratePacket(tcpPacket, *packet);
-	auto status = sf::Socket::Partial;
-	while (status == sf::Socket::Partial)
+	if (_isUsingTcp)
+	{
+		const std::size_t frameSize = WriteTcpFrame(_sendingBuffer, packet);
+		SendTcpFrame(_tcpSocket, std::span(_sendingBuffer.data(), frameSize));
+		return;
+	}
+
+	if (!_reliableChannel.Send(packet))
 	{
-		status = _tcpSocket.send(tcpPacket);
+		core::LogError("[Client] The server does not acknowledge the reliable packets");
 	}
 }
 
-void NetworkClient::SendUnreliablePacket(const std::unique_ptr<Packet> packet)
+void NetworkClient::SendUnreliablePacket(const Packet& packet)
 {
 	if (_currentState == State::None)
 	{
 		return;
 	}
 
-	sf::Packet udpPacket;
-	GeneratePacket(udpPacket, *packet);
+	std::size_t packetSize = 0;
+	const auto* playerInputPacket = std::get_if<PlayerInputPacket>(&packet);
+	const auto reliableAck = playerInputPacket != nullptr ? _reliableChannel.TakeAck() : std::nullopt;
+	if (reliableAck.has_value())
+	{
+		// The inputs are sent every frame, they carry the acknowledgement of the reliable packets
+		PlayerInputPacket packetWithAck = *playerInputPacket;
+		packetWithAck.hasReliableAck = true;
+		packetWithAck.reliableAck = *reliableAck;
+		packetSize = WritePacket(_sendingBuffer, packetWithAck);
+	}
+	else
+	{
+		packetSize = WritePacket(_sendingBuffer, packet);
+	}
 
-	switch (_udpSocket.send(udpPacket, _serverAddress, _serverUdpPort))
+	switch (_udpSocket.send(_sendingBuffer.data(), packetSize, _serverIpAddress, _serverUdpPort))
 	{
 	case sf::Socket::Done:
 		//core::LogInfo("[Client] Sending UDP packet to server at host: " +
@@ -245,11 +273,11 @@ void NetworkClient::SetPlayerInput(const PlayerInput playerInput)
 		currentFrame);
 }
 
-void NetworkClient::ReceivePacket(const Packet* packet)
+void NetworkClient::ReceivePacket(const Packet& packet)
 {
 	Client::ReceivePacket(packet);
 	#ifdef ENABLE_SQLITE
-	switch (packet->packetType)
+	switch (GetPacketType(packet))
 	{
 	case PacketType::JOIN: break;
 	case PacketType::SPAWN_PLAYER: break;
@@ -289,28 +317,26 @@ void NetworkClient::ReceivePacket(const Packet* packet)
 	#endif
 }
 
-void NetworkClient::ReceiveNetPacket(sf::Packet& packet, const PacketSource source)
+void NetworkClient::ReceiveNetPacket(const Packet& packet, const PacketSource source)
 {
-	const auto receivePacket = GenerateReceivedPacket(packet);
-	Client::ReceivePacket(receivePacket.get());
-	switch (receivePacket->packetType)
+	Client::ReceivePacket(packet);
+	switch (GetPacketType(packet))
 	{
 	case PacketType::JoinAck:
 		{
 			core::LogInfo(
 				"[Client] Receive " + std::string(source == PacketSource::Udp ? "UDP" : "TCP") + " Join ACK Packet");
-			const auto* joinAckPacket = static_cast<JoinAckPacket*>(receivePacket.get());
+			const auto& joinAckPacket = std::get<JoinAckPacket>(packet);
 
-			_serverUdpPort = core::ConvertFromBinary<unsigned short>(joinAckPacket->udpPort);
-			const auto clientId = core::ConvertFromBinary<ClientId>(joinAckPacket->clientId);
-			if (clientId != _clientId)
+			_serverUdpPort = joinAckPacket.udpPort;
+			if (joinAckPacket.clientId != _clientId)
 				return;
 			if (source == PacketSource::Tcp)
 			{
 				//Need to send a join packet on the unreliable channel
-				auto joinPacket = std::make_unique<JoinPacket>();
-				joinPacket->clientId = core::ConvertToBinary<ClientId>(_clientId);
-				SendUnreliablePacket(std::move(joinPacket));
+				JoinPacket joinPacket{};
+				joinPacket.clientId = _clientId;
+				SendUnreliablePacket(joinPacket);
 			}
 			else
 			{
@@ -321,11 +347,20 @@ void NetworkClient::ReceiveNetPacket(sf::Packet& packet, const PacketSource sour
 			}
 			break;
 		}
+	case PacketType::Reliable:
+		{
+			_reliableChannel.Receive(std::get<ReliablePacket>(packet), GetChannelTime(), _rttEstimator);
+			while (const auto message = _reliableChannel.PopMessage())
+			{
+				ReceiveNetPacket(*message, source);
+			}
+			break;
+		}
 	case PacketType::Join:
 	case PacketType::SpawnPlayer:
 	case PacketType::Input:
 	case PacketType::SpawnBall:
-	case PacketType::ValidateState:
+	case PacketType::ServerInputs:
 	case PacketType::StartGame:
 	case PacketType::LoseGame:
 	case PacketType::Ping:
@@ -0,0 +1,191 @@
+#include "network/reliable_channel.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+#include <fmt/format.h>
+
+#include "utils/log.hpp"
+
+namespace game
+{
+std::uint64_t GetChannelTime()
+{
+	using namespace std::chrono;
+	return static_cast<std::uint64_t>(duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+bool ReliableChannel::Send(const Packet& packet)
+{
+	if (static_cast<std::uint16_t>(_nextSentSequence - _oldestSentSequence) >= WINDOW_SIZE) return false;
+
+	SentMessage& message = _sentMessages[_nextSentSequence % WINDOW_SIZE];
+	const std::size_t size = WritePacket(message.data, packet);
+	if (size == 0)
+	{
+		core::LogError(fmt::format("[Network] Packet {} is too big to be a reliable message",
+		                           static_cast<int>(GetPacketType(packet))));
+		return true;
+	}
+
+	message.size = static_cast<std::uint8_t>(size);
+	message.sequence = _nextSentSequence;
+	message.sendCount = 0;
+	message.isWaitingAck = true;
+	_nextSentSequence++;
+	return true;
+}
+
+std::span<const ReliablePacket> ReliableChannel::GetPacketsToSend(const std::uint64_t time,
+                                                                  const float retransmissionTimeout)
+{
+	std::size_t packetCount = 0;
+	for (std::uint16_t sequence = _oldestSentSequence; sequence != _nextSentSequence; sequence++)
+	{
+		SentMessage& message = _sentMessages[sequence % WINDOW_SIZE];
+		if (!message.isWaitingAck) continue;
+
+		if (message.sendCount > 0)
+		{
+			// The timeout doubles with each retransmission, so a congested link is not flooded
+			const float timeout = retransmissionTimeout * static_cast<float>(1u << std::min(message.sendCount - 1, 3u));
+			if (static_cast<float>(time - message.lastSendTime) < timeout) continue;
+
+			_retransmissionCount++;
+		}
+
+		ReliablePacket& packet = _packetsToSend[packetCount];
+		packet.sequence = message.sequence;
+		packet.messageSize = message.size;
+		std::copy_n(message.data.begin(), message.size, packet.message.begin());
+		message.lastSendTime = time;
+		message.sendCount++;
+		packetCount++;
+	}
+
+	const auto ack = TakeAck();
+	if (packetCount == 0 && ack.has_value())
+	{
+		ReliablePacket& packet = _packetsToSend[packetCount];
+		packet.messageSize = 0;
+		packetCount++;
+	}
+
+	for (std::size_t i = 0; i < packetCount; i++)
+	{
+		_packetsToSend[i].hasReliableAck = ack.has_value();
+		_packetsToSend[i].reliableAck = ack.value_or(ReliableAck{});
+	}
+	return std::span(_packetsToSend.data(), packetCount);
+}
+
+void ReliableChannel::Receive(const ReliablePacket& packet, const std::uint64_t time, RttEstimator& rttEstimator)
+{
+	if (packet.hasReliableAck)
+	{
+		ReceiveAck(packet.reliableAck, time, rttEstimator);
+	}
+	if (packet.messageSize == 0) return;
+
+	const std::uint16_t sequence = packet.sequence;
+	if (!_hasReceivedMessage)
+	{
+		_ack.sequence = sequence;
+		_ack.bits = 0;
+		_hasReceivedMessage = true;
+	}
+	else if (IsNewer(sequence, _ack.sequence))
+	{
+		// The previous newest sequence becomes a bit of the field
+		const auto shift = static_cast<std::uint16_t>(sequence - _ack.sequence);
+		_ack.bits = shift > 32
+			            ? 0u
+			            : static_cast<std::uint32_t>((static_cast<std::uint64_t>(_ack.bits) << 1u | 1u) << (shift - 1u));
+		_ack.sequence = sequence;
+	}
+	else if (sequence != _ack.sequence)
+	{
+		const auto age = static_cast<std::uint16_t>(_ack.sequence - sequence);
+		if (age <= 32)
+		{
+			_ack.bits |= 1u << (age - 1u);
+		}
+	}
+	// A message received again means that the acknowledgement has been lost
+	_ackRepeatCount = ACK_REPEAT_COUNT;
+
+	const auto offset = static_cast<std::uint16_t>(sequence - _nextReceivedSequence);
+	if (offset >= WINDOW_SIZE) return;
+
+	auto& receivedMessage = _receivedMessages[sequence % WINDOW_SIZE];
+	if (receivedMessage.has_value()) return;
+
+	receivedMessage = ReadPacket(std::span(packet.message.data(), packet.messageSize));
+	if (!receivedMessage.has_value())
+	{
+		core::LogError("[Network] Could not read a reliable message");
+	}
+}
+
+void ReliableChannel::ReceiveAck(const ReliableAck& ack, const std::uint64_t time, RttEstimator& rttEstimator)
+{
+	AcknowledgeMessage(ack.sequence, time, rttEstimator);
+	for (std::uint16_t i = 0; i < 32; i++)
+	{
+		if ((ack.bits >> i & 1u) == 0) continue;
+
+		AcknowledgeMessage(static_cast<std::uint16_t>(ack.sequence - 1u - i), time, rttEstimator);
+	}
+
+	while (_oldestSentSequence != _nextSentSequence && !_sentMessages[_oldestSentSequence % WINDOW_SIZE].isWaitingAck)
+	{
+		_oldestSentSequence++;
+	}
+}
+
+std::optional<Packet> ReliableChannel::PopMessage()
+{
+	auto& receivedMessage = _receivedMessages[_nextReceivedSequence % WINDOW_SIZE];
+	if (!receivedMessage.has_value()) return std::nullopt;
+
+	std::optional<Packet> message = std::move(receivedMessage);
+	receivedMessage.reset();
+	_nextReceivedSequence++;
+	return message;
+}
+
+std::optional<ReliableAck> ReliableChannel::TakeAck()
+{
+	if (!_hasReceivedMessage || _ackRepeatCount <= 0) return std::nullopt;
+
+	_ackRepeatCount--;
+	return _ack;
+}
+
+std::size_t ReliableChannel::GetWaitingMessageCount() const
+{
+	return static_cast<std::uint16_t>(_nextSentSequence - _oldestSentSequence);
+}
+
+bool ReliableChannel::IsNewer(const std::uint16_t sequence, const std::uint16_t other)
+{
+	return static_cast<std::int16_t>(sequence - other) > 0;
+}
+
+void ReliableChannel::AcknowledgeMessage(const std::uint16_t sequence, const std::uint64_t time,
+                                         RttEstimator& rttEstimator)
+{
+	const auto offset = static_cast<std::uint16_t>(sequence - _oldestSentSequence);
+	if (offset >= static_cast<std::uint16_t>(_nextSentSequence - _oldestSentSequence)) return;
+
+	SentMessage& message = _sentMessages[sequence % WINDOW_SIZE];
+	if (!message.isWaitingAck || message.sequence != sequence) return;
+
+	message.isWaitingAck = false;
+	// The round trip of a message sent again can not be told from the one of its first send
+	if (message.sendCount == 1)
+	{
+		rttEstimator.AddSample(static_cast<float>(time - message.lastSendTime));
+	}
+}
+}
@@ -0,0 +1,24 @@
+#include "network/rtt_estimator.hpp"
+
+#include <algorithm>
+
+#include "maths/basic.hpp"
+
+namespace game
+{
+void RttEstimator::AddSample(const float rtt)
+{
+	if (_srtt < 0.0f)
+	{
+		_srtt = rtt;
+		_rttvar = rtt / 2.0f;
+	}
+	else
+	{
+		_srtt = (1.0f - ALPHA) * _srtt + ALPHA * rtt;
+		_rttvar = (1.0f - BETA) * _rttvar + BETA * core::Abs(_srtt - rtt);
+	}
+
+	_rto = _srtt + std::max(G, K * _rttvar);
+}
+}
@@ -1,8 +1,11 @@
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 
 #include <network/server.hpp>
 
-#include <utils/conversion.hpp>
+#include "network/clock_offset_estimator.hpp"
+
 #include <utils/log.hpp>
 
 #include "maths/basic.hpp"
@@ -15,17 +18,73 @@ namespace game
 {
 void Server::SendStartGamePacket()
 {
-	auto startGamePacket = std::make_unique<StartGamePacket>();
-	startGamePacket->packetType = PacketType::StartGame;
 	core::LogInfo("Send Start Game Packet");
-	SendReliablePacket(std::move(startGamePacket));
+	StartGamePacket startGamePacket{};
+	startGamePacket.startTime = GetSystemTime() + static_cast<std::uint64_t>(START_DELAY);
+	SendReliablePacket(startGamePacket);
 }
 
-void Server::SendSpawnFallingWallPacket(const Frame spawnTimeOffset)
+void Server::UpdateTick(const sf::Time dt)
 {
-	auto spawnFallingWallPacket = std::make_unique<SpawnFallingWallPacket>();
-	spawnFallingWallPacket->packetType = PacketType::SpawnFallingWall;
+	if (_lastPlayerNumber < MAX_PLAYER_NMB) return;
+
+	_tickTimer += dt.asSeconds();
+	if (_tickTimer < SERVER_TICK_PERIOD) return;
+
+	// Only one packet is sent even if the server is late, it always carries all the inputs that are not acknowledged
+	_tickTimer = std::fmod(_tickTimer, SERVER_TICK_PERIOD);
+	SendServerInputsPacket();
+}
+
+void Server::SendServerInputsPacket()
+{
+	#ifdef TRACY_ENABLE
+	ZoneScoped;
+	#endif
+
+	const auto& rollbackManager = _gameManager.GetRollbackManager();
+	const Frame currentFrame = rollbackManager.GetCurrentFrame();
+	const Frame oldestFrameInWindow = currentFrame - std::min<Frame>(currentFrame, WINDOW_BUFFER_SIZE - 1);
+
+	ServerInputsPacket serverInputsPacket{};
+	serverInputsPacket.validateFrame = _gameManager.GetLastValidateFrame();
+	for (PlayerNumber playerNumber = 0; playerNumber < MAX_PLAYER_NMB; playerNumber++)
+	{
+		serverInputsPacket.physicsStates[playerNumber] = rollbackManager.GetValidatePhysicsState(playerNumber);
+	}
+
+	for (PlayerNumber playerNumber = 0; playerNumber < MAX_PLAYER_NMB; playerNumber++)
+	{
+		const Frame lastReceivedFrame = rollbackManager.GetLastReceivedFrame(playerNumber);
+		serverInputsPacket.lastReceivedFrames[playerNumber] = lastReceivedFrame;
+		if (lastReceivedFrame < oldestFrameInWindow) continue;
+
+		// The inputs are replicated from the oldest frame that another client has acknowledged
+		Frame ackFrame = lastReceivedFrame;
+		for (PlayerNumber i = 0; i < MAX_PLAYER_NMB; i++)
+		{
+			if (i == playerNumber) continue;
 
+			ackFrame = std::min(ackFrame, _inputAckFrames[i]);
+		}
+
+		const Frame firstFrame = std::max(ackFrame, oldestFrameInWindow);
+		const Frame inputCount = std::min<Frame>(lastReceivedFrame - firstFrame + 1, MAX_INPUT_NMB);
+		serverInputsPacket.inputCounts[playerNumber] = static_cast<std::uint8_t>(inputCount);
+
+		const auto& inputs = rollbackManager.GetInputs(playerNumber);
+		for (Frame i = 0; i < inputCount; i++)
+		{
+			serverInputsPacket.inputs[playerNumber][i] = inputs[currentFrame - lastReceivedFrame + i];
+		}
+	}
+
+	SendUnreliablePacket(serverInputsPacket);
+}
+
+void Server::SendSpawnFallingWallPacket(const Frame spawnTimeOffset)
+{
+	SpawnFallingWallPacket spawnFallingWallPacket{};
 
 	const Frame currentFrame = _gameManager.GetLastValidateFrame();
 
@@ -43,12 +102,12 @@ void Server::SendSpawnFallingWallPacket(const Frame spawnTimeOffset)
 
 	core::LogInfo(
 		fmt::format("[Server] Send Spawn Wall Packet for frame : {}", fallingWallSpawnInstructions.spawnFrame));
-	spawnFallingWallPacket->spawnFrame = core::ConvertToBinary(fallingWallSpawnInstructions.spawnFrame);
-	spawnFallingWallPacket->requiresBall = fallingWallSpawnInstructions.requiresBall;
-	spawnFallingWallPacket->doorPosition = core::ConvertToBinary(fallingWallSpawnInstructions.doorPosition);
+	spawnFallingWallPacket.spawnFrame = fallingWallSpawnInstructions.spawnFrame;
+	spawnFallingWallPacket.requiresBall = fallingWallSpawnInstructions.requiresBall;
+	spawnFallingWallPacket.doorPosition = fallingWallSpawnInstructions.doorPosition;
 
 
-	SendReliablePacket(std::move(spawnFallingWallPacket));
+	SendReliablePacket(spawnFallingWallPacket);
 }
 
 Frame Server::GetNextRandomFallingWallSpawnFrame() const
@@ -70,17 +129,17 @@ float Server::GetNextRandomDoorPosition() const
 	return core::RandomRange<float>(min, max);
 }
 
-void Server::ReceivePacket(std::unique_ptr<Packet> packet)
+void Server::ReceivePacket(const Packet& packet)
 {
 	#ifdef TRACY_ENABLE
 	ZoneScoped;
 	#endif
-	switch (packet->packetType)
+	switch (GetPacketType(packet))
 	{
 	case PacketType::Join:
 		{
-			const auto* joinPacket = dynamic_cast<const JoinPacket*>(packet.get());
-			const auto clientId = core::ConvertFromBinary<ClientId>(joinPacket->clientId);
+			const auto& joinPacket = std::get<JoinPacket>(packet);
+			const ClientId clientId = joinPacket.clientId;
 			const auto idPredicate = [clientId](const ClientId clientMapId)
 			{
 				return clientMapId == clientId;
@@ -109,14 +168,18 @@ void Server::ReceivePacket(std::unique_ptr<Packet> packet)
 	case PacketType::Input:
 		{
 			// Manage internal state
-			const auto* playerInputPacket = dynamic_cast<const PlayerInputPacket*>(packet.get());
-			const auto playerNumber = playerInputPacket->playerNumber;
-			const auto inputFrame = core::ConvertFromBinary<Frame>(playerInputPacket->currentFrame);
+			const auto& playerInputPacket = std::get<PlayerInputPacket>(packet);
+			const auto playerNumber = playerInputPacket.playerNumber;
+			const Frame inputFrame = playerInputPacket.currentFrame;
+			if (playerNumber >= MAX_PLAYER_NMB) break;
+
+			const Frame ackFrame = playerInputPacket.ackFrame;
+			_inputAckFrames[playerNumber] = std::max(_inputAckFrames[playerNumber], ackFrame);
 
-			for (std::uint32_t i = 0; i < playerInputPacket->inputs.size(); i++)
+			for (std::uint32_t i = 0; i < playerInputPacket.inputCount; i++)
 			{
 				_gameManager.SetPlayerInput(playerNumber,
-				                            playerInputPacket->inputs[i],
+				                            playerInputPacket.inputs[i],
 				                            inputFrame - i);
 				if (inputFrame - i == 0)
 				{
@@ -124,9 +187,7 @@ void Server::ReceivePacket(std::unique_ptr<Packet> packet)
 				}
 			}
 
-			SendUnreliablePacket(std::move(packet));
-
-			// Validate new frame if needed
+			// Validate new frame if needed, it is sent to the clients with the next ServerInputsPacket
 			std::uint32_t lastReceiveFrame = _gameManager.GetRollbackManager().GetLastReceivedFrame(0);
 			for (PlayerNumber i = 1; i < MAX_PLAYER_NMB; i++)
 			{
@@ -142,22 +203,6 @@ void Server::ReceivePacket(std::unique_ptr<Packet> packet)
 				// Validate frame
 				_gameManager.Validate(lastReceiveFrame);
 
-				auto validateFramePacket = std::make_unique<ValidateFramePacket>();
-				validateFramePacket->newValidateFrame = core::ConvertToBinary(lastReceiveFrame);
-
-				// copy physics state
-				for (PlayerNumber i = 0; i < MAX_PLAYER_NMB; i++)
-				{
-					auto physicsState = _gameManager.GetRollbackManager().GetValidatePhysicsState(i);
-					const auto* statePtr = reinterpret_cast<const std::uint8_t*>(&physicsState);
-					for (size_t j = 0; j < sizeof(PhysicsState); j++)
-					{
-						validateFramePacket->physicsState[i * sizeof(PhysicsState) + j] = statePtr[j];
-					}
-				}
-
-				SendUnreliablePacket(std::move(validateFramePacket));
-
 				const Frame wallSpawnFrame = _gameManager.GetRollbackManager().GetNextFallingWallSpawnInstructions().
 				                                          spawnFrame;
 				if (wallSpawnFrame <= _gameManager.GetLastValidateFrame())
@@ -168,9 +213,9 @@ void Server::ReceivePacket(std::unique_ptr<Packet> packet)
 				if (_gameManager.CheckIfLost())
 				{
 					core::LogInfo("Server declares everyone lost");
-					auto winGamePacket = std::make_unique<LoseGamePacket>();
-					winGamePacket->hasLost = true;
-					SendReliablePacket(std::move(winGamePacket));
+					LoseGamePacket loseGamePacket{};
+					loseGamePacket.hasLost = true;
+					SendReliablePacket(loseGamePacket);
 					_gameManager.LoseGame();
 				}
 			}
@@ -179,9 +224,10 @@ void Server::ReceivePacket(std::unique_ptr<Packet> packet)
 		}
 	case PacketType::Ping:
 		{
-			auto pingPacket = std::make_unique<PingPacket>();
-			*pingPacket = *dynamic_cast<PingPacket*>(packet.get());
-			SendUnreliablePacket(std::move(pingPacket));
+			// The time of the server lets the client measure the offset between the clocks
+			PingPacket pingPacket = std::get<PingPacket>(packet);
+			pingPacket.serverTime = GetSystemTime();
+			SendUnreliablePacket(pingPacket);
 			break;
 		}
 	default:
@@ -77,40 +77,42 @@ void SimulationClient::DrawImGui()
 	ImGui::Begin(windowName.c_str(), &show, ImGuiWindowFlags_AlwaysAutoResize);
 	if (_gameManager.GetPlayerNumber() == INVALID_PLAYER && ImGui::Button("Spawn Player"))
 	{
-		auto joinPacket = std::make_unique<JoinPacket>();
-		const auto* clientIdPtr = reinterpret_cast<std::uint8_t*>(&_clientId);
-		for (std::size_t i = 0; i < sizeof(_clientId); i++)
-		{
-			joinPacket->clientId[i] = clientIdPtr[i];
-		}
-		SendReliablePacket(std::move(joinPacket));
+		JoinPacket joinPacket{};
+		joinPacket.clientId = _clientId;
+		SendReliablePacket(joinPacket);
 	}
 
 	_gameManager.DrawImGui();
-	if (_srtt > 0.0f)
+	if (_rttEstimator.HasSample())
+	{
+		ImGui::Text("SRTT: %f", _rttEstimator.GetSmoothedRtt());
+		ImGui::Text("RTTVAR: %f", _rttEstimator.GetRttVariation());
+		ImGui::Text("RTO: %f", _rttEstimator.GetRetransmissionTimeout());
+	}
+	if (_clockOffsetEstimator.HasSample())
 	{
-		ImGui::Text("SRTT: %f", _srtt);
-		ImGui::Text("RTTVAR: %f", _rttvar);
-		ImGui::Text("RTO: %f", _rto);
+		ImGui::Text("Clock Offset: %f", _clockOffsetEstimator.GetOffset(GetSystemTime()));
+		ImGui::Text("Clock Drift: %f", _clockOffsetEstimator.GetDrift());
+		ImGui::Text("Min RTT: %f", _clockOffsetEstimator.GetMinRtt());
 	}
 	ImGui::End();
 }
 
-void SimulationClient::SendUnreliablePacket(std::unique_ptr<Packet> packet)
+void SimulationClient::SendUnreliablePacket(const Packet& packet)
 {
-	_server.PutPacketInReceiveQueue(std::move(packet), true);
+	_server.PutPacketInReceiveQueue(packet, true);
 }
 
-void SimulationClient::SendReliablePacket(std::unique_ptr<Packet> packet)
+void SimulationClient::SendReliablePacket(const Packet& packet)
 {
-	_server.PutPacketInReceiveQueue(std::move(packet), false);
+	_server.PutPacketInReceiveQueue(packet, false);
 }
 
-void SimulationClient::ReceivePacket(const Packet* packet)
+void SimulationClient::ReceivePacket(const Packet& packet)
 {
 	Client::ReceivePacket(packet);
 	#ifdef ENABLE_SQLITE
-	switch (packet->packetType)
+	switch (GetPacketType(packet))
 	{
 	case PacketType::JOIN: break;
 	case PacketType::SPAWN_PLAYER: break;
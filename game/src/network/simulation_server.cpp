@@ -5,7 +5,6 @@
 #include <network/simulation_client.hpp>
 #include <network/simulation_server.hpp>
 
-#include <utils/conversion.hpp>
 #include <utils/log.hpp>
 
 #ifdef TRACY_ENABLE
@@ -35,7 +34,7 @@ void SimulationServer::Update(const sf::Time dt)
 		packetIt->currentTime -= dt.asSeconds();
 		if (packetIt->currentTime <= 0.0f)
 		{
-			ProcessReceivePacket(std::move(packetIt->packet));
+			ProcessReceivePacket(packetIt->packet);
 
 			packetIt = _receivedPackets.erase(packetIt);
 		}
@@ -53,9 +52,8 @@ void SimulationServer::Update(const sf::Time dt)
 		{
 			for (const auto& client : _clients)
 			{
-				client->ReceivePacket(packetIt->packet.get());
+				client->ReceivePacket(packetIt->packet);
 			}
-			packetIt->packet = nullptr;
 			packetIt = _sentPackets.erase(packetIt);
 		}
 		else
@@ -63,6 +61,8 @@ void SimulationServer::Update(const sf::Time dt)
 			++packetIt;
 		}
 	}
+
+	UpdateTick(dt);
 }
 
 void SimulationServer::End()
@@ -86,12 +86,12 @@ void SimulationServer::DrawImGui()
 	ImGui::End();
 }
 
-void SimulationServer::PutPacketInSendingQueue(std::unique_ptr<Packet> packet)
+void SimulationServer::PutPacketInSendingQueue(const Packet& packet)
 {
-	_sentPackets.push_back({_avgDelay + core::RandomRange(-_marginDelay, _marginDelay), std::move(packet)});
+	_sentPackets.push_back({_avgDelay + core::RandomRange(-_marginDelay, _marginDelay), packet});
 }
 
-void SimulationServer::PutPacketInReceiveQueue(std::unique_ptr<Packet> packet, bool unreliable)
+void SimulationServer::PutPacketInReceiveQueue(const Packet& packet, bool unreliable)
 {
 	if (unreliable)
 	{
@@ -101,38 +101,37 @@ void SimulationServer::PutPacketInReceiveQueue(std::unique_ptr<Packet> packet, b
 			return;
 		}
 	}
-	_receivedPackets.push_back({_avgDelay + core::RandomRange(-_marginDelay, _marginDelay), std::move(packet)});
+	_receivedPackets.push_back({_avgDelay + core::RandomRange(-_marginDelay, _marginDelay), packet});
 }
 
-void SimulationServer::SendReliablePacket(std::unique_ptr<Packet> packet)
+void SimulationServer::SendReliablePacket(const Packet& packet)
 {
-	PutPacketInSendingQueue(std::move(packet));
+	PutPacketInSendingQueue(packet);
 }
 
-void SimulationServer::SendUnreliablePacket(std::unique_ptr<Packet> packet)
+void SimulationServer::SendUnreliablePacket(const Packet& packet)
 {
-	PutPacketInSendingQueue(std::move(packet));
+	PutPacketInSendingQueue(packet);
 }
 
-void SimulationServer::ProcessReceivePacket(std::unique_ptr<Packet> packet)
+void SimulationServer::ProcessReceivePacket(const Packet& packet)
 {
-	Server::ReceivePacket(std::move(packet));
+	Server::ReceivePacket(packet);
 }
 
 void SimulationServer::SpawnNewPlayer(const ClientId clientId, const PlayerNumber playerNumber)
 {
 	core::LogInfo("[Server] Spawn new player");
-	auto spawnPlayer = std::make_unique<SpawnPlayerPacket>();
-	spawnPlayer->packetType = PacketType::SpawnPlayer;
-	spawnPlayer->clientId = core::ConvertToBinary(clientId);
-	spawnPlayer->playerNumber = playerNumber;
+	SpawnPlayerPacket spawnPlayer{};
+	spawnPlayer.clientId = clientId;
+	spawnPlayer.playerNumber = playerNumber;
 
 	const core::Vec2f pos = SPAWN_POSITIONS[playerNumber] * 3.0f;
-	spawnPlayer->pos = ConvertToBinary(pos);
+	spawnPlayer.pos = pos;
 
 	constexpr auto rotation = core::Degree(0);
-	spawnPlayer->angle = ConvertToBinary(rotation);
+	spawnPlayer.angle = rotation;
 	_gameManager.SpawnPlayer(playerNumber, pos, rotation);
-	SendReliablePacket(std::move(spawnPlayer));
+	SendReliablePacket(spawnPlayer);
 }
 }
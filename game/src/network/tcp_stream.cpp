@@ -0,0 +1,175 @@
+#include "network/tcp_stream.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "network/event_loop.hpp"
+
+#include "utils/log.hpp"
+
+namespace game
+{
+std::size_t WriteTcpFrame(const std::span<std::uint8_t> buffer, const Packet& packet)
+{
+	if (buffer.size() < TCP_FRAME_HEADER_SIZE) return 0;
+
+	const std::size_t packetSize = WritePacket(buffer.subspan(TCP_FRAME_HEADER_SIZE), packet);
+	if (packetSize == 0) return 0;
+
+	buffer[0] = static_cast<std::uint8_t>(packetSize & 0xFFu);
+	buffer[1] = static_cast<std::uint8_t>(packetSize >> 8u);
+	return TCP_FRAME_HEADER_SIZE + packetSize;
+}
+
+sf::Socket::Status SendTcpFrame(sf::TcpSocket& socket, const std::span<const std::uint8_t> frame)
+{
+	std::size_t totalSent = 0;
+	auto status = sf::Socket::Partial;
+	while (status == sf::Socket::Partial)
+	{
+		std::size_t sent = 0;
+		status = socket.send(frame.data() + totalSent, frame.size() - totalSent, sent);
+		totalSent += sent;
+	}
+	return status;
+}
+
+bool TcpPacketSender::Send(sf::TcpSocket& socket, const std::span<const std::uint8_t> frame)
+{
+	// The frame can only be sent directly once the bytes sent before it are gone
+	std::size_t sent = 0;
+	auto status = Flush(socket);
+	if (status == sf::Socket::Done)
+	{
+		status = socket.send(frame.data(), frame.size(), sent);
+		_metrics.sentByteCount += sent;
+		if (status == sf::Socket::Done) return true;
+	}
+	if (status != sf::Socket::Partial && status != sf::Socket::NotReady)
+	{
+		// The receiver gives the disconnection, there is nothing left to send to this client
+		return true;
+	}
+
+	const auto remaining = frame.subspan(sent);
+	if (_buffer.size() - _size < remaining.size())
+	{
+		Compact();
+	}
+	if (_buffer.size() - _size < remaining.size())
+	{
+		return false;
+	}
+
+	std::memcpy(_buffer.data() + _size, remaining.data(), remaining.size());
+	_size += remaining.size();
+	_metrics.delayedFrameCount++;
+	_metrics.queuedByteCount = _size - _sendPosition;
+	_metrics.maxQueuedByteCount = std::max(_metrics.maxQueuedByteCount, _metrics.queuedByteCount);
+	return true;
+}
+
+sf::Socket::Status TcpPacketSender::Flush(sf::TcpSocket& socket)
+{
+	auto status = sf::Socket::Done;
+	while (_sendPosition < _size)
+	{
+		std::size_t sent = 0;
+		status = socket.send(_buffer.data() + _sendPosition, _size - _sendPosition, sent);
+		_sendPosition += sent;
+		_metrics.sentByteCount += sent;
+		if (status != sf::Socket::Done && status != sf::Socket::Partial) break;
+	}
+
+	if (_sendPosition == _size)
+	{
+		_sendPosition = 0;
+		_size = 0;
+		status = sf::Socket::Done;
+	}
+	_metrics.queuedByteCount = _size - _sendPosition;
+	return status;
+}
+
+void TcpPacketSender::Flush(sf::TcpSocket& socket, EventLoop& eventLoop)
+{
+	if (HasQueuedBytes())
+	{
+		Flush(socket);
+	}
+
+	if (HasQueuedBytes() != _isWaitingWritable)
+	{
+		_isWaitingWritable = HasQueuedBytes();
+		eventLoop.SetWriteInterest(socket, _isWaitingWritable);
+	}
+}
+
+void TcpPacketSender::Clear()
+{
+	_sendPosition = 0;
+	_size = 0;
+	_metrics.queuedByteCount = 0;
+}
+
+void TcpPacketSender::Compact()
+{
+	if (_sendPosition == 0) return;
+
+	std::memmove(_buffer.data(), _buffer.data() + _sendPosition, _size - _sendPosition);
+	_size -= _sendPosition;
+	_sendPosition = 0;
+}
+
+sf::Socket::Status TcpPacketReceiver::Receive(sf::TcpSocket& socket)
+{
+	Compact();
+
+	auto status = sf::Socket::Done;
+	while (status == sf::Socket::Done && _size < _buffer.size())
+	{
+		std::size_t received = 0;
+		status = socket.receive(_buffer.data() + _size, _buffer.size() - _size, received);
+		_size += received;
+	}
+	return status;
+}
+
+std::optional<Packet> TcpPacketReceiver::PopPacket()
+{
+	while (_size - _readPosition >= TCP_FRAME_HEADER_SIZE)
+	{
+		const std::size_t packetSize = _buffer[_readPosition] | static_cast<std::size_t>(_buffer[_readPosition + 1]) << 8u;
+		if (packetSize > MAX_PACKET_SIZE)
+		{
+			// The stream can not be split in packets any more, what has been received is lost
+			core::LogError("[Network] Received a TCP packet bigger than the biggest packet");
+			Clear();
+			return std::nullopt;
+		}
+
+		const std::size_t frameSize = TCP_FRAME_HEADER_SIZE + packetSize;
+		if (_size - _readPosition < frameSize) break;
+
+		auto packet = ReadPacket(std::span(_buffer.data() + _readPosition + TCP_FRAME_HEADER_SIZE, packetSize));
+		_readPosition += frameSize;
+		if (packet.has_value()) return packet;
+	}
+	return std::nullopt;
+}
+
+void TcpPacketReceiver::Clear()
+{
+	_readPosition = 0;
+	_size = 0;
+}
+
+void TcpPacketReceiver::Compact()
+{
+	if (_readPosition == 0) return;
+
+	std::memmove(_buffer.data(), _buffer.data() + _readPosition, _size - _readPosition);
+	_size -= _readPosition;
+	_readPosition = 0;
+}
+}
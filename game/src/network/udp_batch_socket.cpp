@@ -0,0 +1,166 @@
+#include "network/udp_batch_socket.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <fmt/format.h>
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
+
+#include "utils/log.hpp"
+
+#ifdef TRACY_ENABLE
+#include <Tracy.hpp>
+#endif
+
+namespace game
+{
+std::span<const Datagram> UdpBatchSocket::ReceiveBatch()
+{
+	#ifdef TRACY_ENABLE
+	ZoneScoped;
+	#endif
+
+	#ifdef __linux__
+	std::array<mmsghdr, BATCH_SIZE> messages{};
+	std::array<iovec, BATCH_SIZE> iovecs{};
+	std::array<sockaddr_in, BATCH_SIZE> addresses{};
+	for (std::size_t i = 0; i < BATCH_SIZE; i++)
+	{
+		iovecs[i].iov_base = _receivedDatagrams[i].data.data();
+		iovecs[i].iov_len = _receivedDatagrams[i].data.size();
+		messages[i].msg_hdr.msg_iov = &iovecs[i];
+		messages[i].msg_hdr.msg_iovlen = 1;
+		messages[i].msg_hdr.msg_name = &addresses[i];
+		messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+	}
+
+	const int count = recvmmsg(getHandle(), messages.data(), BATCH_SIZE, MSG_DONTWAIT, nullptr);
+	if (count <= 0) return {};
+
+	for (std::size_t i = 0; i < static_cast<std::size_t>(count); i++)
+	{
+		Datagram& datagram = _receivedDatagrams[i];
+		// A datagram bigger than the biggest packet is not one of ours, it is given empty so it is not read
+		const bool isTruncated = messages[i].msg_hdr.msg_flags & MSG_TRUNC;
+		datagram.size = isTruncated ? 0 : messages[i].msg_len;
+		datagram.address = sf::IpAddress(ntohl(addresses[i].sin_addr.s_addr));
+		datagram.port = ntohs(addresses[i].sin_port);
+	}
+	return std::span(_receivedDatagrams.data(), static_cast<std::size_t>(count));
+	#else
+	std::size_t count = 0;
+	while (count < BATCH_SIZE)
+	{
+		Datagram& datagram = _receivedDatagrams[count];
+		if (receive(datagram.data.data(), datagram.data.size(), datagram.size, datagram.address, datagram.port) !=
+			Done)
+		{
+			break;
+		}
+		count++;
+	}
+	return std::span(_receivedDatagrams.data(), count);
+	#endif
+}
+
+void UdpBatchSocket::QueueSend(const std::span<const std::uint8_t> data, const sf::IpAddress& address,
+                               const unsigned short port)
+{
+	if (data.empty() || data.size() > MAX_PACKET_SIZE) return;
+
+	if (_sendingCount == BATCH_SIZE)
+	{
+		FlushSends();
+	}
+
+	// The socket did not take any of the queued datagrams, the new one is dropped like a lost datagram
+	if (_sendingCount == BATCH_SIZE)
+	{
+		core::LogWarning("[Network] Dropped a UDP datagram, the send queue is full");
+		return;
+	}
+
+	Datagram& datagram = _sendingDatagrams[_sendingCount];
+	std::memcpy(datagram.data.data(), data.data(), data.size());
+	datagram.size = data.size();
+	datagram.address = address;
+	datagram.port = port;
+	_sendingCount++;
+}
+
+void UdpBatchSocket::FlushSends()
+{
+	#ifdef TRACY_ENABLE
+	ZoneScoped;
+	#endif
+
+	if (_sendingCount == 0) return;
+
+	#ifdef __linux__
+	std::array<mmsghdr, BATCH_SIZE> messages{};
+	std::array<iovec, BATCH_SIZE> iovecs{};
+	std::array<sockaddr_in, BATCH_SIZE> addresses{};
+	for (std::size_t i = 0; i < _sendingCount; i++)
+	{
+		const Datagram& datagram = _sendingDatagrams[i];
+		addresses[i].sin_family = AF_INET;
+		addresses[i].sin_addr.s_addr = htonl(datagram.address.toInteger());
+		addresses[i].sin_port = htons(datagram.port);
+		iovecs[i].iov_base = const_cast<std::uint8_t*>(datagram.data.data());
+		iovecs[i].iov_len = datagram.size;
+		messages[i].msg_hdr.msg_iov = &iovecs[i];
+		messages[i].msg_hdr.msg_iovlen = 1;
+		messages[i].msg_hdr.msg_name = &addresses[i];
+		messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+	}
+
+	// sendmmsg stops at the first datagram that fails, the next ones are sent again
+	std::size_t sentCount = 0;
+	while (sentCount < _sendingCount)
+	{
+		const int count = sendmmsg(getHandle(), messages.data() + sentCount,
+		                           static_cast<unsigned>(_sendingCount - sentCount), MSG_DONTWAIT);
+		if (count > 0)
+		{
+			sentCount += static_cast<std::size_t>(count);
+			continue;
+		}
+
+		// The send buffer is full, the rest waits in the queue for the next flush
+		if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+
+		// Any other error only concerns the failing datagram (an unreachable peer, a refused connection...)
+		const Datagram& datagram = _sendingDatagrams[sentCount];
+		core::LogWarning(fmt::format("[Network] Dropped a UDP datagram to {}:{}, {}",
+		                             datagram.address.toString(), datagram.port, std::strerror(errno)));
+		sentCount++;
+	}
+	#else
+	std::size_t sentCount = 0;
+	for (; sentCount < _sendingCount; sentCount++)
+	{
+		const Datagram& datagram = _sendingDatagrams[sentCount];
+		const Status status = send(datagram.data.data(), datagram.size, datagram.address, datagram.port);
+
+		// The send buffer is full, the rest waits in the queue for the next flush
+		if (status == NotReady) break;
+
+		if (status != Done)
+		{
+			core::LogWarning(fmt::format("[Network] Dropped a UDP datagram to {}:{}",
+			                             datagram.address.toString(), datagram.port));
+		}
+	}
+	#endif
+
+	std::move(_sendingDatagrams.begin() + static_cast<std::ptrdiff_t>(sentCount),
+	          _sendingDatagrams.begin() + static_cast<std::ptrdiff_t>(_sendingCount), _sendingDatagrams.begin());
+	_sendingCount -= sentCount;
+}
+}
@@ -8,6 +8,8 @@
 
 #include "physics/physics_manager.hpp"
 
+#include "utils/vector_utility.hpp"
+
 namespace game
 {
 BroadPhaseGrid::BroadPhaseGrid(
@@ -15,24 +17,80 @@ BroadPhaseGrid::BroadPhaseGrid(
 	const float minY, const float maxY,
 	const float cellSize,
 	core::EntityManager& entityManager, RigidbodyManager& rigidbodyManager,
-	AabbColliderManager& aabbManager, CircleColliderManager& circleManager
+	AabbColliderManager& aabbManager, CircleColliderManager& circleManager,
+	const LayerCollisionMatrix& layerCollisionMatrix
 )
-	: _min(minX, minY),
-	  _max(maxX, maxY),
-	  _cellSize(cellSize),
-	  _gridWidth(static_cast<std::size_t>(
-		  std::floor((_max.x - _min.x) / _cellSize))),
-	  _gridHeight(static_cast<std::size_t>(
-		  std::floor((_max.y - _min.y) / _cellSize))),
+	: _cellSize(cellSize),
+	  _gridWidth(0),
+	  _gridHeight(0),
 	  _entityManager(entityManager), _rigidbodyManager(rigidbodyManager),
-	  _aabbManager(aabbManager), _circleManager(circleManager)
+	  _aabbManager(aabbManager), _circleManager(circleManager),
+	  _layerCollisionMatrix(layerCollisionMatrix)
+{
+	Resize({minX, minY}, {maxX, maxY}, cellSize);
+}
+
+void BroadPhaseGrid::SetWorldBounds(const core::Vec2f min, const core::Vec2f max)
 {
+	Resize(min, max, _cellSize);
+}
+
+void BroadPhaseGrid::Resize(const core::Vec2f min, const core::Vec2f max, const float cellSize)
+{
+	_min = min;
+	_max = max;
+
+	// Bigger cells are used when there would be too many of them
+	const core::Vec2f extents = _max - _min;
+	_cellSize = std::max(cellSize, GetMinCellSize());
+
+	_gridWidth = std::max<std::size_t>(static_cast<std::size_t>(std::ceil(extents.x / _cellSize)), 1);
+	_gridHeight = std::max<std::size_t>(static_cast<std::size_t>(std::ceil(extents.y / _cellSize)), 1);
+
+	_persistentCells.clear();
+	_addedPersistentCells.clear();
+	_persistentOverflow.clear();
+	_hasRemovedPersistent = false;
+
+	// Every persistent body is inserted again on the next update
+	for (auto& persistentEntry : _persistentEntries)
+	{
+		persistentEntry.isInserted = false;
+		persistentEntry.isRemoved = false;
+	}
 }
 
 void BroadPhaseGrid::Update()
 {
-	_grid.clear();
-	_grid.resize(_gridWidth);
+	// Fit the cell size to the bodies of the last update
+	if (_averageBodySize > 0.0f)
+	{
+		const float ratio = _cellSize / _averageBodySize;
+		const float cellSize = std::max(_averageBodySize * (MIN_CELL_SIZE_RATIO + MAX_CELL_SIZE_RATIO) / 2.0f,
+		                                GetMinCellSize());
+
+		// Bodies smaller than the smallest cells would otherwise resize the grid at every update
+		if ((ratio < MIN_CELL_SIZE_RATIO || ratio > MAX_CELL_SIZE_RATIO) && cellSize != _cellSize) // NOLINT(clang-diagnostic-float-equal)
+		{
+			Resize(_min, _max, cellSize);
+		}
+	}
+
+	_dynamicCells.clear();
+	_dynamicOverflow.clear();
+
+	if (_persistentEntries.size() < _entityManager.GetEntitiesSize())
+	{
+		_persistentEntries.resize(_entityManager.GetEntitiesSize());
+	}
+
+	for (auto& persistentEntry : _persistentEntries)
+	{
+		persistentEntry.wasSeen = false;
+	}
+
+	float bodySizeSum = 0.0f;
+	std::size_t bodyCount = 0;
 
 	for (core::Entity entity = 0; entity < _entityManager.GetEntitiesSize(); entity++)
 	{
@@ -41,111 +99,288 @@ void BroadPhaseGrid::Update()
 			                                                     core::ComponentType::Rigidbody));
 		if (!isRigidbody) continue;
 
-		Rigidbody& body = _rigidbodyManager.GetComponent(entity);
+		const Rigidbody& body = _rigidbodyManager.GetComponent(entity);
 
-		const auto& transform = body.Trans();
+		const std::optional<ColliderBounds> bounds = PhysicsManager::GetColliderBounds(
+			body, entity, _aabbManager, _circleManager);
 
-		const Collider* collider = PhysicsManager::GetCollider(_entityManager, _aabbManager, _circleManager, entity);
+		if (!bounds) continue;
 
-		if (!collider) continue;
+		if (!body.IsStatic())
+		{
+			bodySizeSum += std::max(bounds->boundingBoxSize.x, bounds->boundingBoxSize.y);
+			bodyCount++;
+		}
 
-		const core::Vec2f offsetCenter = transform.position + collider->center;
+		const CellRange range = ComputeCellRange(*bounds);
+		const CellEntry cellEntry{entity, body.GetLayer(), body.IsStatic()};
 
-		// If body is outside the grid extents, then ignore it
-		if (offsetCenter.x < _min.x || offsetCenter.x > _max.x ||
-			offsetCenter.y < _min.y || offsetCenter.y > _max.y)
+		// Moved static bodies are only in the dynamic list, they go back in the persistent list once they stop
+		if (!IsActiveInBroadPhase(body))
 		{
-			continue;
-		}
+			PersistentEntry& persistentEntry = _persistentEntries[entity];
+			persistentEntry.wasSeen = true;
 
-		const core::Vec2f boundingBoxSize = collider->GetBoundingBoxSize();
+			// Persistent bodies are only re-binned when the cells they cover or their data change
+			const bool isUpToDate = persistentEntry.isInserted &&
+				persistentEntry.range == range && persistentEntry.cellEntry == cellEntry;
 
-		int xBodyMin = static_cast<int>(std::floor((offsetCenter.x - boundingBoxSize.x - _min.x) / _cellSize));
-		xBodyMin = std::clamp(xBodyMin, 0, static_cast<int>(_gridWidth));
-		int yBodyMin = static_cast<int>(std::floor((offsetCenter.y - boundingBoxSize.y - _min.y) / _cellSize));
-		yBodyMin = std::clamp(yBodyMin, 0, static_cast<int>(_gridHeight));
-		int xBodyMax = static_cast<int>(std::floor((offsetCenter.x + boundingBoxSize.x - _min.x) / _cellSize));
-		xBodyMax = std::clamp(xBodyMax, 0, static_cast<int>(_gridWidth) - 1);
-		int yBodyMax = static_cast<int>(std::floor((offsetCenter.y + boundingBoxSize.y - _min.y) / _cellSize));
-		yBodyMax = std::clamp(yBodyMax, 0, static_cast<int>(_gridHeight) - 1);
+			if (!isUpToDate)
+			{
+				if (persistentEntry.isInserted)
+				{
+					RemovePersistent(entity, persistentEntry.range);
+				}
 
-		for (int x = xBodyMin; x <= xBodyMax; x++)
-		{
-			if (_grid[x].empty()) _grid[x].resize(_gridHeight);
+				InsertPersistent(cellEntry, range);
+				persistentEntry.isInserted = true;
+				persistentEntry.range = range;
+				persistentEntry.cellEntry = cellEntry;
+			}
+		}
 
-			std::vector<std::vector<core::Entity>>& gridCol = _grid[x];
+		else
+		{
+			if (range.isOverflow)
+			{
+				_dynamicOverflow.push_back(cellEntry);
+			}
 
-			// Loop through each cell
-			for (int y = yBodyMin; y <= yBodyMax; y++)
+			for (int x = range.xMin; x <= range.xMax; x++)
 			{
-				std::vector<core::Entity>& gridCell = gridCol[y];
-				gridCell.push_back(entity);
+				for (int y = range.yMin; y <= range.yMax; y++)
+				{
+					const std::size_t cellIndex = static_cast<std::size_t>(x) * _gridHeight + static_cast<std::size_t>(y);
+					_dynamicCells.push_back({cellIndex, cellEntry});
+				}
 			}
 		}
 	}
+
+	// The bodies of a cell follow each other, in the order of the entities
+	std::ranges::sort(_dynamicCells);
+	core::KeepCapacityMargin(_dynamicCells);
+
+	_averageBodySize = bodyCount > 0 ? bodySizeSum / static_cast<float>(bodyCount) : 0.0f;
+
+	// Remove the bodies that were removed or woke up
+	for (core::Entity entity = 0; entity < _persistentEntries.size(); entity++)
+	{
+		PersistentEntry& persistentEntry = _persistentEntries[entity];
+		if (!persistentEntry.isInserted || persistentEntry.wasSeen) continue;
+
+		RemovePersistent(entity, persistentEntry.range);
+		persistentEntry.isInserted = false;
+	}
+
+	MergePersistentChanges();
 }
 
-std::vector<std::pair<core::Entity, core::Entity>> BroadPhaseGrid::GetCollisionPairs() const
+std::pmr::vector<std::pair<core::Entity, core::Entity>> BroadPhaseGrid::GetCollisionPairs(
+	std::pmr::memory_resource* memoryResource) const
 {
-	std::unordered_multimap<core::Entity, core::Entity> checkedCollisions;
-	std::vector<std::pair<core::Entity, core::Entity>> collisions;
+	std::pmr::vector<std::pair<core::Entity, core::Entity>> collisions(memoryResource);
 	collisions.reserve(64);
 
-	for (auto& gridCol : _grid)
+	const auto tryAddPair = [this, &collisions](const CellEntry& cellEntryA, const CellEntry& cellEntryB)
 	{
-		for (auto& gridCell : gridCol)
-		{
-			for (std::size_t i = 0; i < gridCell.size(); ++i)
-			{
-				core::Entity entityA = gridCell[i];
-				for (std::size_t j = i + 1; j < gridCell.size(); ++j)
-				{
-					core::Entity entityB = gridCell[j];
+		if (cellEntryA.isStatic && cellEntryB.isStatic) return;
 
-					std::pair<core::Entity, core::Entity> bodyPair = entityA < entityB
-						                                                 ? std::make_pair(entityA, entityB)
-						                                                 : std::make_pair(entityB, entityA);
+		// Rejecting on layers first avoids any lookup for pairs like walls and doors
+		if (!_layerCollisionMatrix.HasCollision(cellEntryA.layer, cellEntryB.layer)) return;
 
-					if (HasBeenChecked(checkedCollisions, bodyPair)) continue;
+		const core::Entity entityA = cellEntryA.entity;
+		const core::Entity entityB = cellEntryB.entity;
 
-					checkedCollisions.insert(bodyPair);
+		collisions.emplace_back(std::min(entityA, entityB), std::max(entityA, entityB));
+	};
 
-					const bool aIsDestroyed = _entityManager.HasComponent(entityA,
-					                                                      static_cast<core::EntityMask>(
-						                                                      ComponentType::Destroyed));
-					const bool bIsDestroyed = _entityManager.HasComponent(entityB,
-					                                                      static_cast<core::EntityMask>(
-						                                                      ComponentType::Destroyed));
+	// Both lists are sorted by cell, the persistent bodies of a cell are searched after those of the previous one
+	auto persistentBegin = _persistentCells.begin();
+	for (std::size_t cellBegin = 0; cellBegin < _dynamicCells.size();)
+	{
+		const std::size_t cellIndex = _dynamicCells[cellBegin].cellIndex;
+		std::size_t cellEnd = cellBegin + 1;
+		while (cellEnd < _dynamicCells.size() && _dynamicCells[cellEnd].cellIndex == cellIndex)
+		{
+			cellEnd++;
+		}
 
-					if (aIsDestroyed || bIsDestroyed) continue;
+		persistentBegin = std::lower_bound(persistentBegin, _persistentCells.end(), cellIndex,
+		                                   [](const GridEntry& gridEntry, const std::size_t index)
+		                                   {
+			                                   return gridEntry.cellIndex < index;
+		                                   });
+		auto persistentEnd = persistentBegin;
+		while (persistentEnd != _persistentCells.end() && persistentEnd->cellIndex == cellIndex)
+		{
+			++persistentEnd;
+		}
 
+		for (std::size_t i = cellBegin; i < cellEnd; ++i)
+		{
+			const CellEntry& cellEntryA = _dynamicCells[i].cellEntry;
 
-					collisions.emplace_back(bodyPair.first, bodyPair.second);
-				}
+			// Active against active
+			for (std::size_t j = i + 1; j < cellEnd; ++j)
+			{
+				tryAddPair(cellEntryA, _dynamicCells[j].cellEntry);
+			}
+
+			// Active against persistent, persistent against persistent is never tested
+			for (auto it = persistentBegin; it != persistentEnd; ++it)
+			{
+				tryAddPair(cellEntryA, it->cellEntry);
 			}
 		}
+		cellBegin = cellEnd;
+		persistentBegin = persistentEnd;
 	}
 
+	// Two bodies can only overlap outside of the grid if they are both in the overflow bucket
+	for (std::size_t i = 0; i < _dynamicOverflow.size(); ++i)
+	{
+		for (std::size_t j = i + 1; j < _dynamicOverflow.size(); ++j)
+		{
+			tryAddPair(_dynamicOverflow[i], _dynamicOverflow[j]);
+		}
+
+		for (const CellEntry& cellEntryB : _persistentOverflow)
+		{
+			tryAddPair(_dynamicOverflow[i], cellEntryB);
+		}
+	}
+
+	// Sorting removes the bodies found in several cells, and makes the result independent of the layout
+	std::ranges::sort(collisions);
+	const auto [first, last] = std::ranges::unique(collisions);
+	collisions.erase(first, last);
+
+	std::erase_if(collisions, [this](const std::pair<core::Entity, core::Entity>& bodyPair)
+	{
+		return _entityManager.HasComponent(bodyPair.first,
+		                                   static_cast<core::EntityMask>(ComponentType::Destroyed)) ||
+			_entityManager.HasComponent(bodyPair.second,
+			                            static_cast<core::EntityMask>(ComponentType::Destroyed));
+	});
+
 	return collisions;
 }
 
-bool BroadPhaseGrid::HasBeenChecked(
-	const std::unordered_multimap<core::Entity, core::Entity>& checkedCollisions,
-	const std::pair<core::Entity, core::Entity>& bodyPair
-)
+float BroadPhaseGrid::GetMinCellSize() const
+{
+	const core::Vec2f extents = _max - _min;
+	return std::max(extents.x, extents.y) / static_cast<float>(MAX_CELL_NMB_PER_AXIS);
+}
+
+BroadPhaseGrid::CellRange BroadPhaseGrid::ComputeCellRange(const ColliderBounds& bounds) const
+{
+	const core::Vec2f offsetCenter = bounds.center;
+	const core::Vec2f halfSize = bounds.boundingBoxSize / 2.0f;
+
+	const auto toCell = [this](const float position, const float min)
+	{
+		return static_cast<int>(std::floor((position - min) / _cellSize));
+	};
+
+	const int xMin = toCell(offsetCenter.x - halfSize.x, _min.x);
+	const int yMin = toCell(offsetCenter.y - halfSize.y, _min.y);
+	const int xMax = toCell(offsetCenter.x + halfSize.x, _min.x);
+	const int yMax = toCell(offsetCenter.y + halfSize.y, _min.y);
+
+	const int width = static_cast<int>(_gridWidth);
+	const int height = static_cast<int>(_gridHeight);
+
+	CellRange range;
+	range.isOverflow = xMin < 0 || yMin < 0 || xMax >= width || yMax >= height;
+
+	// A body entirely outside of the grid only goes in the overflow bucket
+	if (xMax < 0 || yMax < 0 || xMin >= width || yMin >= height) return range;
+
+	range.xMin = std::max(xMin, 0);
+	range.yMin = std::max(yMin, 0);
+	range.xMax = std::min(xMax, width - 1);
+	range.yMax = std::min(yMax, height - 1);
+
+	return range;
+}
+
+void BroadPhaseGrid::InsertPersistent(const CellEntry& cellEntry, const CellRange& range)
 {
-	auto [first, second] =
-		checkedCollisions.equal_range(bodyPair.first);
-	bool isContained = false;
-	for (auto& i = first; i != second; ++i)
+	if (range.isOverflow)
 	{
-		if (i->second == bodyPair.second)
+		_persistentOverflow.insert(
+			std::ranges::lower_bound(_persistentOverflow, cellEntry.entity, {}, &CellEntry::entity), cellEntry);
+	}
+
+	for (int x = range.xMin; x <= range.xMax; x++)
+	{
+		for (int y = range.yMin; y <= range.yMax; y++)
+		{
+			const std::size_t cellIndex = static_cast<std::size_t>(x) * _gridHeight + static_cast<std::size_t>(y);
+			_addedPersistentCells.push_back({cellIndex, cellEntry});
+		}
+	}
+}
+
+void BroadPhaseGrid::RemovePersistent(const core::Entity entity, const CellRange& range)
+{
+	if (range.isOverflow)
+	{
+		const auto it = std::ranges::lower_bound(_persistentOverflow, entity, {}, &CellEntry::entity);
+		if (it != _persistentOverflow.end() && it->entity == entity)
+		{
+			_persistentOverflow.erase(it);
+		}
+	}
+
+	if (range.xMax < range.xMin) return;
+
+	_persistentEntries[entity].isRemoved = true;
+	_hasRemovedPersistent = true;
+}
+
+void BroadPhaseGrid::MergePersistentChanges()
+{
+	// The entries inserted in this update are not in the list yet, a body that changed cells only loses its old ones
+	if (_hasRemovedPersistent)
+	{
+		std::erase_if(_persistentCells, [this](const GridEntry& gridEntry)
+		{
+			return _persistentEntries[gridEntry.cellEntry.entity].isRemoved;
+		});
+		for (auto& persistentEntry : _persistentEntries)
 		{
-			isContained = true;
-			break;
+			persistentEntry.isRemoved = false;
 		}
+		_hasRemovedPersistent = false;
 	}
 
-	return isContained;
+	if (_addedPersistentCells.empty()) return;
+
+	// Merged from the back, so that the list is sorted again without any other buffer.
+	// The list is sorted so the pair order only depends on the world state,
+	// and not on the order in which static bodies were inserted.
+	std::ranges::sort(_addedPersistentCells);
+	const std::size_t oldSize = _persistentCells.size();
+	_persistentCells.resize(oldSize + _addedPersistentCells.size());
+
+	std::size_t oldIndex = oldSize;
+	std::size_t addedIndex = _addedPersistentCells.size();
+	std::size_t writeIndex = _persistentCells.size();
+	while (addedIndex > 0)
+	{
+		if (oldIndex > 0 && _addedPersistentCells[addedIndex - 1] < _persistentCells[oldIndex - 1])
+		{
+			_persistentCells[--writeIndex] = _persistentCells[--oldIndex];
+		}
+		else
+		{
+			_persistentCells[--writeIndex] = _addedPersistentCells[--addedIndex];
+		}
+	}
+	core::KeepCapacityMargin(_persistentCells);
+	core::KeepCapacityMargin(_addedPersistentCells);
+	_addedPersistentCells.clear();
 }
 }
@@ -0,0 +1,148 @@
+#include "physics/broad_phase_sap.hpp"
+
+#include <algorithm>
+
+#include "engine/component.hpp"
+
+#include "game/game_globals.hpp"
+
+#include "physics/physics_manager.hpp"
+
+#ifdef TRACY_ENABLE
+#include <Tracy.hpp>
+#endif
+
+namespace game
+{
+BroadPhaseSweepAndPrune::BroadPhaseSweepAndPrune(
+	core::EntityManager& entityManager, RigidbodyManager& rigidbodyManager,
+	AabbColliderManager& aabbManager, CircleColliderManager& circleManager,
+	const LayerCollisionMatrix& layerCollisionMatrix
+)
+	: _entityManager(entityManager), _rigidbodyManager(rigidbodyManager),
+	  _aabbManager(aabbManager), _circleManager(circleManager),
+	  _layerCollisionMatrix(layerCollisionMatrix)
+{
+}
+
+void BroadPhaseSweepAndPrune::Update()
+{
+	#ifdef TRACY_ENABLE
+	ZoneScoped;
+	#endif
+
+	if (_isInserted.size() < _entityManager.GetEntitiesSize())
+	{
+		_isInserted.resize(_entityManager.GetEntitiesSize(), false);
+	}
+
+	// Refresh the bounds of the bodies already in the list and remove the ones that are gone
+	std::erase_if(_entries, [this](Entry& entry)
+	{
+		if (ComputeEntry(entry.entity, entry)) return false;
+
+		_isInserted[entry.entity] = false;
+		return true;
+	});
+
+	// Add the new bodies
+	for (core::Entity entity = 0; entity < _entityManager.GetEntitiesSize(); entity++)
+	{
+		if (_isInserted[entity]) continue;
+
+		Entry entry;
+		if (!ComputeEntry(entity, entry)) continue;
+
+		_entries.push_back(entry);
+		_isInserted[entity] = true;
+	}
+
+	// The list is almost sorted from the last update, so an insertion sort is close to linear
+	for (std::size_t i = 1; i < _entries.size(); i++)
+	{
+		const Entry entry = _entries[i];
+		std::size_t j = i;
+		while (j > 0 && entry.IsBefore(_entries[j - 1]))
+		{
+			_entries[j] = _entries[j - 1];
+			j--;
+		}
+		_entries[j] = entry;
+	}
+}
+
+std::pmr::vector<std::pair<core::Entity, core::Entity>> BroadPhaseSweepAndPrune::GetCollisionPairs(
+	std::pmr::memory_resource* memoryResource) const
+{
+	#ifdef TRACY_ENABLE
+	ZoneScoped;
+	#endif
+
+	std::pmr::vector<std::pair<core::Entity, core::Entity>> collisions(memoryResource);
+	collisions.reserve(64);
+
+	for (std::size_t i = 0; i < _entries.size(); i++)
+	{
+		const Entry& entryA = _entries[i];
+
+		const bool aIsDestroyed = _entityManager.HasComponent(entryA.entity,
+		                                                      static_cast<core::EntityMask>(
+			                                                      ComponentType::Destroyed));
+		if (aIsDestroyed) continue;
+
+		// Since the list is sorted on min x, we can stop as soon as a body starts after this one ends
+		for (std::size_t j = i + 1; j < _entries.size() && _entries[j].min.x <= entryA.max.x; j++)
+		{
+			const Entry& entryB = _entries[j];
+
+			if (!entryA.isActive && !entryB.isActive) continue;
+			if (entryA.isStatic && entryB.isStatic) continue;
+			if (!_layerCollisionMatrix.HasCollision(entryA.layer, entryB.layer)) continue;
+			if (entryA.max.y < entryB.min.y || entryB.max.y < entryA.min.y) continue;
+
+			const bool bIsDestroyed = _entityManager.HasComponent(entryB.entity,
+			                                                      static_cast<core::EntityMask>(
+				                                                      ComponentType::Destroyed));
+			if (bIsDestroyed) continue;
+
+			collisions.emplace_back(std::min(entryA.entity, entryB.entity), std::max(entryA.entity, entryB.entity));
+		}
+	}
+
+	return collisions;
+}
+
+bool BroadPhaseSweepAndPrune::Entry::IsBefore(const Entry& other) const
+{
+	if (min.x != other.min.x) return min.x < other.min.x;
+	return entity < other.entity;
+}
+
+bool BroadPhaseSweepAndPrune::ComputeEntry(const core::Entity entity, Entry& entry) const
+{
+	const bool isRigidbody = _entityManager.HasComponent(entity,
+	                                                     static_cast<core::EntityMask>(
+		                                                     core::ComponentType::Rigidbody));
+	if (!isRigidbody) return false;
+
+	const Rigidbody& body = _rigidbodyManager.GetComponent(entity);
+
+	const std::optional<ColliderBounds> colliderBounds = PhysicsManager::GetColliderBounds(
+		body, entity, _aabbManager, _circleManager);
+
+	if (!colliderBounds) return false;
+
+	// Same extents as the grid, the bounding box size is the full size of the collider
+	const core::Vec2f offsetCenter = colliderBounds->center;
+	const core::Vec2f halfSize = colliderBounds->boundingBoxSize / 2.0f;
+
+	entry.entity = entity;
+	entry.min = offsetCenter - halfSize;
+	entry.max = offsetCenter + halfSize;
+	entry.isStatic = body.IsStatic();
+	entry.isActive = IsActiveInBroadPhase(body);
+	entry.layer = body.GetLayer();
+
+	return true;
+}
+}
@@ -0,0 +1,422 @@
+#include "physics/broad_phase_tree.hpp"
+
+#include <algorithm>
+
+#include "engine/component.hpp"
+
+#include "game/game_globals.hpp"
+
+#include "physics/physics_manager.hpp"
+
+#include "utils/assert.hpp"
+
+#ifdef TRACY_ENABLE
+#include <Tracy.hpp>
+#endif
+
+namespace game
+{
+BroadPhaseAabbTree::BroadPhaseAabbTree(
+	core::EntityManager& entityManager, RigidbodyManager& rigidbodyManager,
+	AabbColliderManager& aabbManager, CircleColliderManager& circleManager,
+	const LayerCollisionMatrix& layerCollisionMatrix
+)
+	: _entityManager(entityManager), _rigidbodyManager(rigidbodyManager),
+	  _aabbManager(aabbManager), _circleManager(circleManager),
+	  _layerCollisionMatrix(layerCollisionMatrix)
+{
+}
+
+void BroadPhaseAabbTree::Update()
+{
+	#ifdef TRACY_ENABLE
+	ZoneScoped;
+	#endif
+
+	if (_proxies.size() < _entityManager.GetEntitiesSize())
+	{
+		_proxies.resize(_entityManager.GetEntitiesSize());
+	}
+
+	for (core::Entity entity = 0; entity < _proxies.size(); entity++)
+	{
+		Proxy& proxy = _proxies[entity];
+
+		const bool hasBounds = entity < _entityManager.GetEntitiesSize() &&
+			ComputeProxy(entity, proxy);
+
+		if (!hasBounds)
+		{
+			if (proxy.node != NULL_NODE)
+			{
+				RemoveLeaf(proxy.node);
+				FreeNode(proxy.node);
+				proxy.node = NULL_NODE;
+			}
+			continue;
+		}
+
+		if (proxy.node != NULL_NODE)
+		{
+			// The body is still inside its fat bounds, nothing to do
+			if (_nodes[proxy.node].bounds.Contains(proxy.bounds)) continue;
+
+			RemoveLeaf(proxy.node);
+		}
+		else
+		{
+			proxy.node = AllocateNode();
+			_nodes[proxy.node].height = 0;
+			_nodes[proxy.node].entity = entity;
+		}
+
+		const core::Vec2f margin{FAT_MARGIN, FAT_MARGIN};
+		_nodes[proxy.node].bounds = {proxy.bounds.min - margin, proxy.bounds.max + margin};
+		InsertLeaf(proxy.node);
+	}
+}
+
+std::pmr::vector<std::pair<core::Entity, core::Entity>> BroadPhaseAabbTree::GetCollisionPairs(
+	std::pmr::memory_resource* memoryResource) const
+{
+	#ifdef TRACY_ENABLE
+	ZoneScoped;
+	#endif
+
+	std::pmr::vector<std::pair<core::Entity, core::Entity>> collisions(memoryResource);
+	collisions.reserve(64);
+
+	std::pmr::vector<int> stack(memoryResource);
+	stack.reserve(64);
+
+	for (core::Entity entity = 0; entity < _proxies.size(); entity++)
+	{
+		const Proxy& proxy = _proxies[entity];
+
+		// Only active bodies query the tree, so pairs of inactive bodies are never tested
+		if (proxy.node == NULL_NODE || !proxy.isActive) continue;
+
+		const bool isDestroyed = _entityManager.HasComponent(entity,
+		                                                     static_cast<core::EntityMask>(
+			                                                     ComponentType::Destroyed));
+		if (isDestroyed) continue;
+
+		stack.clear();
+		stack.push_back(_root);
+
+		while (!stack.empty())
+		{
+			const int nodeIndex = stack.back();
+			stack.pop_back();
+
+			const Node& node = _nodes[nodeIndex];
+			if (!node.bounds.Overlaps(proxy.bounds)) continue;
+
+			if (!node.IsLeaf())
+			{
+				stack.push_back(node.child1);
+				stack.push_back(node.child2);
+				continue;
+			}
+
+			const core::Entity other = node.entity;
+			const Proxy& otherProxy = _proxies[other];
+
+			if (other == entity) continue;
+
+			// A pair of active bodies is found by both bodies, only keep it once
+			if (otherProxy.isActive && other < entity) continue;
+			if (proxy.isStatic && otherProxy.isStatic) continue;
+
+			if (!_layerCollisionMatrix.HasCollision(proxy.layer, otherProxy.layer)) continue;
+
+			// The fat bounds depend on the history of the tree, the tight ones do not
+			if (!otherProxy.bounds.Overlaps(proxy.bounds)) continue;
+
+			const bool otherIsDestroyed = _entityManager.HasComponent(other,
+			                                                          static_cast<core::EntityMask>(
+				                                                          ComponentType::Destroyed));
+			if (otherIsDestroyed) continue;
+
+			collisions.emplace_back(std::min(entity, other), std::max(entity, other));
+		}
+	}
+
+	// The traversal order depends on the shape of the tree, which is not deterministic across peers
+	std::ranges::sort(collisions);
+
+	return collisions;
+}
+
+bool BroadPhaseAabbTree::ComputeProxy(const core::Entity entity, Proxy& proxy) const
+{
+	const bool isRigidbody = _entityManager.HasComponent(entity,
+	                                                     static_cast<core::EntityMask>(
+		                                                     core::ComponentType::Rigidbody));
+	if (!isRigidbody) return false;
+
+	const Rigidbody& body = _rigidbodyManager.GetComponent(entity);
+
+	const std::optional<ColliderBounds> colliderBounds = PhysicsManager::GetColliderBounds(
+		body, entity, _aabbManager, _circleManager);
+
+	if (!colliderBounds) return false;
+
+	// Same extents as the grid, the bounding box size is the full size of the collider
+	const core::Vec2f offsetCenter = colliderBounds->center;
+	const core::Vec2f halfSize = colliderBounds->boundingBoxSize / 2.0f;
+
+	proxy.bounds.min = offsetCenter - halfSize;
+	proxy.bounds.max = offsetCenter + halfSize;
+	proxy.isStatic = body.IsStatic();
+	proxy.isActive = IsActiveInBroadPhase(body);
+	proxy.layer = body.GetLayer();
+
+	return true;
+}
+
+int BroadPhaseAabbTree::AllocateNode()
+{
+	if (_freeList == NULL_NODE)
+	{
+		_nodes.emplace_back();
+		return static_cast<int>(_nodes.size()) - 1;
+	}
+
+	// Free nodes are chained through their parent index
+	const int node = _freeList;
+	_freeList = _nodes[node].parent;
+	_nodes[node] = Node{};
+	return node;
+}
+
+void BroadPhaseAabbTree::FreeNode(const int node)
+{
+	_nodes[node] = Node{};
+	_nodes[node].parent = _freeList;
+	_freeList = node;
+}
+
+void BroadPhaseAabbTree::InsertLeaf(const int leaf)
+{
+	if (_root == NULL_NODE)
+	{
+		_root = leaf;
+		_nodes[_root].parent = NULL_NODE;
+		return;
+	}
+
+	// Find the best sibling, using the perimeter as the cost of a node
+	const Bounds leafBounds = _nodes[leaf].bounds;
+	int index = _root;
+	while (!_nodes[index].IsLeaf())
+	{
+		const Node& node = _nodes[index];
+
+		const float perimeter = node.bounds.Perimeter();
+		const float combinedPerimeter = Bounds::Union(node.bounds, leafBounds).Perimeter();
+
+		// Cost of creating a new parent for this node and the new leaf
+		const float cost = 2.0f * combinedPerimeter;
+
+		// Minimum cost of pushing the leaf further down the tree
+		const float inheritanceCost = 2.0f * (combinedPerimeter - perimeter);
+
+		const auto childCost = [this, &leafBounds, inheritanceCost](const int child)
+		{
+			const Bounds bounds = Bounds::Union(leafBounds, _nodes[child].bounds);
+			if (_nodes[child].IsLeaf()) return bounds.Perimeter() + inheritanceCost;
+
+			return bounds.Perimeter() - _nodes[child].bounds.Perimeter() + inheritanceCost;
+		};
+
+		const float cost1 = childCost(node.child1);
+		const float cost2 = childCost(node.child2);
+
+		if (cost < cost1 && cost < cost2) break;
+
+		index = cost1 < cost2 ? node.child1 : node.child2;
+	}
+
+	const int sibling = index;
+
+	// Create a new parent for the sibling and the leaf
+	const int oldParent = _nodes[sibling].parent;
+	const int newParent = AllocateNode();
+	_nodes[newParent].parent = oldParent;
+	_nodes[newParent].bounds = Bounds::Union(leafBounds, _nodes[sibling].bounds);
+	_nodes[newParent].height = _nodes[sibling].height + 1;
+	_nodes[newParent].child1 = sibling;
+	_nodes[newParent].child2 = leaf;
+	_nodes[sibling].parent = newParent;
+	_nodes[leaf].parent = newParent;
+
+	if (oldParent == NULL_NODE)
+	{
+		_root = newParent;
+	}
+	else if (_nodes[oldParent].child1 == sibling)
+	{
+		_nodes[oldParent].child1 = newParent;
+	}
+	else
+	{
+		_nodes[oldParent].child2 = newParent;
+	}
+
+	// Walk back up the tree fixing heights and bounds
+	index = _nodes[leaf].parent;
+	while (index != NULL_NODE)
+	{
+		index = Balance(index);
+
+		Node& node = _nodes[index];
+		node.height = 1 + std::max(_nodes[node.child1].height, _nodes[node.child2].height);
+		node.bounds = Bounds::Union(_nodes[node.child1].bounds, _nodes[node.child2].bounds);
+
+		index = node.parent;
+	}
+}
+
+void BroadPhaseAabbTree::RemoveLeaf(const int leaf)
+{
+	if (leaf == _root)
+	{
+		_root = NULL_NODE;
+		return;
+	}
+
+	const int parent = _nodes[leaf].parent;
+	const int grandParent = _nodes[parent].parent;
+	const int sibling = _nodes[parent].child1 == leaf ? _nodes[parent].child2 : _nodes[parent].child1;
+
+	FreeNode(parent);
+
+	if (grandParent == NULL_NODE)
+	{
+		_root = sibling;
+		_nodes[sibling].parent = NULL_NODE;
+		_nodes[leaf].parent = NULL_NODE;
+		return;
+	}
+
+	// Replace the parent by the sibling
+	if (_nodes[grandParent].child1 == parent)
+	{
+		_nodes[grandParent].child1 = sibling;
+	}
+	else
+	{
+		_nodes[grandParent].child2 = sibling;
+	}
+	_nodes[sibling].parent = grandParent;
+	_nodes[leaf].parent = NULL_NODE;
+
+	int index = grandParent;
+	while (index != NULL_NODE)
+	{
+		index = Balance(index);
+
+		Node& node = _nodes[index];
+		node.height = 1 + std::max(_nodes[node.child1].height, _nodes[node.child2].height);
+		node.bounds = Bounds::Union(_nodes[node.child1].bounds, _nodes[node.child2].bounds);
+
+		index = node.parent;
+	}
+}
+
+int BroadPhaseAabbTree::Balance(const int nodeA)
+{
+	gpr_assert(nodeA != NULL_NODE, "Cannot balance a null node");
+
+	const Node& a = _nodes[nodeA];
+	if (a.IsLeaf() || a.height < 2) return nodeA;
+
+	const int nodeB = a.child1;
+	const int nodeC = a.child2;
+
+	const int balance = _nodes[nodeC].height - _nodes[nodeB].height;
+
+	// Rotate the highest child up, the lowest one stays under A
+	const auto rotate = [this, nodeA](const int up, const int other)
+	{
+		Node& nodeUp = _nodes[up];
+		const int upChild1 = nodeUp.child1;
+		const int upChild2 = nodeUp.child2;
+
+		// Swap A and its child
+		nodeUp.child1 = nodeA;
+		nodeUp.parent = _nodes[nodeA].parent;
+		_nodes[nodeA].parent = up;
+
+		// A's old parent should point to its child
+		if (nodeUp.parent == NULL_NODE)
+		{
+			_root = up;
+		}
+		else if (_nodes[nodeUp.parent].child1 == nodeA)
+		{
+			_nodes[nodeUp.parent].child1 = up;
+		}
+		else
+		{
+			_nodes[nodeUp.parent].child2 = up;
+		}
+
+		// The highest child of the rotated node stays under it, the other one goes under A
+		const bool firstIsHigher = _nodes[upChild1].height > _nodes[upChild2].height;
+		const int kept = firstIsHigher ? upChild1 : upChild2;
+		const int moved = firstIsHigher ? upChild2 : upChild1;
+
+		Node& nodeARef = _nodes[nodeA];
+		nodeUp.child2 = kept;
+		if (nodeARef.child1 == up)
+		{
+			nodeARef.child1 = moved;
+		}
+		else
+		{
+			nodeARef.child2 = moved;
+		}
+		_nodes[moved].parent = nodeA;
+
+		nodeARef.bounds = Bounds::Union(_nodes[other].bounds, _nodes[moved].bounds);
+		nodeARef.height = 1 + std::max(_nodes[other].height, _nodes[moved].height);
+
+		nodeUp.bounds = Bounds::Union(nodeARef.bounds, _nodes[kept].bounds);
+		nodeUp.height = 1 + std::max(nodeARef.height, _nodes[kept].height);
+
+		return up;
+	};
+
+	if (balance > 1) return rotate(nodeC, nodeB);
+	if (balance < -1) return rotate(nodeB, nodeC);
+
+	return nodeA;
+}
+
+bool BroadPhaseAabbTree::Bounds::Overlaps(const Bounds& other) const
+{
+	return min.x <= other.max.x && other.min.x <= max.x &&
+		min.y <= other.max.y && other.min.y <= max.y;
+}
+
+bool BroadPhaseAabbTree::Bounds::Contains(const Bounds& other) const
+{
+	return min.x <= other.min.x && min.y <= other.min.y &&
+		other.max.x <= max.x && other.max.y <= max.y;
+}
+
+float BroadPhaseAabbTree::Bounds::Perimeter() const
+{
+	return 2.0f * (max.x - min.x + max.y - min.y);
+}
+
+BroadPhaseAabbTree::Bounds BroadPhaseAabbTree::Bounds::Union(const Bounds& a, const Bounds& b)
+{
+	return {
+		{std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y)},
+		{std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y)}
+	};
+}
+}
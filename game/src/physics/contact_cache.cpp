@@ -0,0 +1,49 @@
+#include "physics/contact_cache.hpp"
+
+#include <algorithm>
+
+#include "utils/vector_utility.hpp"
+
+namespace game
+{
+bool CachedContact::IsBefore(const CachedContact& other) const
+{
+	if (firstEntity != other.firstEntity) return firstEntity < other.firstEntity;
+	return secondEntity < other.secondEntity;
+}
+
+const CachedContact* ContactCache::Find(const core::Entity entityA, const core::Entity entityB) const
+{
+	CachedContact key;
+	key.firstEntity = std::min(entityA, entityB);
+	key.secondEntity = std::max(entityA, entityB);
+
+	const auto it = std::ranges::lower_bound(_contacts, key,
+	                                         [](const CachedContact& a, const CachedContact& b)
+	                                         {
+		                                         return a.IsBefore(b);
+	                                         });
+
+	if (it == _contacts.end() || it->firstEntity != key.firstEntity || it->secondEntity != key.secondEntity)
+	{
+		return nullptr;
+	}
+
+	return &*it;
+}
+
+void ContactCache::Store(const std::span<const CachedContact> contacts)
+{
+	_contacts.assign(contacts.begin(), contacts.end());
+	core::KeepCapacityMargin(_contacts);
+	for (auto& contact : _contacts)
+	{
+		if (contact.firstEntity > contact.secondEntity)
+		{
+			std::swap(contact.firstEntity, contact.secondEntity);
+		}
+	}
+
+	std::ranges::sort(_contacts, [](const CachedContact& a, const CachedContact& b) { return a.IsBefore(b); });
+}
+}
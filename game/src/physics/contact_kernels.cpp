@@ -0,0 +1,288 @@
+#include "physics/contact_kernels.hpp"
+
+#include <bit>
+
+#include "physics/manifold_factory.hpp"
+
+// The SIMD paths work on floats, fixed point batches always take the scalar path.
+#if GPR_PHYSICS_FIXED_POINT
+#elif defined(__AVX2__)
+#define CONTACT_KERNELS_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CONTACT_KERNELS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace game::algo
+{
+namespace
+{
+// The scalar versions of min and max have the same semantics as the SIMD instructions,
+// (the second operand is returned when the values are equal) so that every path gives the same bits.
+Scalar Max(const Scalar a, const Scalar b)
+{
+	return a > b ? a : b;
+}
+
+Scalar Min(const Scalar a, const Scalar b)
+{
+	return a < b ? a : b;
+}
+
+bool IsCircleCircleHit(const CircleCircleBatch& batch, const std::size_t i)
+{
+	const Scalar dx = batch.bX[i] - batch.aX[i];
+	const Scalar dy = batch.bY[i] - batch.aY[i];
+	const Scalar radiusSum = batch.aRadius[i] + batch.bRadius[i];
+
+	return dx * dx + dy * dy < radiusSum * radiusSum;
+}
+
+bool IsAabbCircleHit(const AabbCircleBatch& batch, const std::size_t i)
+{
+	const Scalar dx = batch.bX[i] - batch.aX[i];
+	const Scalar dy = batch.bY[i] - batch.aY[i];
+
+	const Scalar clampedX = Min(Max(dx, -batch.aHalfWidth[i]), batch.aHalfWidth[i]);
+	const Scalar clampedY = Min(Max(dy, -batch.aHalfHeight[i]), batch.aHalfHeight[i]);
+
+	// Closest point on the aabb to the center of the circle, relative to the circle
+	const Scalar toClosestX = batch.aX[i] + clampedX - batch.bX[i];
+	const Scalar toClosestY = batch.aY[i] + clampedY - batch.bY[i];
+
+	const bool isCenterInside = clampedX == dx && clampedY == dy;
+	const Scalar radius = batch.bRadius[i];
+
+	return isCenterInside || toClosestX * toClosestX + toClosestY * toClosestY < radius * radius;
+}
+
+void PushCircleCircleHits(const CircleCircleBatch& batch, const std::size_t first,
+                          std::pmr::vector<std::uint32_t>& hits)
+{
+	for (std::size_t i = first; i < batch.Size(); i++)
+	{
+		if (IsCircleCircleHit(batch, i)) hits.push_back(static_cast<std::uint32_t>(i));
+	}
+}
+
+void PushAabbCircleHits(const AabbCircleBatch& batch, const std::size_t first, std::pmr::vector<std::uint32_t>& hits)
+{
+	for (std::size_t i = first; i < batch.Size(); i++)
+	{
+		if (IsAabbCircleHit(batch, i)) hits.push_back(static_cast<std::uint32_t>(i));
+	}
+}
+
+void PushHits(int mask, const std::uint32_t first, std::pmr::vector<std::uint32_t>& hits)
+{
+	while (mask != 0)
+	{
+		const int bit = std::countr_zero(static_cast<unsigned>(mask));
+		hits.push_back(first + static_cast<std::uint32_t>(bit));
+		mask &= mask - 1;
+	}
+}
+}
+
+void CircleCircleBatch::Clear()
+{
+	aX.clear();
+	aY.clear();
+	aRadius.clear();
+	bX.clear();
+	bY.clear();
+	bRadius.clear();
+}
+
+void CircleCircleBatch::Reserve(const std::size_t size)
+{
+	aX.reserve(size);
+	aY.reserve(size);
+	aRadius.reserve(size);
+	bX.reserve(size);
+	bY.reserve(size);
+	bRadius.reserve(size);
+}
+
+void CircleCircleBatch::Add(const CircleCollider& a, const Transform& ta, const CircleCollider& b, const Transform& tb)
+{
+	aX.push_back(a.center.x + ta.position.x);
+	aY.push_back(a.center.y + ta.position.y);
+	aRadius.push_back(a.radius * ta.scale.Major());
+	bX.push_back(b.center.x + tb.position.x);
+	bY.push_back(b.center.y + tb.position.y);
+	bRadius.push_back(b.radius * tb.scale.Major());
+}
+
+void AabbCircleBatch::Clear()
+{
+	aX.clear();
+	aY.clear();
+	aHalfWidth.clear();
+	aHalfHeight.clear();
+	bX.clear();
+	bY.clear();
+	bRadius.clear();
+}
+
+void AabbCircleBatch::Reserve(const std::size_t size)
+{
+	aX.reserve(size);
+	aY.reserve(size);
+	aHalfWidth.reserve(size);
+	aHalfHeight.reserve(size);
+	bX.reserve(size);
+	bY.reserve(size);
+	bRadius.reserve(size);
+}
+
+void AabbCircleBatch::Add(const AabbCollider& a, const Transform& ta, const CircleCollider& b, const Transform& tb)
+{
+	aX.push_back(ta.position.x + a.center.x);
+	aY.push_back(ta.position.y + a.center.y);
+	aHalfWidth.push_back(a.halfWidth * ta.scale.x);
+	aHalfHeight.push_back(a.halfHeight * ta.scale.y);
+	bX.push_back(tb.position.x + b.center.x);
+	bY.push_back(tb.position.y + b.center.y);
+	bRadius.push_back(b.radius * tb.scale.Major());
+}
+
+void FindCircleCircleHits(const CircleCircleBatch& batch, std::pmr::vector<std::uint32_t>& hits)
+{
+	hits.clear();
+	[[maybe_unused]] const std::size_t size = batch.Size();
+	std::size_t i = 0;
+
+#if defined(CONTACT_KERNELS_AVX2)
+	for (; i + 8 <= size; i += 8)
+	{
+		const __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(&batch.bX[i]), _mm256_loadu_ps(&batch.aX[i]));
+		const __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(&batch.bY[i]), _mm256_loadu_ps(&batch.aY[i]));
+		const __m256 radiusSum = _mm256_add_ps(_mm256_loadu_ps(&batch.aRadius[i]), _mm256_loadu_ps(&batch.bRadius[i]));
+
+		const __m256 sqrDistance = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+		const __m256 isHit = _mm256_cmp_ps(sqrDistance, _mm256_mul_ps(radiusSum, radiusSum), _CMP_LT_OQ);
+
+		PushHits(_mm256_movemask_ps(isHit), static_cast<std::uint32_t>(i), hits);
+	}
+#elif defined(CONTACT_KERNELS_SSE2)
+	for (; i + 4 <= size; i += 4)
+	{
+		const __m128 dx = _mm_sub_ps(_mm_loadu_ps(&batch.bX[i]), _mm_loadu_ps(&batch.aX[i]));
+		const __m128 dy = _mm_sub_ps(_mm_loadu_ps(&batch.bY[i]), _mm_loadu_ps(&batch.aY[i]));
+		const __m128 radiusSum = _mm_add_ps(_mm_loadu_ps(&batch.aRadius[i]), _mm_loadu_ps(&batch.bRadius[i]));
+
+		const __m128 sqrDistance = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+		const __m128 isHit = _mm_cmplt_ps(sqrDistance, _mm_mul_ps(radiusSum, radiusSum));
+
+		PushHits(_mm_movemask_ps(isHit), static_cast<std::uint32_t>(i), hits);
+	}
+#endif
+
+	PushCircleCircleHits(batch, i, hits);
+}
+
+void FindAabbCircleHits(const AabbCircleBatch& batch, std::pmr::vector<std::uint32_t>& hits)
+{
+	hits.clear();
+	[[maybe_unused]] const std::size_t size = batch.Size();
+	std::size_t i = 0;
+
+#if defined(CONTACT_KERNELS_AVX2)
+	const __m256 signMask = _mm256_set1_ps(-0.0f);
+	for (; i + 8 <= size; i += 8)
+	{
+		const __m256 aX = _mm256_loadu_ps(&batch.aX[i]);
+		const __m256 aY = _mm256_loadu_ps(&batch.aY[i]);
+		const __m256 bX = _mm256_loadu_ps(&batch.bX[i]);
+		const __m256 bY = _mm256_loadu_ps(&batch.bY[i]);
+		const __m256 halfWidth = _mm256_loadu_ps(&batch.aHalfWidth[i]);
+		const __m256 halfHeight = _mm256_loadu_ps(&batch.aHalfHeight[i]);
+		const __m256 radius = _mm256_loadu_ps(&batch.bRadius[i]);
+
+		const __m256 dx = _mm256_sub_ps(bX, aX);
+		const __m256 dy = _mm256_sub_ps(bY, aY);
+
+		const __m256 clampedX = _mm256_min_ps(_mm256_max_ps(dx, _mm256_xor_ps(halfWidth, signMask)), halfWidth);
+		const __m256 clampedY = _mm256_min_ps(_mm256_max_ps(dy, _mm256_xor_ps(halfHeight, signMask)), halfHeight);
+
+		const __m256 toClosestX = _mm256_sub_ps(_mm256_add_ps(aX, clampedX), bX);
+		const __m256 toClosestY = _mm256_sub_ps(_mm256_add_ps(aY, clampedY), bY);
+
+		const __m256 isCenterInside = _mm256_and_ps(_mm256_cmp_ps(clampedX, dx, _CMP_EQ_OQ),
+		                                            _mm256_cmp_ps(clampedY, dy, _CMP_EQ_OQ));
+		const __m256 sqrDistance = _mm256_add_ps(_mm256_mul_ps(toClosestX, toClosestX),
+		                                         _mm256_mul_ps(toClosestY, toClosestY));
+		const __m256 isClose = _mm256_cmp_ps(sqrDistance, _mm256_mul_ps(radius, radius), _CMP_LT_OQ);
+
+		PushHits(_mm256_movemask_ps(_mm256_or_ps(isCenterInside, isClose)), static_cast<std::uint32_t>(i), hits);
+	}
+#elif defined(CONTACT_KERNELS_SSE2)
+	const __m128 signMask = _mm_set1_ps(-0.0f);
+	for (; i + 4 <= size; i += 4)
+	{
+		const __m128 aX = _mm_loadu_ps(&batch.aX[i]);
+		const __m128 aY = _mm_loadu_ps(&batch.aY[i]);
+		const __m128 bX = _mm_loadu_ps(&batch.bX[i]);
+		const __m128 bY = _mm_loadu_ps(&batch.bY[i]);
+		const __m128 halfWidth = _mm_loadu_ps(&batch.aHalfWidth[i]);
+		const __m128 halfHeight = _mm_loadu_ps(&batch.aHalfHeight[i]);
+		const __m128 radius = _mm_loadu_ps(&batch.bRadius[i]);
+
+		const __m128 dx = _mm_sub_ps(bX, aX);
+		const __m128 dy = _mm_sub_ps(bY, aY);
+
+		const __m128 clampedX = _mm_min_ps(_mm_max_ps(dx, _mm_xor_ps(halfWidth, signMask)), halfWidth);
+		const __m128 clampedY = _mm_min_ps(_mm_max_ps(dy, _mm_xor_ps(halfHeight, signMask)), halfHeight);
+
+		const __m128 toClosestX = _mm_sub_ps(_mm_add_ps(aX, clampedX), bX);
+		const __m128 toClosestY = _mm_sub_ps(_mm_add_ps(aY, clampedY), bY);
+
+		const __m128 isCenterInside = _mm_and_ps(_mm_cmpeq_ps(clampedX, dx), _mm_cmpeq_ps(clampedY, dy));
+		const __m128 sqrDistance = _mm_add_ps(_mm_mul_ps(toClosestX, toClosestX), _mm_mul_ps(toClosestY, toClosestY));
+		const __m128 isClose = _mm_cmplt_ps(sqrDistance, _mm_mul_ps(radius, radius));
+
+		PushHits(_mm_movemask_ps(_mm_or_ps(isCenterInside, isClose)), static_cast<std::uint32_t>(i), hits);
+	}
+#endif
+
+	PushAabbCircleHits(batch, i, hits);
+}
+
+void FindCircleCircleHitsScalar(const CircleCircleBatch& batch, std::pmr::vector<std::uint32_t>& hits)
+{
+	hits.clear();
+	PushCircleCircleHits(batch, 0, hits);
+}
+
+void FindAabbCircleHitsScalar(const AabbCircleBatch& batch, std::pmr::vector<std::uint32_t>& hits)
+{
+	hits.clear();
+	PushAabbCircleHits(batch, 0, hits);
+}
+
+Manifold BuildCircleCircleManifold(const CircleCircleBatch& batch, const std::size_t index)
+{
+	return CircleCircleContact(
+		{batch.aX[index], batch.aY[index]}, batch.aRadius[index],
+		{batch.bX[index], batch.bY[index]}, batch.bRadius[index]);
+}
+
+Manifold BuildAabbCircleManifold(const AabbCircleBatch& batch, const std::size_t index)
+{
+	// The batch is already in world space, so the colliders are rebuilt with an identity transform
+	AabbCollider aabb;
+	aabb.halfWidth = batch.aHalfWidth[index];
+	aabb.halfHeight = batch.aHalfHeight[index];
+	Transform aabbTransform;
+	aabbTransform.position = {batch.aX[index], batch.aY[index]};
+
+	CircleCollider circle;
+	circle.radius = batch.bRadius[index];
+	Transform circleTransform;
+	circleTransform.position = {batch.bX[index], batch.bY[index]};
+
+	return FindAabbCircleManifold(&aabb, &aabbTransform, &circle, &circleTransform);
+}
+}
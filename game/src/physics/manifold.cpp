@@ -2,18 +2,18 @@
 
 namespace game
 {
-Manifold::Manifold(const core::Vec2f& a, const core::Vec2f& b, const core::Vec2f& normal, const float depth)
+Manifold::Manifold(const Vec2s& a, const Vec2s& b, const Vec2s& normal, const Scalar depth)
 	: a(a), b(b), normal(normal), depth(depth), hasCollision(true)
 {
 }
 
-Manifold::Manifold(const core::Vec2f& normal, const float depth)
-	: Manifold(core::Vec2f(), core::Vec2f(), normal, depth)
+Manifold::Manifold(const Vec2s& normal, const Scalar depth)
+	: Manifold(Vec2s(), Vec2s(), normal, depth)
 {
 }
 
 Manifold::Manifold()
-	: Manifold(core::Vec2f(), 0.0f)
+	: Manifold(Vec2s(), 0.0f)
 {
 	hasCollision = false;
 }
@@ -13,52 +13,60 @@ Manifold algo::FindCircleCircleManifold(
 	const CircleCollider* a, const Transform* ta,
 	const CircleCollider* b, const Transform* tb)
 {
-	core::Vec2f aPos = a->center + ta->position;
-	core::Vec2f bPos = b->center + tb->position;
+	const Vec2s aPos = a->center + ta->position;
+	const Vec2s bPos = b->center + tb->position;
 
-	const float aRadius = a->radius * ta->scale.Major();
-	const float bRadius = b->radius * tb->scale.Major();
+	const Scalar aRadius = a->radius * ta->scale.Major();
+	const Scalar bRadius = b->radius * tb->scale.Major();
 
-	const core::Vec2f aToB = bPos - aPos;
-	const core::Vec2f bToA = aPos - bPos;
+	const Vec2s aToB = bPos - aPos;
+	const Scalar radiusSum = aRadius + bRadius;
 
-	if (aToB.GetMagnitude() > aRadius + bRadius)
+	// Compare squared distances, so that the square root is only computed on collisions
+	if (aToB.GetSqrMagnitude() >= radiusSum * radiusSum)
 	{
 		return Manifold::Empty();
 	}
 
-	aPos += aToB.NewMagnitude(aRadius);
-	bPos += bToA.NewMagnitude(bRadius);
+	return CircleCircleContact(aPos, aRadius, bPos, bRadius);
+}
+
+Manifold algo::CircleCircleContact(
+	const Vec2s& aPos, const Scalar aRadius,
+	const Vec2s& bPos, const Scalar bRadius)
+{
+	const Vec2s aToB = bPos - aPos;
+	const Scalar distance = aToB.GetMagnitude();
+
+	// Circles on top of each other have no direction, so they are separated vertically
+	const Vec2s direction = distance > 0.0f ? aToB / distance : Vec2s(0.0f, 1.0f);
 
-	const core::Vec2f collisionPointsDistance = bPos - aPos;
+	// Points on each circle that are the furthest inside the other one
+	const Vec2s aPoint = aPos + direction * aRadius;
+	const Vec2s bPoint = bPos - direction * bRadius;
 
-	return {
-		aPos,
-		bPos,
-		collisionPointsDistance.GetNormalized(),
-		collisionPointsDistance.GetMagnitude()
-	};
+	return {aPoint, bPoint, -direction, aRadius + bRadius - distance};
 }
 
 Manifold algo::FindAabbAabbManifold(
 	const AabbCollider* a, const Transform* ta,
 	const AabbCollider* b, const Transform* tb)
 {
-	const core::Vec2f transformedCenterA = ta->position + a->center;
-	const float aScaledHWidth = a->halfWidth * ta->scale.x;
-	const float aScaledHHeight = a->halfHeight * ta->scale.y;
+	const Vec2s transformedCenterA = ta->position + a->center;
+	const Scalar aScaledHWidth = a->halfWidth * ta->scale.x;
+	const Scalar aScaledHHeight = a->halfHeight * ta->scale.y;
 
-	const core::Vec2f transformedCenterB = tb->position + b->center;
-	const float bScaledHWidth = b->halfWidth * tb->scale.x;
-	const float bScaledHHeight = b->halfHeight * tb->scale.y;
+	const Vec2s transformedCenterB = tb->position + b->center;
+	const Scalar bScaledHWidth = b->halfWidth * tb->scale.x;
+	const Scalar bScaledHHeight = b->halfHeight * tb->scale.y;
 
-	const core::Vec2f aToB = transformedCenterB - transformedCenterA;
-	const float xOverlap = aScaledHWidth + bScaledHWidth - std::abs(aToB.x);
+	const Vec2s aToB = transformedCenterB - transformedCenterA;
+	const Scalar xOverlap = aScaledHWidth + bScaledHWidth - Abs(aToB.x);
 
 	// Overlap test on x axis
 	if (xOverlap <= 0.0f) return Manifold::Empty();
 
-	const float yOverlap = aScaledHHeight + bScaledHHeight - std::abs(aToB.y);
+	const Scalar yOverlap = aScaledHHeight + bScaledHHeight - Abs(aToB.y);
 
 	// Overlap test on y axis
 	if (yOverlap <= 0.0f) return Manifold::Empty();
@@ -67,24 +75,24 @@ Manifold algo::FindAabbAabbManifold(
 	if (xOverlap > yOverlap)
 	{
 		// Point towards B knowing that aToB points from A to B
-		core::Vec2f normal;
+		Vec2s normal;
 
-		float aY;
-		float bY;
+		Scalar aY;
+		Scalar bY;
 		if (aToB.y > 0.0f)
 		{
-			normal = core::Vec2f(0.0f, -1.0f);
+			normal = Vec2s(0.0f, -1.0f);
 			aY = transformedCenterA.y + aScaledHHeight;
 			bY = transformedCenterB.y - bScaledHHeight;
 		}
 		else
 		{
-			normal = core::Vec2f(0.0f, 1.0f);
+			normal = Vec2s(0.0f, 1.0f);
 			aY = transformedCenterA.y - aScaledHHeight;
 			bY = transformedCenterB.y + bScaledHHeight;
 		}
 
-		float x;
+		Scalar x;
 		if (aToB.x > 0.0f)
 		{
 			x = transformedCenterA.x + aScaledHWidth - xOverlap / 2.0f;
@@ -98,9 +106,9 @@ Manifold algo::FindAabbAabbManifold(
 	}
 
 	// Point towards B knowing that aToB points from A to B
-	core::Vec2f normal;
+	Vec2s normal;
 
-	float y;
+	Scalar y;
 	if (aToB.y > 0.0f)
 	{
 		y = transformedCenterA.x + aScaledHWidth - xOverlap / 2.0f;
@@ -110,17 +118,17 @@ Manifold algo::FindAabbAabbManifold(
 		y = transformedCenterA.x - aScaledHWidth + xOverlap / 2.0f;
 	}
 
-	float aX;
-	float bX;
+	Scalar aX;
+	Scalar bX;
 	if (aToB.x > 0.0f)
 	{
-		normal = core::Vec2f(-1.0f, 0.0f);
+		normal = Vec2s(-1.0f, 0.0f);
 		aX = transformedCenterA.x + aScaledHWidth;
 		bX = transformedCenterB.x - bScaledHWidth;
 	}
 	else
 	{
-		normal = core::Vec2f(1.0f, 0.0f);
+		normal = Vec2s(1.0f, 0.0f);
 		aX = transformedCenterA.x - aScaledHWidth;
 		bX = transformedCenterB.x + bScaledHWidth;
 	}
@@ -132,17 +140,17 @@ Manifold algo::FindAabbCircleManifold(
 	const CircleCollider* b, const Transform* tb)
 {
 	// Apply the transform to the AabbCollider
-	const core::Vec2f aabbCenter = ta->position + a->center;
-	const float scaledHWidth = a->halfWidth * ta->scale.x;
-	const float scaledHHeight = a->halfHeight * ta->scale.y;
+	const Vec2s aabbCenter = ta->position + a->center;
+	const Scalar scaledHWidth = a->halfWidth * ta->scale.x;
+	const Scalar scaledHHeight = a->halfHeight * ta->scale.y;
 
 	// Apply the transform to the circle collider
-	const core::Vec2f circleCenter = tb->position + b->center;
-	const float scaledRadius = b->radius * tb->scale.Major();
+	const Vec2s circleCenter = tb->position + b->center;
+	const Scalar scaledRadius = b->radius * tb->scale.Major();
 
-	const core::Vec2f aabbToCircle = circleCenter - aabbCenter;
+	const Vec2s aabbToCircle = circleCenter - aabbCenter;
 
-	core::Vec2f clampedPoint;
+	Vec2s clampedPoint;
 
 	// Clamp point to the edge of the AABB
 	clampedPoint.x = std::clamp(aabbToCircle.x, -scaledHWidth, scaledHWidth);
@@ -156,12 +164,12 @@ Manifold algo::FindAabbCircleManifold(
 		isCircleCenterInside = true;
 
 		// We still want one point on the side of the AABB, so we find the nearest border, and clamp on it
-		const float distToPosWidth = std::abs(scaledHWidth - clampedPoint.x);
-		const float distToNegWidth = std::abs(-scaledHWidth - clampedPoint.x);
-		const float distToPosHeight = std::abs(scaledHHeight - clampedPoint.y);
-		const float distToNegHeight = std::abs(-scaledHHeight - clampedPoint.y);
+		const Scalar distToPosWidth = Abs(scaledHWidth - clampedPoint.x);
+		const Scalar distToNegWidth = Abs(-scaledHWidth - clampedPoint.x);
+		const Scalar distToPosHeight = Abs(scaledHHeight - clampedPoint.y);
+		const Scalar distToNegHeight = Abs(-scaledHHeight - clampedPoint.y);
 
-		const float smallest = std::min({distToPosWidth, distToNegWidth, distToPosHeight, distToNegHeight});
+		const Scalar smallest = std::min({distToPosWidth, distToNegWidth, distToPosHeight, distToNegHeight});
 
 		if (smallest == distToPosWidth) // NOLINT(clang-diagnostic-float-equal)
 		{
@@ -182,27 +190,29 @@ Manifold algo::FindAabbCircleManifold(
 	}
 
 	// Put the point in "world space" because it was relative to the center
-	const core::Vec2f closestPointOnAabb = aabbCenter + clampedPoint;
+	const Vec2s closestPointOnAabb = aabbCenter + clampedPoint;
 
-	const core::Vec2f circleToClosestPoint = closestPointOnAabb - circleCenter;
+	const Vec2s circleToClosestPoint = closestPointOnAabb - circleCenter;
 
 	// Distance between the circle center and the clamped point
-	const float squaredDistance = circleToClosestPoint.GetSqrMagnitude();
+	const Scalar squaredDistance = circleToClosestPoint.GetSqrMagnitude();
 
 	if (!isCircleCenterInside && squaredDistance >= scaledRadius * scaledRadius) return Manifold::Empty();
 
-	// This is the collision point around the circle
-	core::Vec2f aroundCirclePoint = circleToClosestPoint.NewMagnitude(scaledRadius);
-	if (isCircleCenterInside)
-	{
-		aroundCirclePoint = -aroundCirclePoint;
-	}
+	// A center on the border of the AABB has no direction to it, so it is separated vertically
+	const Scalar distance = circleToClosestPoint.GetMagnitude();
+	const Vec2s direction = distance > 0.0f ? circleToClosestPoint / distance : Vec2s(0.0f, 1.0f);
 
-	core::Vec2f worldAroundCirclePoint = aroundCirclePoint + circleCenter;
+	// This is the collision point around the circle
+	const Vec2s aroundCirclePoint = isCircleCenterInside ? -direction * scaledRadius : direction * scaledRadius;
+	const Vec2s worldAroundCirclePoint = aroundCirclePoint + circleCenter;
 
-	const core::Vec2f diff = closestPointOnAabb - worldAroundCirclePoint;
+	// The normal goes from the point around the circle to the closest point, it is not computed from their difference
+	// because they are the same point when the circle only touches the AABB
+	const Vec2s normal = isCircleCenterInside ? direction : -direction;
+	const Scalar depth = isCircleCenterInside ? scaledRadius + distance : scaledRadius - distance;
 
-	return {worldAroundCirclePoint, closestPointOnAabb, diff.GetNormalized(), diff.GetMagnitude()};
+	return {worldAroundCirclePoint, closestPointOnAabb, normal, depth};
 }
 
 Manifold algo::FindCircleAabbManifold(const CircleCollider* a, const Transform* ta, const AabbCollider* b,
@@ -1,10 +1,19 @@
 #include "physics/physics_manager.hpp"
 
+#include <algorithm>
+#include <array>
+#include <limits>
+
 #include <SFML/Graphics/CircleShape.hpp>
 #include <SFML/Graphics/RectangleShape.hpp>
 
 #include "engine/transform.hpp"
 
+#include "physics/broad_phase_grid.hpp"
+#include "physics/broad_phase_sap.hpp"
+#include "physics/broad_phase_tree.hpp"
+#include "physics/contact_kernels.hpp"
+
 #include "game/game_globals.hpp"
 
 #ifdef TRACY_ENABLE
@@ -13,19 +22,15 @@
 
 namespace game
 {
-PhysicsManager::PhysicsManager(core::EntityManager& entityManager)
+PhysicsManager::PhysicsManager(core::EntityManager& entityManager, const BroadPhaseType broadPhaseType)
 	: _entityManager(entityManager),
 	  _rigidbodyManager(entityManager),
 	  _aabbManager(entityManager),
-	  _circleManager(entityManager), _impulseSolver(_entityManager, _rigidbodyManager),
+	  _circleManager(entityManager), _impulseSolver(_entityManager, _rigidbodyManager, _contactCache),
 	  _smoothPositionSolver(_entityManager, _rigidbodyManager),
-	  _grid(-500, 500, -500, 500, 10, _entityManager, _rigidbodyManager, _aabbManager, _circleManager)
+	  _broadPhaseType(broadPhaseType)
 {
-	_layerCollisionMatrix.SetCollision(Layer::Ball, Layer::MiddleWall, false);
-	_layerCollisionMatrix.SetCollision(Layer::Wall, Layer::Wall, false);
-	_layerCollisionMatrix.SetCollision(Layer::Wall, Layer::Door, false);
-	_layerCollisionMatrix.SetCollision(Layer::Wall, Layer::MiddleWall, false);
-	_layerCollisionMatrix.SetCollision(Layer::MiddleWall, Layer::Door, false);
+	SetBroadPhaseType(broadPhaseType);
 }
 
 std::optional<core::ComponentType> PhysicsManager::HasCollider(const core::EntityManager& entityManager,
@@ -46,6 +51,43 @@ std::optional<core::ComponentType> PhysicsManager::HasCollider(const core::Entit
 	return {};
 }
 
+void PhysicsManager::SetBroadPhaseType(const BroadPhaseType broadPhaseType)
+{
+	_broadPhaseType = broadPhaseType;
+
+	switch (broadPhaseType)
+	{
+	case BroadPhaseType::Grid:
+		// The cell size is fitted to the bodies by the grid itself
+		_broadPhase = std::make_unique<BroadPhaseGrid>(
+			_worldMin.x, _worldMax.x, _worldMin.y, _worldMax.y, 1.0f,
+			_entityManager, _rigidbodyManager, _aabbManager, _circleManager, _layerCollisionMatrix);
+		break;
+	case BroadPhaseType::SweepAndPrune:
+		_broadPhase = std::make_unique<BroadPhaseSweepAndPrune>(
+			_entityManager, _rigidbodyManager, _aabbManager, _circleManager, _layerCollisionMatrix);
+		break;
+	case BroadPhaseType::AabbTree:
+		_broadPhase = std::make_unique<BroadPhaseAabbTree>(
+			_entityManager, _rigidbodyManager, _aabbManager, _circleManager, _layerCollisionMatrix);
+		break;
+	}
+}
+
+void PhysicsManager::SetWorldBounds(const core::Vec2f min, const core::Vec2f max)
+{
+	_worldMin = min;
+	_worldMax = max;
+	_broadPhase->SetWorldBounds(min, max);
+}
+
+void PhysicsManager::SetSolverIterations(const std::uint32_t velocityIterations,
+                                         const std::uint32_t positionIterations)
+{
+	_impulseSolver.SetIterations(velocityIterations);
+	_smoothPositionSolver.SetIterations(positionIterations);
+}
+
 void PhysicsManager::MoveBodies(const sf::Time deltaTime)
 {
 	for (core::Entity entity = 0; entity < _entityManager.GetEntitiesSize(); entity++)
@@ -58,13 +100,13 @@ void PhysicsManager::MoveBodies(const sf::Time deltaTime)
 
 		Rigidbody& rigidbody = GetRigidbody(entity);
 
-		if (rigidbody.IsStatic()) continue;
+		if (rigidbody.IsStatic() || !rigidbody.IsAwake()) continue;
 
 		const auto draggedVel = rigidbody.Velocity() * rigidbody.DragFactor();
-		const core::Vec2f vel = draggedVel + rigidbody.Force() * rigidbody.InvMass() * deltaTime.asSeconds();
+		const Vec2s vel = draggedVel + rigidbody.Force() * rigidbody.InvMass() * deltaTime.asSeconds();
 		rigidbody.SetVelocity(vel);
 
-		core::Vec2f pos = rigidbody.Position() + rigidbody.Velocity() * deltaTime.asSeconds();
+		Vec2s pos = rigidbody.Position() + rigidbody.Velocity() * deltaTime.asSeconds();
 		rigidbody.SetPosition(pos);
 
 		rigidbody.SetForce({0, 0});
@@ -77,9 +119,29 @@ void PhysicsManager::FixedUpdate(const sf::Time deltaTime)
 	ZoneScoped;
 	#endif
 
+	// Everything allocated during the last step is released at once
+	_frameArena.Reset();
+
+	using Clock = std::chrono::steady_clock;
+
+	const Clock::time_point gravityStart = Clock::now();
 	ApplyGravity();
+	const std::chrono::nanoseconds gravityTime = Clock::now() - gravityStart;
+
 	ResolveCollisions(deltaTime);
+
+	const Clock::time_point integrateStart = Clock::now();
 	MoveBodies(deltaTime);
+	_lastStepStats.integrate = gravityTime + (Clock::now() - integrateStart);
+
+	// Static bodies moved by the game are detected by comparing with this position on the next step
+	for (core::Entity entity = 0; entity < _entityManager.GetEntitiesSize(); entity++)
+	{
+		if (!_entityManager.HasComponent(entity, static_cast<core::EntityMask>(core::ComponentType::Rigidbody)))
+			continue;
+
+		GetRigidbody(entity).ResetMoved();
+	}
 }
 
 void PhysicsManager::SetRigidbody(const core::Entity entity, Rigidbody& body)
@@ -89,6 +151,7 @@ void PhysicsManager::SetRigidbody(const core::Entity entity, Rigidbody& body)
 		body.SetGravityAcceleration(_gravity);
 	}
 	_rigidbodyManager.SetComponent(entity, body);
+	UpdateShapeType(entity);
 }
 
 const Rigidbody& PhysicsManager::GetRigidbody(const core::Entity entity) const
@@ -109,11 +172,13 @@ void PhysicsManager::AddRigidbody(const core::Entity entity)
 	{
 		rb.SetGravityAcceleration(_gravity);
 	}
+	UpdateShapeType(entity);
 }
 
 void PhysicsManager::AddAabbCollider(const core::Entity entity)
 {
 	_aabbManager.AddComponent(entity);
+	UpdateShapeType(entity);
 }
 
 void PhysicsManager::SetAabbCollider(const core::Entity entity, const AabbCollider& aabbCollider)
@@ -129,6 +194,7 @@ AabbCollider& PhysicsManager::GetAabbCollider(const core::Entity entity)
 void PhysicsManager::AddCircleCollider(const core::Entity entity)
 {
 	_circleManager.AddComponent(entity);
+	UpdateShapeType(entity);
 }
 
 void PhysicsManager::SetCircleCollider(const core::Entity entity, const CircleCollider& circleCollider)
@@ -141,22 +207,16 @@ CircleCollider& PhysicsManager::GetCircleCollider(const core::Entity entity)
 	return _circleManager.GetComponent(entity);
 }
 
-void PhysicsManager::RegisterTriggerListener(OnTriggerInterface& onTriggerInterface)
+void PhysicsManager::RegisterTriggerListener(OnTriggerInterface& onTriggerInterface,
+                                             const core::EntityMask firstMask, const core::EntityMask secondMask)
 {
-	_onTriggerAction.RegisterCallback(
-		[&onTriggerInterface](const core::Entity entity1, const core::Entity entity2)
-		{
-			onTriggerInterface.OnTrigger(entity1, entity2);
-		});
+	_triggerEventBuffers.push_back({&onTriggerInterface, firstMask, secondMask, {}});
 }
 
-void PhysicsManager::RegisterCollisionListener(OnCollisionInterface& onCollisionInterface)
+void PhysicsManager::RegisterCollisionListener(OnCollisionInterface& onCollisionInterface,
+                                               const core::EntityMask firstMask, const core::EntityMask secondMask)
 {
-	_onCollisionAction.RegisterCallback(
-		[&onCollisionInterface](const core::Entity entity1, const core::Entity entity2)
-		{
-			onCollisionInterface.OnCollision(entity1, entity2);
-		});
+	_collisionEventBuffers.push_back({&onCollisionInterface, firstMask, secondMask, {}});
 }
 
 void PhysicsManager::CopyAllComponents(const PhysicsManager& physicsManager)
@@ -164,6 +224,7 @@ void PhysicsManager::CopyAllComponents(const PhysicsManager& physicsManager)
 	_rigidbodyManager.CopyAllComponents(physicsManager._rigidbodyManager.GetAllComponents());
 	_aabbManager.CopyAllComponents(physicsManager._aabbManager.GetAllComponents());
 	_circleManager.CopyAllComponents(physicsManager._circleManager.GetAllComponents());
+	_contactCache = physicsManager._contactCache;
 }
 
 void PhysicsManager::Draw(sf::RenderTarget& renderTarget)
@@ -186,11 +247,13 @@ void PhysicsManager::Draw(sf::RenderTarget& renderTarget)
 		if (!hasRigidbody || isDestroyed || !hasCollider) continue;
 
 		const Rigidbody& rigidbody = _rigidbodyManager.GetComponent(entity);
-		const auto& position = rigidbody.Position();
+		const core::Vec2f position = rigidbody.Position();
 
 		if (hasAabbCollider)
 		{
 			const AabbCollider& aabbCollider = _aabbManager.GetComponent(entity);
+			const auto halfWidth = static_cast<float>(aabbCollider.halfWidth);
+			const auto halfHeight = static_cast<float>(aabbCollider.halfHeight);
 			sf::RectangleShape rectShape;
 			rectShape.setFillColor(core::Color::Transparent());
 			rectShape.setOutlineColor(core::Color::Green());
@@ -198,14 +261,14 @@ void PhysicsManager::Draw(sf::RenderTarget& renderTarget)
 			rectShape.setScale(rigidbody.Trans().scale);
 
 			rectShape.setOrigin({
-				aabbCollider.halfWidth * core::PIXEL_PER_METER, aabbCollider.halfHeight * core::PIXEL_PER_METER
+				halfWidth * core::PIXEL_PER_METER, halfHeight * core::PIXEL_PER_METER
 			});
 			rectShape.setPosition(
 				position.x * core::PIXEL_PER_METER + _center.x,
 				_windowSize.y - (position.y * core::PIXEL_PER_METER + _center.y));
 			rectShape.setSize({
-				aabbCollider.halfWidth * 2.0f * core::PIXEL_PER_METER,
-				aabbCollider.halfHeight * 2.0f * core::PIXEL_PER_METER
+				halfWidth * 2.0f * core::PIXEL_PER_METER,
+				halfHeight * 2.0f * core::PIXEL_PER_METER
 			});
 
 			renderTarget.draw(rectShape);
@@ -214,18 +277,19 @@ void PhysicsManager::Draw(sf::RenderTarget& renderTarget)
 		if (hasCircleCollider)
 		{
 			const CircleCollider& circleCollider = _circleManager.GetComponent(entity);
+			const auto radius = static_cast<float>(circleCollider.radius);
 			sf::CircleShape circleShape;
 			circleShape.setFillColor(core::Color::Transparent());
 			circleShape.setOutlineColor(core::Color::Green());
 			circleShape.setOutlineThickness(2.0f);
 			circleShape.setScale(rigidbody.Trans().scale);
 			circleShape.setOrigin({
-				circleCollider.radius * core::PIXEL_PER_METER, circleCollider.radius * core::PIXEL_PER_METER
+				radius * core::PIXEL_PER_METER, radius * core::PIXEL_PER_METER
 			});
 			circleShape.setPosition(
 				position.x * core::PIXEL_PER_METER + _center.x,
 				_windowSize.y - (position.y * core::PIXEL_PER_METER + _center.y));
-			circleShape.setRadius(circleCollider.radius * core::PIXEL_PER_METER);
+			circleShape.setRadius(radius * core::PIXEL_PER_METER);
 
 			renderTarget.draw(circleShape);
 		}
@@ -245,9 +309,10 @@ void PhysicsManager::ApplyGravity()
 		Rigidbody& rigidbody = GetRigidbody(entity);
 
 		if (!rigidbody.IsDynamic()) continue;
+		if (!rigidbody.IsAwake()) continue;
 		if (rigidbody.InvMass() == 0.0f) continue;
 
-		const core::Vec2f force = rigidbody.GravityAcceleration() * rigidbody.Mass();
+		const Vec2s force = rigidbody.GravityAcceleration() * rigidbody.Mass();
 		rigidbody.ApplyForce(force);
 		_rigidbodyManager.SetComponent(entity, rigidbody);
 	}
@@ -255,103 +320,420 @@ void PhysicsManager::ApplyGravity()
 
 void PhysicsManager::ResolveCollisions(const sf::Time deltaTime)
 {
+	#ifdef TRACY_ENABLE
+	ZoneScoped;
+	#endif
+
+	using Clock = std::chrono::steady_clock;
+	Clock::time_point stageStart = Clock::now();
+
+	// Ends the current stage, and returns its duration
+	const auto endStage = [&stageStart]
+	{
+		const Clock::time_point stageEnd = Clock::now();
+		const std::chrono::nanoseconds duration = stageEnd - stageStart;
+		stageStart = stageEnd;
+		return duration;
+	};
+
+	std::pmr::vector<std::pair<core::Entity, core::Entity>> collisionPairs(&_frameArena);
+	{
+		#ifdef TRACY_ENABLE
+		ZoneScopedN("Broad Phase");
+		#endif
+
+		// The broad phase already rejects the pairs whose layers do not collide
+		_broadPhase->Update();
+		collisionPairs = _broadPhase->GetCollisionPairs(&_frameArena);
+	}
+	_lastStepStats.broadPhase = endStage();
+	_lastStepStats.pairCount = collisionPairs.size();
+
 	// Vector for the collisions that have been detected
-	std::vector<Collision> collisions;
-	collisions.reserve(64);
+	std::pmr::vector<Collision> collisions(&_frameArena);
+	collisions.reserve(collisionPairs.size());
 
 	// Vector for the collisions that have been caused by trigger colliders
-	std::vector<Collision> triggers;
+	std::pmr::vector<Collision> triggers(&_frameArena);
 	triggers.reserve(64);
 
-	_grid.Update();
-	const auto collisionPairs = _grid.GetCollisionPairs();
-
-	for (auto& [firstEntity, secondEntity] : collisionPairs)
 	{
-		const bool firstHasRigidbody = _entityManager.HasComponent(firstEntity,
-		                                                           static_cast<core::EntityMask>(
-			                                                           core::ComponentType::Rigidbody));
-		const bool secondHasRigidbody = _entityManager.HasComponent(secondEntity,
-		                                                            static_cast<core::EntityMask>(
-			                                                            core::ComponentType::Rigidbody));
+		#ifdef TRACY_ENABLE
+		ZoneScopedN("Narrow Phase");
+		#endif
+
+		using NarrowPhaseFunction = void (PhysicsManager::*)(
+			std::span<const std::pair<core::Entity, core::Entity>>,
+			std::pmr::vector<Collision>&, std::pmr::vector<Collision>&);
+
+		// Indexed by (first shape - 1) * SHAPE_TYPE_COUNT + (second shape - 1)
+		static constexpr std::array<NarrowPhaseFunction, SHAPE_TYPE_COUNT * SHAPE_TYPE_COUNT> narrowPhaseTable{
+			&PhysicsManager::TestCollisions<ShapeType::Circle, ShapeType::Circle>,
+			&PhysicsManager::TestCollisions<ShapeType::Circle, ShapeType::Aabb>,
+			&PhysicsManager::TestCollisions<ShapeType::Aabb, ShapeType::Circle>,
+			&PhysicsManager::TestCollisions<ShapeType::Aabb, ShapeType::Aabb>,
+		};
+
+		// Bucket the pairs by combination of shapes so each one is processed in its own loop
+		using PairVector = std::pmr::vector<std::pair<core::Entity, core::Entity>>;
+		static_assert(narrowPhaseTable.size() == 4, "Every combination of shapes needs a bucket");
+		std::array<PairVector, narrowPhaseTable.size()> buckets{
+			PairVector(&_frameArena), PairVector(&_frameArena), PairVector(&_frameArena), PairVector(&_frameArena)
+		};
+
+		for (const auto& pair : collisionPairs)
+		{
+			const ShapeType firstShape = GetRigidbody(pair.first).GetShapeType();
+			const ShapeType secondShape = GetRigidbody(pair.second).GetShapeType();
+
+			if (firstShape == ShapeType::None || secondShape == ShapeType::None) continue;
+
+			const std::size_t bucket = (static_cast<std::size_t>(firstShape) - 1) * SHAPE_TYPE_COUNT +
+				static_cast<std::size_t>(secondShape) - 1;
+			buckets[bucket].push_back(pair);
+		}
+
+		for (std::size_t i = 0; i < narrowPhaseTable.size(); i++)
+		{
+			if (buckets[i].empty()) continue;
 
-		const Collider* firstCollider = GetCollider(firstEntity);
-		const Collider* secondCollider = GetCollider(secondEntity);
+			(this->*narrowPhaseTable[i])(buckets[i], collisions, triggers);
+		}
 
-		const bool hasColliders = firstCollider && secondCollider;
-		const bool hasRigidbodies = firstHasRigidbody && secondHasRigidbody;
+		// A sleeping body touched by an active one must be solved with the rest of the contacts
+		WakeUpIslands(collisions);
+	}
+	_lastStepStats.narrowPhase = endStage();
+	_lastStepStats.contactCount = collisions.size();
 
-		if (!hasColliders || !hasRigidbodies) continue;
+	{
+		#ifdef TRACY_ENABLE
+		ZoneScopedN("Solve");
+		#endif
 
-		Rigidbody& firstRigidbody = GetRigidbody(firstEntity);
-		Rigidbody& secondRigidbody = GetRigidbody(secondEntity);
+		SolveCollisions(collisions, deltaTime);
+	}
+	_lastStepStats.solve = endStage();
 
-		const Layer firstLayer = firstRigidbody.GetLayer();
-		const Layer secondLayer = secondRigidbody.GetLayer();
+	{
+		#ifdef TRACY_ENABLE
+		ZoneScopedN("Sleep");
+		#endif
 
-		if (!_layerCollisionMatrix.HasCollision(firstLayer, secondLayer)) continue;
+		UpdateSleep(collisions, deltaTime);
+	}
+	_lastStepStats.sleep = endStage();
 
-		const Manifold manifold = firstCollider->TestCollision(
-			&firstRigidbody.Trans(),
-			secondCollider,
-			&secondRigidbody.Trans()
-		);
+	{
+		#ifdef TRACY_ENABLE
+		ZoneScopedN("Dispatch Events");
+		#endif
 
-		if (!manifold.hasCollision) continue;
+		// Every buffer is filled before any listener is called, so they all see the world of this step
+		FillEventBuffers(triggers, _triggerEventBuffers);
+		FillEventBuffers(collisions, _collisionEventBuffers);
 
-		if (firstRigidbody.IsTrigger() || secondRigidbody.IsTrigger())
+		for (const auto& [listener, firstMask, secondMask, listenerTriggers] : _triggerEventBuffers)
 		{
-			triggers.emplace_back(firstEntity, secondEntity, manifold);
+			if (listenerTriggers.empty()) continue;
+			listener->OnTrigger(listenerTriggers);
 		}
-		else
+
+		for (const auto& [listener, firstMask, secondMask, listenerCollisions] : _collisionEventBuffers)
 		{
-			collisions.emplace_back(firstEntity, secondEntity, manifold);
+			if (listenerCollisions.empty()) continue;
+			listener->OnCollision(listenerCollisions);
 		}
-
-		SolveCollisions(collisions, deltaTime);
-
-		SendCollisionCallbacks(triggers, _onTriggerAction);
-		SendCollisionCallbacks(collisions, _onCollisionAction);
 	}
+	_lastStepStats.dispatchEvents = endStage();
 }
 
-void PhysicsManager::SolveCollisions(const std::vector<Collision>& collisions, const sf::Time deltaTime)
+void PhysicsManager::SolveCollisions(const std::span<const Collision> collisions, const sf::Time deltaTime)
 {
 	_impulseSolver.Solve(collisions, deltaTime.asSeconds());
 	_smoothPositionSolver.Solve(collisions, deltaTime.asSeconds());
 }
 
-Collider* PhysicsManager::GetCollider(const core::EntityManager& entityManager, AabbColliderManager& aabbManager,
-                                      CircleColliderManager& circleManager, const core::Entity entity)
+std::optional<ColliderBounds> PhysicsManager::GetColliderBounds(
+	const Rigidbody& body,
+	const core::Entity entity,
+	const AabbColliderManager& aabbManager,
+	const CircleColliderManager& circleManager)
 {
-	const std::optional<core::ComponentType> colliderType = HasCollider(entityManager, entity);
+	// The scale is applied as in the narrow phase, so the bounds cover the colliders it tests
+	const Transform& transform = body.Trans();
+	switch (body.GetShapeType())
+	{
+	case ShapeType::Circle:
+	{
+		const CircleCollider& circle = circleManager.GetComponent(entity);
+		return ColliderBounds{transform.position + circle.center, circle.GetBoundingBoxSize() * transform.scale.Major()};
+	}
+	case ShapeType::Aabb:
+	{
+		const AabbCollider& aabb = aabbManager.GetComponent(entity);
+		const Vec2s boundingBoxSize = aabb.GetBoundingBoxSize();
+		return ColliderBounds{
+			transform.position + aabb.center,
+			Vec2s{boundingBoxSize.x * transform.scale.x, boundingBoxSize.y * transform.scale.y}
+		};
+	}
+	case ShapeType::None:
+		break;
+	}
 
-	if (!colliderType.has_value()) return nullptr;
+	return {};
+}
+
+void PhysicsManager::UpdateShapeType(const core::Entity entity)
+{
+	const bool hasRigidbody = _entityManager.HasComponent(entity,
+	                                                      static_cast<core::EntityMask>(
+		                                                      core::ComponentType::Rigidbody));
+	if (!hasRigidbody) return;
+
+	ShapeType shapeType = ShapeType::None;
+	const std::optional<core::ComponentType> colliderType = HasCollider(_entityManager, entity);
 
-	if (*colliderType == core::ComponentType::AabbCollider)
+	if (colliderType == core::ComponentType::AabbCollider)
 	{
-		return &aabbManager.GetComponent(entity);
+		shapeType = ShapeType::Aabb;
 	}
-
-	if (*colliderType == core::ComponentType::CircleCollider)
+	else if (colliderType == core::ComponentType::CircleCollider)
 	{
-		return &circleManager.GetComponent(entity);
+		shapeType = ShapeType::Circle;
 	}
 
-	return nullptr;
+	_rigidbodyManager.GetComponent(entity).SetShapeType(shapeType);
 }
 
-Collider* PhysicsManager::GetCollider(const core::Entity entity)
+void PhysicsManager::WakeUpIslands(const std::span<const Collision> collisions)
 {
-	return GetCollider(_entityManager, _aabbManager, _circleManager, entity);
+	std::pmr::vector<core::Entity> islands(&_frameArena);
+	for (const auto& [bodyA, bodyB, _] : collisions)
+	{
+		for (const core::Entity entity : {bodyA, bodyB})
+		{
+			Rigidbody& rigidbody = GetRigidbody(entity);
+			if (rigidbody.IsAwake()) continue;
+
+			islands.push_back(rigidbody.SleepIsland());
+			rigidbody.WakeUp();
+		}
+	}
+
+	if (islands.empty()) return;
+
+	std::ranges::sort(islands);
+	const auto [first, last] = std::ranges::unique(islands);
+	islands.erase(first, last);
+
+	for (core::Entity entity = 0; entity < _entityManager.GetEntitiesSize(); entity++)
+	{
+		if (!_entityManager.HasComponent(entity, static_cast<core::EntityMask>(core::ComponentType::Rigidbody)))
+			continue;
+
+		Rigidbody& rigidbody = GetRigidbody(entity);
+		if (rigidbody.IsAwake()) continue;
+
+		if (std::ranges::binary_search(islands, rigidbody.SleepIsland()))
+		{
+			rigidbody.WakeUp();
+		}
+	}
 }
 
-void PhysicsManager::SendCollisionCallbacks(
-	const std::vector<Collision>& collisions, core::Action<core::Entity, core::Entity>& action)
+void PhysicsManager::UpdateSleep(const std::span<const Collision> collisions, const sf::Time deltaTime)
 {
+	const std::size_t entitiesSize = _entityManager.GetEntitiesSize();
+
+	// Each island is identified by its smallest entity, so the result does not depend on the order of the contacts
+	std::pmr::vector<core::Entity> parents(entitiesSize, &_frameArena);
+	for (core::Entity entity = 0; entity < entitiesSize; entity++)
+	{
+		parents[entity] = entity;
+	}
+
+	const auto findRoot = [&parents](core::Entity entity)
+	{
+		while (parents[entity] != entity)
+		{
+			parents[entity] = parents[parents[entity]];
+			entity = parents[entity];
+		}
+		return entity;
+	};
+
 	for (const auto& [bodyA, bodyB, _] : collisions)
 	{
-		action.Execute(bodyA, bodyB);
+		// Static bodies do not link islands together, otherwise the whole level would be one island
+		if (GetRigidbody(bodyA).IsStatic() || GetRigidbody(bodyB).IsStatic()) continue;
+
+		const core::Entity rootA = findRoot(bodyA);
+		const core::Entity rootB = findRoot(bodyB);
+		if (rootA == rootB) continue;
+
+		parents[std::max(rootA, rootB)] = std::min(rootA, rootB);
+	}
+
+	// Smallest sleep time of every island, stored at the index of its root
+	std::pmr::vector<Scalar> islandSleepTimes(entitiesSize, std::numeric_limits<Scalar>::max(), &_frameArena);
+
+	for (core::Entity entity = 0; entity < entitiesSize; entity++)
+	{
+		if (!_entityManager.HasComponent(entity, static_cast<core::EntityMask>(core::ComponentType::Rigidbody)))
+			continue;
+
+		Rigidbody& rigidbody = GetRigidbody(entity);
+		if (rigidbody.IsStatic() || !rigidbody.IsAwake()) continue;
+
+		const bool isSlow = rigidbody.Velocity().GetSqrMagnitude() < SLEEP_VELOCITY * SLEEP_VELOCITY;
+		if (rigidbody.IsKinematic() || !isSlow)
+		{
+			rigidbody.SetSleepTime(0.0f);
+		}
+		else
+		{
+			rigidbody.SetSleepTime(rigidbody.SleepTime() + deltaTime.asSeconds());
+		}
+
+		Scalar& islandSleepTime = islandSleepTimes[findRoot(entity)];
+		islandSleepTime = std::min(islandSleepTime, rigidbody.SleepTime());
+	}
+
+	for (core::Entity entity = 0; entity < entitiesSize; entity++)
+	{
+		if (!_entityManager.HasComponent(entity, static_cast<core::EntityMask>(core::ComponentType::Rigidbody)))
+			continue;
+
+		Rigidbody& rigidbody = GetRigidbody(entity);
+		if (rigidbody.IsStatic() || !rigidbody.IsAwake()) continue;
+
+		const core::Entity root = findRoot(entity);
+		if (islandSleepTimes[root] < TIME_TO_SLEEP) continue;
+
+		rigidbody.Sleep(root);
+	}
+}
+
+template <ShapeType Shape>
+const algo::ShapeCollider<Shape>& PhysicsManager::GetShape(const core::Entity entity) const
+{
+	if constexpr (Shape == ShapeType::Circle)
+	{
+		return _circleManager.GetComponent(entity);
+	}
+	else
+	{
+		return _aabbManager.GetComponent(entity);
+	}
+}
+
+template <ShapeType FirstShape, ShapeType SecondShape>
+void PhysicsManager::TestCollisions(const std::span<const std::pair<core::Entity, core::Entity>> pairs,
+                                    std::pmr::vector<Collision>& collisions, std::pmr::vector<Collision>& triggers)
+{
+	const auto addContact = [this, &collisions, &triggers](
+		const core::Entity firstEntity, const core::Entity secondEntity, const Manifold& manifold)
+	{
+		if (GetRigidbody(firstEntity).IsTrigger() || GetRigidbody(secondEntity).IsTrigger())
+		{
+			triggers.emplace_back(firstEntity, secondEntity, manifold);
+		}
+		else
+		{
+			collisions.emplace_back(firstEntity, secondEntity, manifold);
+		}
+	};
+
+	if constexpr (FirstShape == ShapeType::Circle && SecondShape == ShapeType::Circle)
+	{
+		// Same argument order as FindManifold, the second circle is tested against the first one
+		algo::CircleCircleBatch batch(&_frameArena);
+		batch.Reserve(pairs.size());
+		for (const auto& [firstEntity, secondEntity] : pairs)
+		{
+			batch.Add(GetShape<ShapeType::Circle>(secondEntity), GetRigidbody(secondEntity).Trans(),
+			          GetShape<ShapeType::Circle>(firstEntity), GetRigidbody(firstEntity).Trans());
+		}
+
+		std::pmr::vector<std::uint32_t> hits(&_frameArena);
+		hits.reserve(pairs.size());
+		algo::FindCircleCircleHits(batch, hits);
+
+		for (const std::uint32_t hit : hits)
+		{
+			addContact(pairs[hit].first, pairs[hit].second, algo::BuildCircleCircleManifold(batch, hit));
+		}
+	}
+	else if constexpr (FirstShape != SecondShape)
+	{
+		constexpr bool isAabbFirst = FirstShape == ShapeType::Aabb;
+
+		algo::AabbCircleBatch batch(&_frameArena);
+		batch.Reserve(pairs.size());
+		for (const auto& [firstEntity, secondEntity] : pairs)
+		{
+			const core::Entity aabbEntity = isAabbFirst ? firstEntity : secondEntity;
+			const core::Entity circleEntity = isAabbFirst ? secondEntity : firstEntity;
+			batch.Add(GetShape<ShapeType::Aabb>(aabbEntity), GetRigidbody(aabbEntity).Trans(),
+			          GetShape<ShapeType::Circle>(circleEntity), GetRigidbody(circleEntity).Trans());
+		}
+
+		std::pmr::vector<std::uint32_t> hits(&_frameArena);
+		hits.reserve(pairs.size());
+		algo::FindAabbCircleHits(batch, hits);
+
+		for (const std::uint32_t hit : hits)
+		{
+			const Manifold manifold = algo::BuildAabbCircleManifold(batch, hit);
+			if (!manifold.hasCollision) continue;
+
+			addContact(pairs[hit].first, pairs[hit].second, isAabbFirst ? manifold : manifold.Swaped());
+		}
+	}
+	else
+	{
+		for (const auto& [firstEntity, secondEntity] : pairs)
+		{
+			const Manifold manifold = algo::FindManifold<FirstShape, SecondShape>(
+				GetShape<FirstShape>(firstEntity), GetRigidbody(firstEntity).Trans(),
+				GetShape<SecondShape>(secondEntity), GetRigidbody(secondEntity).Trans()
+			);
+
+			if (!manifold.hasCollision) continue;
+
+			addContact(firstEntity, secondEntity, manifold);
+		}
+	}
+}
+
+template <typename Listener>
+void PhysicsManager::FillEventBuffers(const std::span<const Collision> collisions,
+                                      std::vector<CollisionEventBuffer<Listener>>& eventBuffers) const
+{
+	for (auto& eventBuffer : eventBuffers)
+	{
+		eventBuffer.collisions.clear();
+	}
+
+	if (eventBuffers.empty()) return;
+
+	for (const Collision& collision : collisions)
+	{
+		for (auto& [listener, firstMask, secondMask, listenerCollisions] : eventBuffers)
+		{
+			if (_entityManager.HasComponent(collision.bodyA, firstMask) &&
+				_entityManager.HasComponent(collision.bodyB, secondMask))
+			{
+				listenerCollisions.push_back(collision);
+			}
+			else if (_entityManager.HasComponent(collision.bodyB, firstMask) &&
+				_entityManager.HasComponent(collision.bodyA, secondMask))
+			{
+				listenerCollisions.emplace_back(collision.bodyB, collision.bodyA, collision.manifold.Swaped());
+			}
+		}
 	}
 }
 }
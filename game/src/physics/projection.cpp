@@ -9,10 +9,10 @@ bool Projection::Overlaps(const Projection& other) const
 	return !(min > other.max || other.min > max);
 }
 
-float Projection::GetOverlap(const Projection& other) const
+Scalar Projection::GetOverlap(const Projection& other) const
 {
 	return std::max(
-		0.0f,
+		Scalar{0},
 		std::min(max, other.max) - std::max(min, other.min)
 	);
 }
@@ -1,5 +1,7 @@
 #include "physics/rigidbody.hpp"
 
+#include <algorithm>
+
 #include "maths/basic.hpp"
 
 namespace game
@@ -37,13 +39,15 @@ void Rigidbody::SetIsTrigger(const bool isTrigger)
 	_isTrigger = isTrigger;
 }
 
-const core::Vec2f& Rigidbody::Position() const
+const Vec2s& Rigidbody::Position() const
 {
 	return _transform.position;
 }
 
-void Rigidbody::SetPosition(const core::Vec2f& position)
+void Rigidbody::SetPosition(const Vec2s& position)
 {
+	if (!_isAwake && position != _transform.position) WakeUp();
+
 	_transform.position = position;
 }
 
@@ -57,55 +61,78 @@ void Rigidbody::SetRotation(const core::Radian rotation)
 	_transform.rotation = rotation;
 }
 
-const core::Vec2f& Rigidbody::GravityAcceleration() const
+const Vec2s& Rigidbody::GravityAcceleration() const
 {
 	return _gravityAcceleration;
 }
 
-void Rigidbody::SetGravityAcceleration(const core::Vec2f& gravityAcceleration)
+void Rigidbody::SetGravityAcceleration(const Vec2s& gravityAcceleration)
 {
 	if (!TakesGravity()) return;
 
 	_gravityAcceleration = gravityAcceleration;
 }
 
-const core::Vec2f& Rigidbody::Force() const
+const Vec2s& Rigidbody::Force() const
 {
 	return _force;
 }
 
-void Rigidbody::ApplyForce(const core::Vec2f& addedForce)
+void Rigidbody::ApplyForce(const Vec2s& addedForce)
 {
+	if (!_isAwake && addedForce != Vec2s::Zero()) WakeUp();
+
 	this->_force += addedForce;
 }
 
-void Rigidbody::SetForce(const core::Vec2f& force)
+void Rigidbody::SetForce(const Vec2s& force)
 {
 	_force = force;
 }
 
-const core::Vec2f& Rigidbody::Velocity() const
+const Vec2s& Rigidbody::Velocity() const
 {
 	return _velocity;
 }
 
-void Rigidbody::SetVelocity(const core::Vec2f& velocity)
+void Rigidbody::SetVelocity(const Vec2s& velocity)
 {
+	if (!_isAwake && velocity != _velocity) WakeUp();
+
 	_velocity = velocity;
 }
 
-float Rigidbody::Mass() const
+void Rigidbody::WakeUp()
+{
+	_isAwake = true;
+	_sleepTime = 0.0f;
+	_sleepIsland = core::INVALID_ENTITY;
+}
+
+void Rigidbody::Sleep(const core::Entity island)
+{
+	_isAwake = false;
+	_sleepIsland = island;
+	_velocity = Vec2s::Zero();
+	_force = Vec2s::Zero();
+}
+
+Scalar Rigidbody::Mass() const
 {
 	return 1.0f / _invMass;
 }
 
-float Rigidbody::InvMass() const
+Scalar Rigidbody::InvMass() const
 {
 	return _invMass;
 }
 
-void Rigidbody::SetMass(const float mass)
+void Rigidbody::SetMass(const Scalar mass)
 {
+#if GPR_PHYSICS_FIXED_POINT
+	// A fixed point division by zero saturates, and the inverse of a huge mass is at least one epsilon
+	_invMass = std::max(Scalar{1} / mass, std::numeric_limits<Scalar>::min());
+#else
 	if (core::Equal(mass, 0))
 	{
 		_invMass = 0;
@@ -114,8 +141,9 @@ void Rigidbody::SetMass(const float mass)
 
 	if (std::fpclassify(_invMass) == FP_SUBNORMAL)
 	{
-		_invMass = std::numeric_limits<float>::min();
+		_invMass = std::numeric_limits<Scalar>::min();
 	}
+#endif
 }
 
 bool Rigidbody::TakesGravity() const
@@ -128,36 +156,36 @@ void Rigidbody::SetTakesGravity(const bool takesGravity)
 	_takesGravity = takesGravity;
 	if (!_takesGravity)
 	{
-		SetGravityAcceleration(core::Vec2f(0, 0));
+		SetGravityAcceleration(Vec2s(0, 0));
 	}
 }
 
-float Rigidbody::StaticFriction() const
+Scalar Rigidbody::StaticFriction() const
 {
 	return _staticFriction;
 }
 
-void Rigidbody::SetStaticFriction(const float staticFriction)
+void Rigidbody::SetStaticFriction(const Scalar staticFriction)
 {
 	_staticFriction = staticFriction;
 }
 
-float Rigidbody::DynamicFriction() const
+Scalar Rigidbody::DynamicFriction() const
 {
 	return _dynamicFriction;
 }
 
-void Rigidbody::SetDynamicFriction(const float dynamicFriction)
+void Rigidbody::SetDynamicFriction(const Scalar dynamicFriction)
 {
 	_dynamicFriction = dynamicFriction;
 }
 
-float Rigidbody::Restitution() const
+Scalar Rigidbody::Restitution() const
 {
 	return _restitution;
 }
 
-void Rigidbody::SetRestitution(const float restitution)
+void Rigidbody::SetRestitution(const Scalar restitution)
 {
 	_restitution = restitution;
 }
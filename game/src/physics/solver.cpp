@@ -1,19 +1,53 @@
 #include "physics/solver.hpp"
 
+#include <algorithm>
+#include <array>
+#include <bit>
+
 #include "engine/component.hpp"
 
 #include "physics/collision.hpp"
 #include "physics/rigidbody.hpp"
 
+#include "utils/thread_pool.hpp"
+#include "utils/vector_utility.hpp"
+
 namespace game
 {
-Solver::Solver(core::EntityManager& entityManager, RigidbodyManager& rigidbodyManager)
-	: _entityManager(entityManager), _rigidbodyManager(rigidbodyManager)
+Solver::Solver(core::EntityManager& entityManager, RigidbodyManager& rigidbodyManager, const std::uint32_t iterations)
+	: _entityManager(entityManager), _rigidbodyManager(rigidbodyManager), _iterations(std::max(iterations, 1u))
+{
+}
+
+void Solver::SetIterations(const std::uint32_t iterations)
 {
+	_iterations = std::max(iterations, 1u);
 }
 
-void ImpulseSolver::Solve(const std::vector<Collision>& collisions, float)
+void ImpulseSolver::Solve(const std::span<const Collision> collisions, Scalar)
 {
+	PrepareConstraints(collisions);
+	ColorConstraints();
+
+	// Warm start with the impulses of the last step
+	ForEachConstraint([](const ContactConstraint& constraint)
+	{
+		ApplyImpulse(constraint, constraint.normalImpulse * constraint.normal +
+		             constraint.tangentImpulse * constraint.tangent);
+	});
+
+	for (std::uint32_t i = 0; i < _iterations; i++)
+	{
+		ForEachConstraint(SolveConstraint);
+	}
+
+	StoreImpulses();
+}
+
+void ImpulseSolver::PrepareConstraints(const std::span<const Collision> collisions)
+{
+	_constraints.clear();
+
 	for (const auto& [entityA, entityB, manifold] : collisions)
 	{
 		const bool isRigidbodyA = _entityManager.HasComponent(entityA,
@@ -28,95 +62,196 @@ void ImpulseSolver::Solve(const std::vector<Collision>& collisions, float)
 		Rigidbody& bodyA = _rigidbodyManager.GetComponent(entityA);
 		Rigidbody& bodyB = _rigidbodyManager.GetComponent(entityB);
 
-		// ReSharper disable CppCStyleCast
-		Rigidbody* aBody = bodyA.HasCollisions() ? &bodyA : nullptr;
-		Rigidbody* bBody = bodyB.HasCollisions() ? &bodyB : nullptr;
-		// ReSharper restore CppCStyleCast
-
-		core::Vec2f aVel = aBody ? aBody->Velocity() : core::Vec2f::Zero();
-		core::Vec2f bVel = bBody ? bBody->Velocity() : core::Vec2f::Zero();
-		core::Vec2f relativeVelocity = bVel - aVel;
+		ContactConstraint& constraint = _constraints.emplace_back();
+		constraint.entityA = entityA;
+		constraint.entityB = entityB;
+		constraint.bodyA = bodyA.HasCollisions() ? &bodyA : nullptr;
+		constraint.bodyB = bodyB.HasCollisions() ? &bodyB : nullptr;
 
-		// Calculate relative velocity in terms of the normal direction
-		float velocityAlongNormal = relativeVelocity.Dot(manifold.normal);
+		const Rigidbody* aBody = constraint.bodyA;
+		const Rigidbody* bBody = constraint.bodyB;
 
-		// Do not resolve if velocities are separating
-		if (velocityAlongNormal >= 0) continue;
+		constraint.invMassA = aBody ? aBody->InvMass() : 1.0f;
+		constraint.invMassB = bBody ? bBody->InvMass() : 1.0f;
+		constraint.effectiveMass = 1.0f / (constraint.invMassA + constraint.invMassB);
 
-		const float aInvMass = aBody ? aBody->InvMass() : 1.0f;
-		const float bInvMass = bBody ? bBody->InvMass() : 1.0f;
+		constraint.normal = manifold.normal;
+		constraint.tangent = manifold.normal.PositivePerpendicular();
 
-		// Impulse
+		const Vec2s aVel = aBody ? aBody->Velocity() : Vec2s::Zero();
+		const Vec2s bVel = bBody ? bBody->Velocity() : Vec2s::Zero();
+		const Scalar velocityAlongNormal = (bVel - aVel).Dot(constraint.normal);
 
-		const float e = std::min(aBody ? aBody->Restitution() : 1.0f, bBody ? bBody->Restitution() : 1.0f);
-		const float j = -(1.0f + e) * velocityAlongNormal / (aInvMass + bInvMass);
+		// Only approaching bodies bounce, separating ones are just kept from getting closer
+		const Scalar e = std::min(aBody ? aBody->Restitution() : 1.0f, bBody ? bBody->Restitution() : 1.0f);
+		constraint.velocityBias = velocityAlongNormal < 0.0f ? -e * velocityAlongNormal : 0.0f;
 
-		const core::Vec2f impulse = j * manifold.normal;
+		const Scalar aSf = aBody ? aBody->StaticFriction() : 0.0f;
+		const Scalar bSf = bBody ? bBody->StaticFriction() : 0.0f;
+		const Scalar aDf = aBody ? aBody->DynamicFriction() : 0.0f;
+		const Scalar bDf = bBody ? bBody->DynamicFriction() : 0.0f;
+		constraint.staticFriction = Vec2s(aSf, bSf).GetMagnitude();
+		constraint.dynamicFriction = Vec2s(aDf, bDf).GetMagnitude();
 
-		if (aBody ? !aBody->IsKinematic() : false)
+		if (const CachedContact* cachedContact = _contactCache.Find(entityA, entityB))
 		{
-			aVel -= impulse * aInvMass;
+			constraint.normalImpulse = cachedContact->normalImpulse;
+			constraint.tangentImpulse = cachedContact->tangentImpulse;
 		}
+	}
+	core::KeepCapacityMargin(_constraints);
+}
 
-		if (bBody ? !bBody->IsKinematic() : false)
-		{
-			bVel += impulse * bInvMass;
-		}
+void ImpulseSolver::ColorConstraints()
+{
+	// Bit i is set if the body is moved by a constraint of color i
+	_bodyColors.assign(_entityManager.GetEntitiesSize(), 0);
+	static_assert(MAX_COLOR_NMB <= 64, "The colors of a body must fit in its mask");
 
-		// Friction
-		relativeVelocity = bVel - aVel;
-		velocityAlongNormal = relativeVelocity.Dot(manifold.normal);
+	// Bodies that are not moved by the solver can be shared by any number of constraints of a color
+	const auto isMoved = [](const Rigidbody* body) { return body && !body->IsKinematic(); };
 
-		const core::Vec2f tangent = core::Vec2f::Normalize(relativeVelocity - velocityAlongNormal * manifold.normal);
+	// The vectors of the constraints all have their capacity, so only a new margin of the constraints allocates
+	_constraintColors.reserve(_constraints.capacity());
+	_constraintColors.resize(_constraints.size());
+	std::array<std::size_t, MAX_COLOR_NMB + 1> colorSizes{};
 
-		const float fVel = relativeVelocity.Dot(tangent);
+	for (std::size_t i = 0; i < _constraints.size(); i++)
+	{
+		const ContactConstraint& constraint = _constraints[i];
+		const bool isMovedA = isMoved(constraint.bodyA);
+		const bool isMovedB = isMoved(constraint.bodyB);
 
-		const float aSf = aBody ? aBody->StaticFriction() : 0.0f;
-		const float bSf = bBody ? bBody->StaticFriction() : 0.0f;
-		const float aDf = aBody ? aBody->DynamicFriction() : 0.0f;
-		const float bDf = bBody ? bBody->DynamicFriction() : 0.0f;
-		float mu = core::Vec2f(aSf, bSf).GetMagnitude();
-		const float f = -fVel / (aInvMass + bInvMass);
+		std::uint64_t usedColors = 0;
+		if (isMovedA) usedColors |= _bodyColors[constraint.entityA];
+		if (isMovedB) usedColors |= _bodyColors[constraint.entityB];
 
-		core::Vec2f friction;
-		if (std::abs(f) < j * mu)
-		{
-			friction = f * tangent;
-		}
-		else
-		{
-			mu = core::Vec2f(aDf, bDf).GetMagnitude();
-			friction = -j * tangent * mu;
-		}
+		// First free color, or the overflow color if they are all taken
+		const std::size_t color = std::min<std::size_t>(std::countr_one(usedColors), MAX_COLOR_NMB);
+		_constraintColors[i] = color;
+		colorSizes[color]++;
 
-		if (aBody ? !aBody->IsKinematic() : false)
-		{
-			if (friction.IsNaN())
-			{
-				aBody->SetVelocity(aVel);
-			}
-			else
-			{
-				aBody->SetVelocity(aVel - friction * aInvMass);
-			}
-		}
+		if (color == MAX_COLOR_NMB) continue;
 
-		if (bBody ? !bBody->IsKinematic() : false)
+		if (isMovedA) _bodyColors[constraint.entityA] |= std::uint64_t{1} << color;
+		if (isMovedB) _bodyColors[constraint.entityB] |= std::uint64_t{1} << color;
+	}
+
+	_colorOffsets.assign(colorSizes.size() + 1, 0);
+	for (std::size_t color = 0; color < colorSizes.size(); color++)
+	{
+		_colorOffsets[color + 1] = _colorOffsets[color] + colorSizes[color];
+	}
+
+	// Counting sort, stable so a color keeps the order of the collisions
+	_sortedConstraints.reserve(_constraints.capacity());
+	_sortedConstraints.resize(_constraints.size());
+	std::array<std::size_t, MAX_COLOR_NMB + 1> insertIndices{};
+	std::copy(_colorOffsets.begin(), _colorOffsets.end() - 1, insertIndices.begin());
+	for (std::size_t i = 0; i < _constraints.size(); i++)
+	{
+		_sortedConstraints[insertIndices[_constraintColors[i]]++] = _constraints[i];
+	}
+	_constraints.swap(_sortedConstraints);
+}
+
+template <typename Function>
+void ImpulseSolver::ForEachConstraint(Function function)
+{
+	const std::size_t colorCount = _colorOffsets.size() - 1;
+
+	for (std::size_t color = 0; color < colorCount; color++)
+	{
+		const std::size_t colorBegin = _colorOffsets[color];
+		const std::size_t colorSize = _colorOffsets[color + 1] - colorBegin;
+
+		// The overflow color can share bodies between its constraints, it must stay on one thread
+		const bool isOverflow = color == colorCount - 1;
+
+		if (_threadPool == nullptr || isOverflow || colorSize <= CONTACTS_PER_CHUNK)
 		{
-			if (friction.IsNaN())
-			{
-				bBody->SetVelocity(bVel);
-			}
-			else
+			for (std::size_t i = colorBegin; i < colorBegin + colorSize; i++)
 			{
-				bBody->SetVelocity(bVel + friction * bInvMass);
+				function(_constraints[i]);
 			}
+			continue;
 		}
+
+		_threadPool->ParallelFor(colorSize, CONTACTS_PER_CHUNK,
+		                         [this, colorBegin, &function](const std::size_t begin, const std::size_t end)
+		                         {
+			                         for (std::size_t i = colorBegin + begin; i < colorBegin + end; i++)
+			                         {
+				                         function(_constraints[i]);
+			                         }
+		                         });
 	}
 }
 
-void SmoothPositionSolver::Solve(const std::vector<Collision>& collisions, float)
+void ImpulseSolver::ApplyImpulse(const ContactConstraint& constraint, const Vec2s impulse)
 {
+	if (constraint.bodyA ? !constraint.bodyA->IsKinematic() : false)
+	{
+		constraint.bodyA->SetVelocity(constraint.bodyA->Velocity() - impulse * constraint.invMassA);
+	}
+
+	if (constraint.bodyB ? !constraint.bodyB->IsKinematic() : false)
+	{
+		constraint.bodyB->SetVelocity(constraint.bodyB->Velocity() + impulse * constraint.invMassB);
+	}
+}
+
+void ImpulseSolver::SolveConstraint(ContactConstraint& constraint)
+{
+	const auto relativeVelocity = [&constraint]
+	{
+		const Vec2s aVel = constraint.bodyA ? constraint.bodyA->Velocity() : Vec2s::Zero();
+		const Vec2s bVel = constraint.bodyB ? constraint.bodyB->Velocity() : Vec2s::Zero();
+		return bVel - aVel;
+	};
+
+	// Impulse, the accumulated impulse can only push the bodies apart
+	const Scalar velocityAlongNormal = relativeVelocity().Dot(constraint.normal);
+	const Scalar normalLambda = -(velocityAlongNormal - constraint.velocityBias) * constraint.effectiveMass;
+	const Scalar normalImpulse = std::max(constraint.normalImpulse + normalLambda, Scalar{0});
+	ApplyImpulse(constraint, (normalImpulse - constraint.normalImpulse) * constraint.normal);
+	constraint.normalImpulse = normalImpulse;
+
+	// Friction, static friction holds until it is exceeded, then dynamic friction is used
+	const Scalar velocityAlongTangent = relativeVelocity().Dot(constraint.tangent);
+	Scalar tangentImpulse = constraint.tangentImpulse - velocityAlongTangent * constraint.effectiveMass;
+
+	if (Abs(tangentImpulse) >= constraint.staticFriction * normalImpulse)
+	{
+		const Scalar maxFriction = constraint.dynamicFriction * normalImpulse;
+		tangentImpulse = std::clamp(tangentImpulse, -maxFriction, maxFriction);
+	}
+
+	ApplyImpulse(constraint, (tangentImpulse - constraint.tangentImpulse) * constraint.tangent);
+	constraint.tangentImpulse = tangentImpulse;
+}
+
+void ImpulseSolver::StoreImpulses()
+{
+	_cachedContacts.clear();
+	_cachedContacts.reserve(_constraints.capacity());
+
+	for (const ContactConstraint& constraint : _constraints)
+	{
+		CachedContact& contact = _cachedContacts.emplace_back();
+		contact.firstEntity = constraint.entityA;
+		contact.secondEntity = constraint.entityB;
+		contact.normalImpulse = constraint.normalImpulse;
+		contact.tangentImpulse = constraint.tangentImpulse;
+	}
+
+	_contactCache.Store(_cachedContacts);
+}
+
+void SmoothPositionSolver::Solve(const std::span<const Collision> collisions, Scalar)
+{
+	_constraints.clear();
+
 	for (const auto& [entityA, entityB, points] : collisions)
 	{
 		const bool isRigidbodyA = _entityManager.HasComponent(entityA,
@@ -131,33 +266,52 @@ void SmoothPositionSolver::Solve(const std::vector<Collision>& collisions, float
 		Rigidbody& bodyA = _rigidbodyManager.GetComponent(entityA);
 		Rigidbody& bodyB = _rigidbodyManager.GetComponent(entityB);
 
-		// ReSharper disable CppCStyleCast
-		Rigidbody* aBody = bodyA.HasCollisions() ? &bodyA : nullptr;
-		Rigidbody* bBody = bodyB.HasCollisions() ? &bodyB : nullptr;
-		// ReSharper restore CppCStyleCast
-
-		const float aInvMass = aBody ? aBody->InvMass() : 0.0f;
-		const float bInvMass = bBody ? bBody->InvMass() : 0.0f;
-
-		core::Vec2f resolution = points.b - points.a;
-
-		constexpr float slop = 0.05f;
-		constexpr float percent = 0.8f;
+		PositionConstraint& constraint = _constraints.emplace_back();
+		constraint.bodyA = bodyA.HasCollisions() ? &bodyA : nullptr;
+		constraint.bodyB = bodyB.HasCollisions() ? &bodyB : nullptr;
+		constraint.invMassA = constraint.bodyA ? constraint.bodyA->InvMass() : 0.0f;
+		constraint.invMassB = constraint.bodyB ? constraint.bodyB->InvMass() : 0.0f;
+		constraint.normal = points.normal;
+		constraint.depth = (points.b - points.a).GetMagnitude();
+		constraint.startPositionA = bodyA.Trans().position;
+		constraint.startPositionB = bodyB.Trans().position;
+	}
+	core::KeepCapacityMargin(_constraints);
 
-		const core::Vec2f correction = points.normal * percent
-			* std::max(resolution.GetMagnitude() - slop, 0.0f)
-			/ (aInvMass + bInvMass);
+	constexpr Scalar slop = 0.05f;
+	constexpr Scalar percent = 0.8f;
 
-		if (aBody ? !aBody->IsKinematic() : false)
+	for (std::uint32_t i = 0; i < _iterations; i++)
+	{
+		for (const PositionConstraint& constraint : _constraints)
 		{
-			const core::Vec2f deltaA = aInvMass * correction;
-			aBody->Trans().position -= deltaA;
-		}
+			Rigidbody* aBody = constraint.bodyA;
+			Rigidbody* bBody = constraint.bodyB;
+
+			// The depth of the manifold minus what the bodies already moved apart along the normal
+			const Vec2s displacementA = aBody
+				                            ? aBody->Trans().position - constraint.startPositionA
+				                            : Vec2s::Zero();
+			const Vec2s displacementB = bBody
+				                            ? bBody->Trans().position - constraint.startPositionB
+				                            : Vec2s::Zero();
+			const Scalar depth = constraint.depth - (displacementB - displacementA).Dot(constraint.normal);
+
+			const Vec2s correction = constraint.normal * percent
+				* std::max(depth - slop, Scalar{0})
+				/ (constraint.invMassA + constraint.invMassB);
+
+			if (aBody ? !aBody->IsKinematic() : false)
+			{
+				const Vec2s deltaA = constraint.invMassA * correction;
+				aBody->Trans().position -= deltaA;
+			}
 
-		if (bBody ? !bBody->IsKinematic() : false)
-		{
-			const core::Vec2f deltaB = bInvMass * correction;
-			bBody->Trans().position += deltaB;
+			if (bBody ? !bBody->IsKinematic() : false)
+			{
+				const Vec2s deltaB = constraint.invMassB * correction;
+				bBody->Trans().position += deltaB;
+			}
 		}
 	}
 }
@@ -0,0 +1,93 @@
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "physics/contact_kernels.hpp"
+
+namespace
+{
+// The values are multiples of a quarter, so that some pairs touch exactly or have their center on a side of the aabb
+game::Scalar RandomValue(std::mt19937& generator, const int min, const int max)
+{
+	std::uniform_int_distribution distribution(min * 4, max * 4);
+	return static_cast<game::Scalar>(distribution(generator)) / 4;
+}
+
+game::algo::CircleCircleBatch MakeCircleCircleBatch(std::mt19937& generator, const std::size_t size)
+{
+	game::algo::CircleCircleBatch batch;
+	for (std::size_t i = 0; i < size; i++)
+	{
+		batch.aX.push_back(RandomValue(generator, -4, 4));
+		batch.aY.push_back(RandomValue(generator, -4, 4));
+		batch.aRadius.push_back(RandomValue(generator, 0, 2));
+		batch.bX.push_back(RandomValue(generator, -4, 4));
+		batch.bY.push_back(RandomValue(generator, -4, 4));
+		batch.bRadius.push_back(RandomValue(generator, 0, 2));
+	}
+	return batch;
+}
+
+game::algo::AabbCircleBatch MakeAabbCircleBatch(std::mt19937& generator, const std::size_t size)
+{
+	game::algo::AabbCircleBatch batch;
+	for (std::size_t i = 0; i < size; i++)
+	{
+		batch.aX.push_back(RandomValue(generator, -4, 4));
+		batch.aY.push_back(RandomValue(generator, -4, 4));
+		batch.aHalfWidth.push_back(RandomValue(generator, 0, 2));
+		batch.aHalfHeight.push_back(RandomValue(generator, 0, 2));
+		batch.bX.push_back(RandomValue(generator, -4, 4));
+		batch.bY.push_back(RandomValue(generator, -4, 4));
+		batch.bRadius.push_back(RandomValue(generator, 0, 2));
+	}
+	return batch;
+}
+}
+
+// The sizes that are not a multiple of the SIMD width leave a tail to the scalar loop
+TEST(ContactKernels, CircleCircleHitsAreTheSameAsScalar)
+{
+	std::mt19937 generator(31);
+	for (const std::size_t size : {0u, 1u, 3u, 4u, 7u, 8u, 9u, 17u, 1003u})
+	{
+		const auto batch = MakeCircleCircleBatch(generator, size);
+
+		std::pmr::vector<std::uint32_t> hits;
+		std::pmr::vector<std::uint32_t> scalarHits;
+		game::algo::FindCircleCircleHits(batch, hits);
+		game::algo::FindCircleCircleHitsScalar(batch, scalarHits);
+
+		EXPECT_EQ(hits, scalarHits) << "size " << size;
+	}
+}
+
+TEST(ContactKernels, AabbCircleHitsAreTheSameAsScalar)
+{
+	std::mt19937 generator(31);
+	for (const std::size_t size : {0u, 1u, 3u, 4u, 7u, 8u, 9u, 17u, 1003u})
+	{
+		const auto batch = MakeAabbCircleBatch(generator, size);
+
+		std::pmr::vector<std::uint32_t> hits;
+		std::pmr::vector<std::uint32_t> scalarHits;
+		game::algo::FindAabbCircleHits(batch, hits);
+		game::algo::FindAabbCircleHitsScalar(batch, scalarHits);
+
+		EXPECT_EQ(hits, scalarHits) << "size " << size;
+	}
+}
+
+TEST(ContactKernels, BatchHasHitsAndMisses)
+{
+	std::mt19937 generator(31);
+	const auto batch = MakeCircleCircleBatch(generator, 1003);
+
+	std::pmr::vector<std::uint32_t> hits;
+	game::algo::FindCircleCircleHits(batch, hits);
+
+	EXPECT_GT(hits.size(), 0u);
+	EXPECT_LT(hits.size(), batch.Size());
+}
@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+
+#include "network/reliable_channel.hpp"
+
+namespace
+{
+constexpr float RETRANSMISSION_TIMEOUT = 100.0f;
+}
+
+TEST(ReliableChannel, UnacknowledgedMessageIsSentAgain)
+{
+	game::ReliableChannel channel;
+	ASSERT_TRUE(channel.Send(game::LoseGamePacket{}));
+
+	const auto firstPackets = channel.GetPacketsToSend(0, RETRANSMISSION_TIMEOUT);
+	ASSERT_EQ(firstPackets.size(), 1u);
+	const std::uint16_t sequence = firstPackets[0].sequence;
+
+	// Nothing is sent again before the timeout
+	EXPECT_TRUE(channel.GetPacketsToSend(50, RETRANSMISSION_TIMEOUT).empty());
+
+	const auto packets = channel.GetPacketsToSend(100, RETRANSMISSION_TIMEOUT);
+	ASSERT_EQ(packets.size(), 1u);
+	EXPECT_EQ(packets[0].sequence, sequence);
+	EXPECT_EQ(channel.GetRetransmissionCount(), 1u);
+	EXPECT_EQ(channel.GetWaitingMessageCount(), 1u);
+}
+
+TEST(ReliableChannel, AcknowledgedMessageIsDropped)
+{
+	game::ReliableChannel sender;
+	game::ReliableChannel receiver;
+	game::RttEstimator senderRtt;
+	game::RttEstimator receiverRtt;
+	ASSERT_TRUE(sender.Send(game::LoseGamePacket{}));
+
+	// The first send is lost, the receiver only gets the retransmission
+	ASSERT_EQ(sender.GetPacketsToSend(0, RETRANSMISSION_TIMEOUT).size(), 1u);
+	const auto packets = sender.GetPacketsToSend(100, RETRANSMISSION_TIMEOUT);
+	ASSERT_EQ(packets.size(), 1u);
+	receiver.Receive(packets[0], 120, receiverRtt);
+
+	const auto message = receiver.PopMessage();
+	ASSERT_TRUE(message.has_value());
+	EXPECT_EQ(game::GetPacketType(*message), game::PacketType::LoseGame);
+
+	const auto ack = receiver.TakeAck();
+	ASSERT_TRUE(ack.has_value());
+	sender.ReceiveAck(*ack, 140, senderRtt);
+
+	EXPECT_EQ(sender.GetWaitingMessageCount(), 0u);
+	EXPECT_TRUE(sender.GetPacketsToSend(1000, RETRANSMISSION_TIMEOUT).empty());
+}